@@ -0,0 +1,137 @@
+/* ========================================================================== */
+/* File: AMLogText.c
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Andrw Yang, Maria Roodnitsky, Siddharth Agrawal, Alexander Hirsch
+ * Component name:  AMLogText
+ *
+ *
+ * Date Created:    March 14, 2020
+ *
+ * Description:     AMLogText turns the binary log of a game, written by AMStartup with
+ *                  the option -l binary, into the text log AMStartup would have written
+ *                  without it, byte for byte (see turnlog.h). The time in the header is
+ *                  printed in the local time zone, like AMStartup does, so the text log
+ *                  matches when both run in the same time zone.
+ *
+ * Usage:           ./AMLogText [binary log] [text log]
+ *                  [binary log] is an Amazing_[USER]_[NUMBER OF AVATARS]_[DIFFICULTY].bin
+ *                  [text log] is the file to write, by default the binary log's name
+ *                  ending in .log instead of .bin; "-" writes to stdout
+ */
+/* ========================================================================== */
+
+// Import C Standard libraries
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+// Import project specific libraries
+#include "libs/amazing.h"
+#include "libs/turnlog.h"
+
+/**************** local functions ****************/
+char *AMLogText_Text_Name(const char *binary_name);
+
+/**************** main ****************/
+int main(const int argc, const char *argv[])
+{
+    // Validate the arguments
+    if (argc != 2 && argc != 3)
+    {
+        fprintf(stderr, "ERROR: 1: Usage: %s [binary log] [text log]. Exiting. \n", argv[0]);
+        exit(1);
+    }
+
+    // Open the binary log, and read its header
+    FILE *in = fopen(argv[1], "rb");
+    if (in == NULL)
+    {
+        fprintf(stderr, "ERROR: 2: Could not open the binary log '%s'. Exiting. \n", argv[1]);
+        exit(2);
+    }
+    turnlog_header_t header;
+    char username[UINT16_MAX + 1];
+    if (!turnlog_read_header(in, &header, username, sizeof(username)))
+    {
+        fprintf(stderr, "ERROR: 3: '%s' is not a binary log. Exiting. \n", argv[1]);
+        fclose(in);
+        exit(3);
+    }
+
+    // Open the text log: the one named, stdout, or the binary log's name ending in .log
+    char *text_name = (argc == 3) ? NULL : AMLogText_Text_Name(argv[1]);
+    FILE *out;
+    if (argc == 3 && strcmp(argv[2], "-") == 0)
+    {
+        out = stdout;
+    }
+    else
+    {
+        out = fopen((argc == 3) ? argv[2] : text_name, "w");
+    }
+    if (out == NULL)
+    {
+        fprintf(stderr, "ERROR: 4: Could not open the text log to write. Exiting. \n");
+        free(text_name);
+        fclose(in);
+        exit(4);
+    }
+
+    // Write the header, and then every record, as text
+    bool written = turnlog_write_header(out, LOG_FORMAT_TEXT, &header);
+    turn_record_t record;
+    bool truncated = false;
+    int records = 0;
+    while (written && turnlog_read_record(in, LOG_FORMAT_BINARY, header.num_avatars, &record, &truncated))
+    {
+        written = turnlog_write_record(out, LOG_FORMAT_TEXT, header.num_avatars, &record) >= 0;
+        records++;
+    }
+
+    // Clean up, and report what went wrong, if anything
+    fclose(in);
+    if (out != stdout && fclose(out) != 0)
+    {
+        written = false;
+    }
+    free(text_name);
+    if (!written)
+    {
+        fprintf(stderr, "ERROR: 5: Writing the text log failed. Exiting. \n");
+        exit(5);
+    }
+    if (truncated)
+    {
+        fprintf(stderr, "ERROR: 6: The binary log ends partway through a record, after %d records. The text log holds those records. \n", records);
+        exit(6);
+    }
+
+    // Program complete. Exit 0 on success.
+    exit(0);
+}
+
+/******** AMLogText_Text_Name ********/
+/* AMLogText_Text_Name composes the name of the text log for a binary log: the same name, ending in
+ * .log instead of .bin (or with .log added, if it does not end in .bin).
+ * Memory: caller is responsible for freeing the name returned
+ */
+char *AMLogText_Text_Name(const char *binary_name)
+{
+    size_t length = strlen(binary_name);
+    if (length >= strlen(".bin") && strcmp(binary_name + length - strlen(".bin"), ".bin") == 0)
+    {
+        length -= strlen(".bin");
+    }
+    char *text_name = malloc(length + strlen(".log") + 1);
+    if (text_name == NULL)
+    {
+        fprintf(stderr, "ERROR: 7: Error allocating memory for the text log's name. Exiting. \n");
+        exit(7);
+    }
+    memcpy(text_name, binary_name, length);
+    strcpy(text_name + length, ".log");
+    return text_name;
+}
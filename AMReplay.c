@@ -0,0 +1,433 @@
+/* ========================================================================== */
+/* File: AMReplay.c
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Andrw Yang, Maria Roodnitsky, Siddharth Agrawal, Alexander Hirsch
+ * Component name:  AMReplay
+ *
+ *
+ * Date Created:    March 15, 2020
+ *
+ * Description:     AMReplay goes to a turn of a game's log, and prints the turn and the
+ *                  map as the avatars knew it once the turn was played. It finds the turn
+ *                  in the log's index, by binary search, and rebuilds the map from the
+ *                  latest checkpoint before it, replaying at most the records between
+ *                  (see logindex.h), with the same function the avatars update the map
+ *                  with. So going to any turn takes about as long as going to any other.
+ *
+ *                  A map too large for the terminal can be printed in part, as a window of
+ *                  its cells, or as an overview in which each character stands for a
+ *                  block of cells (see render.h).
+ *
+ *                  With -v it instead checks every checkpoint of the log against the one
+ *                  before it: the map replayed from the one before must match it exactly.
+ *
+ * Usage:           ./AMReplay [-V x,y,width,height] [-O block] [log] [iteration]
+ *                  ./AMReplay -v [log]
+ *                  -V prints only the width x height cells from cell (x, y), or the
+ *                  blocks from block (x, y) with -O
+ *                  -O prints an overview, each character for a block x block block of
+ *                  cells, from 2 to 100
+ *                  [log] is an Amazing_[USER]_[NUMBER OF AVATARS]_[DIFFICULTY].log or .bin,
+ *                  with the index and checkpoints AMStartup wrote beside it
+ *                  [iteration] is the iteration of the turn to go to, as logged
+ */
+/* ========================================================================== */
+
+// Import C Standard libraries
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+// Import project specific libraries
+#include "libs/amazing.h"
+#include "libs/AMlib.h"
+#include "libs/AMlib_avatar.h"
+#include "libs/AMClient.h"
+#include "libs/map.h"
+#include "libs/simpleprint.h"
+#include "libs/turnlog.h"
+#include "libs/logindex.h"
+#include "libs/render.h"
+
+/**************** local functions ****************/
+map_t *AMReplay_Map_At(logindex_t *ix, long checkpoint, long record_number);
+bool AMReplay_Same_Map(map_t *a, map_t *b);
+int AMReplay_Verify(logindex_t *ix);
+int AMReplay_Parse_Options(const int argc, const char *argv[], int *num_options, int window[4], int *block);
+
+/**************** main ****************/
+int main(const int argc, const char *argv[])
+{
+    // Read the window and overview options, then validate the remaining arguments as if they were not there
+    int num_options = 0;
+    int window[4] = {0, 0, 0, 0};
+    int block = 1;
+    int return_value;
+    if ((return_value = AMReplay_Parse_Options(argc, argv, &num_options, window, &block)) != 0)
+    {
+        exit(return_value);
+    }
+    const int num_args = argc - num_options;
+    const char **args = argv + num_options;
+    bool verify = (num_args == 3 && num_options == 0 && strcmp(args[1], "-v") == 0);
+    char *end = NULL;
+    long iteration = (num_args == 3 && !verify) ? strtol(args[2], &end, 10) : 0;
+    if (num_args != 3 || (!verify && (*end != '\0' || iteration < 0)))
+    {
+        fprintf(stderr, "ERROR: 1: Usage: %s [-V x,y,width,height] [-O block] [log] [iteration], or %s -v [log]. Exiting. \n",
+            argv[0], argv[0]);
+        exit(1);
+    }
+
+    // Open the log, with its index and checkpoints
+    const char *log_file_name = verify ? args[2] : args[1];
+    logindex_t *ix = logindex_open(log_file_name);
+    if (ix == NULL)
+    {
+        fprintf(stderr, "ERROR: 2: Could not open the log '%s' with its index '%s.idx' and checkpoints '%s.ckp'. Exiting. \n",
+            log_file_name, log_file_name, log_file_name);
+        exit(2);
+    }
+    if (verify)
+    {
+        int status = AMReplay_Verify(ix);
+        logindex_delete(ix);
+        exit(status);
+    }
+
+    // Find the turn, and read it
+    long record_number = logindex_find(ix, (int)iteration);
+    if (record_number < 0)
+    {
+        fprintf(stderr, "ERROR: 3: The log has no turn of iteration %ld. Exiting. \n", iteration);
+        logindex_delete(ix);
+        exit(3);
+    }
+    logindex_entry_t entry;
+    turn_record_t record;
+    if (!logindex_entry(ix, record_number, &entry) || !logindex_read(ix, record_number, &record))
+    {
+        fprintf(stderr, "ERROR: 4: Could not read record %ld of the log. Exiting. \n", record_number);
+        logindex_delete(ix);
+        exit(4);
+    }
+
+    // Rebuild the map as of the turn, from the latest checkpoint before it
+    map_t *map = AMReplay_Map_At(ix, entry.checkpoint, record_number);
+    if (map == NULL)
+    {
+        fprintf(stderr, "ERROR: 4: Could not replay the log up to record %ld. Exiting. \n", record_number);
+        logindex_delete(ix);
+        exit(4);
+    }
+
+    // Print the turn as logged, and the map with the avatars where the turn has them
+    int num_avatars = logindex_get_num_avatars(ix);
+    avatar_t **avatar_array = avatar_array_new(num_avatars);
+    for (int i = 0; i < num_avatars; i++)
+    {
+        avatar_t *avatar = avatar_new(i);
+        position_setX(avatar_getPosition(avatar), record.positions[i].x);
+        position_setY(avatar_getPosition(avatar), record.positions[i].y);
+        avatar_array_add(avatar_array, avatar);
+    }
+    if (entry.checkpoint < 0)
+    {
+        printf("Record %ld of the log, replayed from the start of the game. Meeting point: (%d, %d)",
+            record_number, (int)record.target.x, (int)record.target.y);
+    }
+    else
+    {
+        printf("Record %ld of the log, replayed from checkpoint %ld. Meeting point: (%d, %d)",
+            record_number, entry.checkpoint, (int)record.target.x, (int)record.target.y);
+    }
+    turnlog_write_record(stdout, LOG_FORMAT_TEXT, num_avatars, &record);
+    if (window[2] == 0 && block == 1)
+    {
+        print_map(logindex_get_MazeHeight(ix), logindex_get_MazeWidth(ix), avatar_array, num_avatars, map);
+    }
+    else
+    {
+        // Only the window, or the overview, written by a renderer straight to the output once the turn is flushed
+        renderer_t *rd = renderer_new(STDOUT_FILENO, logindex_get_MazeWidth(ix), logindex_get_MazeHeight(ix), false);
+        if (rd == NULL)
+        {
+            fprintf(stderr, "ERROR: 5: Error allocating memory for the renderer. Exiting. \n");
+            exit(5);
+        }
+        renderer_set_overview(rd, block);
+        if (window[2] > 0)
+        {
+            renderer_set_view(rd, window[2], window[3], RENDER_FOLLOW_NONE);
+            renderer_scroll(rd, window[0], window[1]);
+        }
+        fflush(stdout);
+        renderer_print(rd, map, avatar_array, num_avatars);
+        renderer_delete(rd);
+    }
+
+    // Clean up
+    avatar_array_delete(avatar_array, num_avatars);
+    map_delete(map);
+    logindex_delete(ix);
+
+    // Program complete. Exit 0 on success.
+    exit(0);
+}
+
+/******** AMReplay_Parse_Options ********/
+/* AMReplay_Parse_Options reads the -V and -O options at the front of the arguments. Saves the number of
+ * arguments they take up into num_options, the window's x, y, width and height into window (left alone
+ * if -V is not given) and the overview's block into block (left alone if -O is not given).
+ * Returns:
+ * - 0 if all options are valid
+ * - non-zero otherwise
+ */
+int AMReplay_Parse_Options(const int argc, const char *argv[], int *num_options, int window[4], int *block)
+{
+    int i = 1;
+    while (i < argc && (strcmp(argv[i], "-V") == 0 || strcmp(argv[i], "-O") == 0))
+    {
+        if (i + 1 >= argc)
+        {
+            fprintf(stderr, "ERROR: 1: Option %s requires a value. Exiting. \n", argv[i]);
+            return 1;
+        }
+
+        // -V x,y,width,height: the window of the map printed
+        if (strcmp(argv[i], "-V") == 0)
+        {
+            char extra;
+            if (sscanf(argv[i + 1], "%d,%d,%d,%d%c", &window[0], &window[1], &window[2], &window[3], &extra) != 4
+                || window[0] < 0 || window[1] < 0 || window[2] < 1 || window[3] < 1)
+            {
+                fprintf(stderr, "ERROR: 7: Invalid window '%s'. It must be x,y,width,height, with a width and height of 1 or more. Exiting. \n",
+                    argv[i + 1]);
+                return 7;
+            }
+        }
+        // -O block: an overview, each character for a block of cells
+        else
+        {
+            char *end;
+            long size = strtol(argv[i + 1], &end, 10);
+            if (*argv[i + 1] == '\0' || *end != '\0' || size < 2 || size > 100)
+            {
+                fprintf(stderr, "ERROR: 8: Invalid block size '%s'. It must be a whole number from 2 to 100. Exiting. \n", argv[i + 1]);
+                return 8;
+            }
+            *block = (int)size;
+        }
+        i += 2;
+    }
+
+    *num_options = i - 1;
+    return 0;
+}
+
+/******** AMReplay_Map_At ********/
+/* AMReplay_Map_At rebuilds the map as it was once record record_number of the log was played: from
+ * checkpoint checkpoint, or from the empty map the game starts with if it is -1, it replays every
+ * record after the checkpoint's up to record_number. A turn's positions show where the move before
+ * it ended up, which the map takes in with apply_last_move, as the avatar whose turn it was did; then
+ * its meeting point is set. The solved message fills the traps the last move closed off, as thread 0
+ * did on receiving it. Errors change nothing.
+ * Returns NULL if the log, its index or the checkpoint could not be read, or memory allocated.
+ * Memory: caller is responsible for calling map_delete
+ */
+map_t *AMReplay_Map_At(logindex_t *ix, long checkpoint, long record_number)
+{
+    int mazeWidth = logindex_get_MazeWidth(ix);
+    int num_avatars = logindex_get_num_avatars(ix);
+
+    // Start from the checkpoint, or as client_start does
+    map_t *map = map_new(mazeWidth, logindex_get_MazeHeight(ix));
+    if (map == NULL)
+    {
+        return NULL;
+    }
+    long from = -1;
+    if (checkpoint < 0)
+    {
+        if (!map_setTargetXY(map, mazeWidth - 1, 0) || !map_setInference(map, true))
+        {
+            map_delete(map);
+            return NULL;
+        }
+    }
+    else
+    {
+        if (!map_setInference(map, true) || !logindex_load_checkpoint(ix, checkpoint, map, &from)
+            || from > record_number)
+        {
+            map_delete(map);
+            return NULL;
+        }
+    }
+
+    // The avatars, who is on each cell, and the last move requested: that of the last turn at or before the checkpoint
+    avatar_t **avatar_array = avatar_array_new(num_avatars);
+    occupancy_t *occupancy = occupancy_new(mazeWidth, logindex_get_MazeHeight(ix), num_avatars);
+    last_move_t *last_move = last_move_new();
+    for (int i = 0; i < num_avatars; i++)
+    {
+        avatar_array_add(avatar_array, avatar_new(i));
+    }
+    turn_record_t last_turn;
+    bool have_last_turn = false;
+    logindex_entry_t entry;
+    for (long j = from; j >= 0 && !have_last_turn; j--)
+    {
+        if (logindex_entry(ix, j, &entry) && entry.kind == RECORD_TURN)
+        {
+            have_last_turn = logindex_read(ix, j, &last_turn);
+        }
+    }
+
+    // Replay each record after the checkpoint's
+    bool replayed = true;
+    turn_record_t record;
+    for (long j = from + 1; j <= record_number; j++)
+    {
+        if (!logindex_read(ix, j, &record))
+        {
+            replayed = false;
+            break;
+        }
+        if (record.kind == RECORD_ERROR)
+        {
+            continue;
+        }
+
+        // Every avatar is where the record has it; only the last mover can have moved since the last turn
+        for (int i = 0; i < num_avatars; i++)
+        {
+            position_setX(avatar_getPosition(avatar_array[i]), record.positions[i].x);
+            position_setY(avatar_getPosition(avatar_array[i]), record.positions[i].y);
+        }
+        occupancy_sync(occupancy, avatar_array);
+
+        // The last move requested, as SOT_last_move_global held it
+        if (have_last_turn)
+        {
+            int last_id = last_turn.avatar_id;
+            int initial_x = last_turn.positions[last_id].x;
+            int initial_y = last_turn.positions[last_id].y;
+            int attempted_x = initial_x + (last_turn.move == M_EAST) - (last_turn.move == M_WEST);
+            int attempted_y = initial_y + (last_turn.move == M_SOUTH) - (last_turn.move == M_NORTH);
+            last_move_set_last_ID(last_move, last_id);
+            last_move_set_initial_x(last_move, initial_x);
+            last_move_set_initial_y(last_move, initial_y);
+            last_move_set_x_attempt(last_move, attempted_x);
+            last_move_set_y_attempt(last_move, attempted_y);
+
+            if (record.kind == RECORD_TURN)
+            {
+                apply_last_move(map, avatar_array, occupancy, last_move,
+                    record.positions[last_id].x, record.positions[last_id].y);
+            }
+            else
+            {
+                map_fillDeadEnds(map, initial_x, initial_y, occupancy);
+            }
+        }
+
+        // The meeting point the turn's avatar elected
+        if (record.kind == RECORD_TURN)
+        {
+            if ((int)record.target.x != map_getTargetX(map) || (int)record.target.y != map_getTargetY(map))
+            {
+                map_setTargetXY(map, record.target.x, record.target.y);
+            }
+            last_turn = record;
+            have_last_turn = true;
+        }
+    }
+
+    avatar_array_delete(avatar_array, num_avatars);
+    occupancy_delete(occupancy);
+    last_move_delete(last_move);
+    if (!replayed)
+    {
+        map_delete(map);
+        return NULL;
+    }
+    return map;
+}
+
+/******** AMReplay_Same_Map ********/
+/* AMReplay_Same_Map returns true if maps a and b, of the same size, have the same edges, target and
+ * distance from every cell to it
+ */
+bool AMReplay_Same_Map(map_t *a, map_t *b)
+{
+    size_t size = map_packedSize(a);
+    uint8_t *packed_a = malloc(size);
+    uint8_t *packed_b = malloc(size);
+    if (packed_a == NULL || packed_b == NULL)
+    {
+        fprintf(stderr, "ERROR: 5: Error allocating memory to compare maps. Exiting. \n");
+        exit(5);
+    }
+    map_pack(a, packed_a);
+    map_pack(b, packed_b);
+    bool same = memcmp(packed_a, packed_b, size) == 0
+        && map_getTargetX(a) == map_getTargetX(b) && map_getTargetY(a) == map_getTargetY(b);
+    free(packed_a);
+    free(packed_b);
+    for (int y = 0; same && y < map_getMazeHeight(a); y++)
+    {
+        for (int x = 0; same && x < map_getMazeWidth(a); x++)
+        {
+            same = map_distanceXY(a, x, y) == map_distanceXY(b, x, y);
+        }
+    }
+    return same;
+}
+
+/******** AMReplay_Verify ********/
+/* AMReplay_Verify replays the log from each checkpoint, or from the start of the game, up to the
+ * record of the next checkpoint, and checks the map replayed matches that checkpoint. Prints a line
+ * per checkpoint, and returns 0 if all of them matched, 6 if any did not and 4 if the log could not
+ * be replayed
+ */
+int AMReplay_Verify(logindex_t *ix)
+{
+    int status = 0;
+    long checkpoints = logindex_checkpoint_count(ix);
+    for (long c = 0; c < checkpoints; c++)
+    {
+        map_t *expected = map_new(logindex_get_MazeWidth(ix), logindex_get_MazeHeight(ix));
+        long record_number;
+        if (!map_setInference(expected, true) || !logindex_load_checkpoint(ix, c, expected, &record_number))
+        {
+            fprintf(stderr, "ERROR: 4: Could not read checkpoint %ld. \n", c);
+            map_delete(expected);
+            return 4;
+        }
+        map_t *replayed = AMReplay_Map_At(ix, c - 1, record_number);
+        if (replayed == NULL)
+        {
+            fprintf(stderr, "ERROR: 4: Could not replay the log up to record %ld. \n", record_number);
+            map_delete(expected);
+            return 4;
+        }
+        if (AMReplay_Same_Map(expected, replayed))
+        {
+            printf("Checkpoint %ld, as of record %ld: matches the replay. \n", c, record_number);
+        }
+        else
+        {
+            printf("Checkpoint %ld, as of record %ld: does NOT match the replay. \n", c, record_number);
+            status = 6;
+        }
+        map_delete(expected);
+        map_delete(replayed);
+    }
+    printf("%ld checkpoints of %ld records checked. \n", checkpoints, logindex_count(ix));
+    return status;
+}
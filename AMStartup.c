@@ -16,10 +16,31 @@
  *                  provided by the user (port number assigned in amazing.h). It then
  *                  calls the AMClient module to begin game solving.
  * 
- * Usage:           ./AMStartup [Number of avatars] [Difficulty level] [Hostname]
+ * Usage:           ./AMStartup [options] [Number of avatars] [Difficulty level] [Hostname]
  *                  [Number of avatars] must be between 1 and 10 inclusive
  *                  [Difficulty level] must be between 0 and 9 inclusive
  *                  [Hostname] must be a valid server IP address
+ *                  Options, which must come before the other arguments:
+ *                  -s [strategy]   move strategy of the avatars (see strategy.c); an
+ *                                  unknown name prints the list of strategies
+ *                  -m [mode]       how the client runs the avatars: "threads", one
+ *                                  thread per avatar (the default), or "epoll", one
+ *                                  thread for all of them (see AMClient.c)
+ *                  -l [format]     the log's format: "text", the Amazing_*.log read by
+ *                                  people (the default), or "binary", a much smaller
+ *                                  Amazing_*.bin which AMLogText turns into the text
+ *                                  log (see turnlog.h)
+ *                  -f [fps]        the most frames of the maze drawn a second (30 by
+ *                                  default), or 0 to draw one only when sent SIGUSR2,
+ *                                  and the last (see recorder.h)
+ *                  -H              headless: draw nothing, and dump the map to the
+ *                                  log's name ending in .map once solved; the map
+ *                                  is also dumped when sent SIGUSR1, in any mode
+ *                  -V [avatar|t]   draw a view of the maze as large as fits on the
+ *                                  terminal, following the avatar with that ID, or
+ *                                  the meeting point with t (see render.h)
+ *                  -O [block]      draw an overview of the maze, each character for
+ *                                  a block x block block of cells, from 2 to 100
  */
 /* ========================================================================== */
 
@@ -41,6 +62,9 @@
 #include "libs/AMClient.h"
 
 /**************** local functions ****************/
+int AMStartup_Parse_Options(const int argc, const char *argv[], int *num_options, const strategy_t **strategy,
+                            client_mode_t *mode, log_format_t *log_format, int *fps, bool *headless,
+                            const char **follow, int *block);
 int AMStartup_Valid_Numeric_Inputs(const int argc, const char *argv[]);
 AM_Message *AMStartup_Create_AM_INIT(class_variables_t *cv);
 int AMStartup_Create_Logfile(class_variables_t *cv);
@@ -49,19 +73,57 @@ int AMStartup_Create_Logfile(class_variables_t *cv);
 int main(const int argc, const char *argv[])
 {
 
-    // Complete input validation
+    // Read the options, then validate the remaining arguments as if the options were not there
     int return_value;
-    if ((return_value = AMStartup_Valid_Numeric_Inputs(argc, argv)) != 0) {
+    int num_options = 0;
+    const strategy_t *strategy = strategy_default();
+    client_mode_t mode = CLIENT_MODE_THREADS;
+    log_format_t log_format = LOG_FORMAT_TEXT;
+    int fps = RECORDER_DEFAULT_FPS;
+    bool headless = false;
+    const char *follow = NULL;
+    int block = 1;
+    if ((return_value = AMStartup_Parse_Options(argc, argv, &num_options, &strategy, &mode, &log_format, &fps, &headless,
+                                                &follow, &block)) != 0) {
+        exit(return_value);
+    }
+    const int num_args = argc - num_options;
+    const char **args = argv + num_options;
+
+    // Complete input validation
+    if ((return_value = AMStartup_Valid_Numeric_Inputs(num_args, args)) != 0) {
         exit(return_value);
     }
 
+    // What the view follows: the meeting point, or an avatar, which must be one of those in the game
+    int view_follow = RENDER_FOLLOW_NONE;
+    if (follow != NULL && strcmp(follow, "t") == 0) {
+        view_follow = RENDER_FOLLOW_TARGET;
+    }
+    else if (follow != NULL) {
+        char *end;
+        long id = strtol(follow, &end, 10);
+        if (*follow == '\0' || *end != '\0' || id < 0 || id >= atoi(args[1])) {
+            fprintf(stderr, "ERROR: 26: Invalid view '%s'. It must be t or an avatar's ID, from 0 to %d. Exiting. \n",
+                    follow, atoi(args[1]) - 1);
+            exit(26);
+        }
+        view_follow = (int)id;
+    }
+
     // Allocate and initialize class_variables struct
-    class_variables_t *variables_holder = class_variables_new(atoi(argv[1]), atoi(argv[2]), argv[3]);
+    class_variables_t *variables_holder = class_variables_new(atoi(args[1]), atoi(args[2]), args[3]);
     if (variables_holder == NULL)
     {
         fprintf(stderr, "ERROR: 3: error allocating memory for variables_holder. Exiting. \n");
         exit(3);
     }
+    class_variables_set_strategy(variables_holder, strategy);
+    class_variables_set_mode(variables_holder, mode);
+    class_variables_set_log_format(variables_holder, log_format);
+    class_variables_set_fps(variables_holder, headless ? RECORDER_HEADLESS : fps);
+    class_variables_set_view_follow(variables_holder, view_follow);
+    class_variables_set_overview_block(variables_holder, block);
 
     // Create socket connection
     int sock = socket(AF_INET, SOCK_STREAM, 0);
@@ -170,6 +232,152 @@ int main(const int argc, const char *argv[])
 
 /******** Helper functions ********/
 
+/******** AMStartup_Parse_Options ********/
+/* AMStartup_Parse_Options reads the options at the front of the arguments, up to the first
+ * argument which does not start with '-'. Saves the number of arguments they take up into
+ * num_options, the selected move strategy into strategy, the selected mode into mode, the
+ * selected log format into log_format, the selected frame rate into fps, what the view is to
+ * follow into follow, checked once the number of avatars is known, and the selected overview
+ * block into block (each left alone if not selected), and whether headless was selected into
+ * headless.
+ * Returns:
+ * - 0 if all options are valid
+ * - non-zero otherwise
+ */
+int AMStartup_Parse_Options(const int argc, const char *argv[], int *num_options, const strategy_t **strategy,
+                            client_mode_t *mode, log_format_t *log_format, int *fps, bool *headless,
+                            const char **follow, int *block)
+{
+    int i = 1;
+    while (i < argc && argv[i][0] == '-')
+    {
+        // -s [strategy]: the move strategy
+        if (strcmp(argv[i], "-s") == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                fprintf(stderr, "ERROR: 16: Option -s requires a strategy name. Exiting. \n");
+                return 16;
+            }
+            *strategy = strategy_find(argv[i + 1]);
+            if (*strategy == NULL)
+            {
+                fprintf(stderr, "ERROR: 17: Unknown strategy '%s'. The strategies are:\n", argv[i + 1]);
+                strategy_print_all(stderr, "\t");
+                return 17;
+            }
+            i += 2;
+        }
+        // -m [mode]: how the client runs the avatars
+        else if (strcmp(argv[i], "-m") == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                fprintf(stderr, "ERROR: 19: Option -m requires a mode, threads or epoll. Exiting. \n");
+                return 19;
+            }
+            if (strcmp(argv[i + 1], "threads") == 0)
+            {
+                *mode = CLIENT_MODE_THREADS;
+            }
+            else if (strcmp(argv[i + 1], "epoll") == 0)
+            {
+                *mode = CLIENT_MODE_EPOLL;
+            }
+            else
+            {
+                fprintf(stderr, "ERROR: 20: Unknown mode '%s'. The modes are threads and epoll. Exiting. \n", argv[i + 1]);
+                return 20;
+            }
+            i += 2;
+        }
+        // -l [format]: the log's format
+        else if (strcmp(argv[i], "-l") == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                fprintf(stderr, "ERROR: 21: Option -l requires a log format, text or binary. Exiting. \n");
+                return 21;
+            }
+            if (strcmp(argv[i + 1], "text") == 0)
+            {
+                *log_format = LOG_FORMAT_TEXT;
+            }
+            else if (strcmp(argv[i + 1], "binary") == 0)
+            {
+                *log_format = LOG_FORMAT_BINARY;
+            }
+            else
+            {
+                fprintf(stderr, "ERROR: 22: Unknown log format '%s'. The formats are text and binary. Exiting. \n", argv[i + 1]);
+                return 22;
+            }
+            i += 2;
+        }
+        // -f [fps]: the most frames drawn a second, or 0 to draw on request
+        else if (strcmp(argv[i], "-f") == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                fprintf(stderr, "ERROR: 23: Option -f requires a frame rate. Exiting. \n");
+                return 23;
+            }
+            char *end;
+            long rate = strtol(argv[i + 1], &end, 10);
+            if (*argv[i + 1] == '\0' || *end != '\0' || rate < 0 || rate > 1000)
+            {
+                fprintf(stderr, "ERROR: 24: Invalid frame rate '%s'. It must be a whole number from 0 to 1000. Exiting. \n", argv[i + 1]);
+                return 24;
+            }
+            *fps = (int)rate;
+            i += 2;
+        }
+        // -H: headless, drawing nothing
+        else if (strcmp(argv[i], "-H") == 0)
+        {
+            *headless = true;
+            i += 1;
+        }
+        // -V [avatar|t]: a view following an avatar, or the meeting point
+        else if (strcmp(argv[i], "-V") == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                fprintf(stderr, "ERROR: 25: Option -V requires an avatar's ID, or t for the meeting point. Exiting. \n");
+                return 25;
+            }
+            *follow = argv[i + 1];
+            i += 2;
+        }
+        // -O [block]: an overview, each character for a block of cells
+        else if (strcmp(argv[i], "-O") == 0)
+        {
+            if (i + 1 >= argc)
+            {
+                fprintf(stderr, "ERROR: 27: Option -O requires a block size. Exiting. \n");
+                return 27;
+            }
+            char *end;
+            long size = strtol(argv[i + 1], &end, 10);
+            if (*argv[i + 1] == '\0' || *end != '\0' || size < 2 || size > 100)
+            {
+                fprintf(stderr, "ERROR: 28: Invalid block size '%s'. It must be a whole number from 2 to 100. Exiting. \n", argv[i + 1]);
+                return 28;
+            }
+            *block = (int)size;
+            i += 2;
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: 18: Unknown option '%s'. Exiting. \n", argv[i]);
+            return 18;
+        }
+    }
+
+    *num_options = i - 1;
+    return 0;
+}
+
 /******** AMStartup_Valid_Numeric_Inputs ********/
 /* AMStartup_Valid_Numeric_Inputs validates the inputs provided by the user.
  * Returns:
@@ -249,7 +457,9 @@ AM_Message *AMStartup_Create_AM_INIT(class_variables_t *cv)
 
 /******** AMStartup_Create_logfile ********/
 /* AMStartup_Create_logfile creates and writes the header to a log file
- * for the run. Saves the logfile name to the class_variables struct provided
+ * for the run, in the log format saved in the class_variables struct: text,
+ * to Amazing_[USER]_[NUMBER OF AVATARS]_[DIFFICULTY].log, or binary, to the
+ * same name ending in .bin (see turnlog.h). Saves the logfile name to the class_variables struct provided
  * by the caller.
  * Memory: allocates memory for a file name and saves it into class_variables
  * struct provided by the caller. Caller is responsible for later calling
@@ -271,11 +481,12 @@ int AMStartup_Create_Logfile(class_variables_t *cv)
     sprintf(difficulty, "%d", class_variables_get_difficulty(cv));
 
     // Compose the file name by allocating memory and then writing the name
+    const char *extension = (class_variables_get_log_format(cv) == LOG_FORMAT_BINARY) ? ".bin" : ".log";
     char *filename = malloc(strlen("Amazing_") + strlen(username) + strlen("_") + strlen(numAv)
-         + strlen("_") + strlen(difficulty) + strlen(".log") + 1);
+         + strlen("_") + strlen(difficulty) + strlen(extension) + 1);
     snprintf(filename, strlen("Amazing_") + strlen(username) + strlen("_") + strlen(numAv) 
-        + strlen("_") + strlen(difficulty) + strlen(".log") + 1, 
-        "%s%s%s%s%s%s%s", "Amazing_", username, "_", numAv, "_", difficulty, ".log");
+        + strlen("_") + strlen(difficulty) + strlen(extension) + 1, 
+        "%s%s%s%s%s%s%s", "Amazing_", username, "_", numAv, "_", difficulty, extension);
     
     // Attempt to open the file for writing
     FILE *fp;
@@ -285,22 +496,23 @@ int AMStartup_Create_Logfile(class_variables_t *cv)
         return 31;
     }
 
-    // Write the username to the file header
-    fprintf(fp, "%s, ", username);
-
-    // Write the mazePort to the file header
-    char port[20];
-    sprintf(port, "%d", class_variables_get_mazePort(cv));
-    fprintf(fp, "%s, ", port);
-
-    // Write the time to the file header
-    time_t currtime;
-    time(&currtime);
-    char *time_string = ctime(&currtime);
-    fprintf(fp, "%s", time_string);
+    // Write the username, mazePort and time to the file header, with what a binary log needs besides
+    turnlog_header_t header;
+    header.username = username;
+    header.mazePort = class_variables_get_mazePort(cv);
+    header.mazeWidth = class_variables_get_MazeWidth(cv);
+    header.mazeHeight = class_variables_get_MazeHeight(cv);
+    header.num_avatars = class_variables_get_num_avatars(cv);
+    header.difficulty = class_variables_get_difficulty(cv);
+    time(&header.start_time);
+    bool written = turnlog_write_header(fp, class_variables_get_log_format(cv), &header);
 
     // Close the logfile
-    fclose(fp);
+    if (fclose(fp) != 0 || !written) {
+        fprintf(stderr, "ERROR: 32: Writing the header of the logfile failed. Exiting. \n");
+        free(filename);
+        return 32;
+    }
 
     // Save the pointer to the logfile name into the class_variables struct. 
     class_variables_set_log_file_name(cv, filename);
@@ -30,8 +30,13 @@
 #include <unistd.h>
 #include <pthread.h>
 #include <stdbool.h>
+#include <time.h>
+#include <errno.h>
+#include <signal.h>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
 
 // Import project-specific libraries
 #include "map.h"
@@ -40,6 +45,12 @@
 #include "amazing.h"
 #include "AMClient.h"
 #include "simpleprint.h"
+#include "strategy.h"
+#include "rendezvous.h"
+#include "convoy.h"
+#include "pairing.h"
+#include "speculate.h"
+#include "recorder.h"
 
 /**************** Debug Switches ****************/
 static const int DEBUG_SWITCH_ITR = 0;                                         // DEBUG_SWITCH_ITR: on = 1, off = 0
@@ -47,18 +58,57 @@ static const int END_RUN_ITR = 100;                                            /
 
 /**************** Mutual Exclusion Locks ****************/
 pthread_mutex_t mutexReadAndWrite = PTHREAD_MUTEX_INITIALIZER;          // Mutex lock used for all reads and writes to the server
+pthread_cond_t condMoveSent[AM_MAX_AVATAR];                             // condMoveSent[i] is signalled, with the lock held, when the avatar before avatar i
+                                                                        // has set its move in SOT_last_move_global. Initialized by client_start
+
+/**************** Speculation: file-local constants ****************/
+static const int SPECULATE_WAIT_S = 2;                                  // Longest an avatar waits for the move before its turn to be sent, to decide ahead
+
+/**************** Turn latency: file-local state ****************/
+// The time from reading the message of an avatar's turn to sending its move, over every turn of the game. Updated with
+// the lock held, and reported by client_start to compare the modes
+static struct {
+    long turns;
+    double total_ms;
+    double longest_ms;
+} turnLatency;
+
+/**************** Lock statistics: file-local state ****************/
+// How long the avatars waited to take mutexReadAndWrite, and how long they held it, over the whole game. Updated with
+// the lock held, through lock_shared, unlock_shared and wait_shared, and reported by client_start
+static struct {
+    long acquisitions;
+    double wait_ms;
+    double longest_wait_ms;
+    double hold_ms;
+    double longest_hold_ms;
+} lockStats;
+static _Thread_local struct timespec lockAcquired;                      // When the calling thread last took the lock
+
+/**************** Frames and dumps on request: file-local state ****************/
+// The recorder sent a frame request on SIGUSR2, and a dump request on SIGUSR1, set by client_start for the length of the game
+static recorder_t *volatile frameRecorder = NULL;
 
 /**************** Logging Step: file-local constants ****************/
 // Set of special constants used locally by the threads to save results of update step for the logging step
-static const int prev_move_wall        = 1;                             // Indicates that the prior move was not successful and resulted in encountering a wall
-static const int prev_move_path        = 2;                             // Indicates that the prior move was successful and traversed a path
-static const int prev_move_path_fill   = 3;                             // Indicates that the prior move was successful and traversed a path, and that a trap was identified
+static const int prev_move_wall        = RECORD_OUTCOME_WALL;           // Indicates that the prior move was not successful and resulted in encountering a wall
+static const int prev_move_path        = RECORD_OUTCOME_PATH;           // Indicates that the prior move was successful and traversed a path
+static const int prev_move_path_fill   = RECORD_OUTCOME_PATH_FILL;      // Indicates that the prior move was successful and traversed a path, and that a trap was identified
                                                                         // and a wall was filled
-
-
+static const int prev_move_stay        = RECORD_OUTCOME_STAY;           // Indicates that the prior avatar stayed where it was (at the meeting point)
+
+/**************** local functions ****************/
+static void record_turn_latency(const struct timespec *received);
+static double seconds_between(const struct timeval *start, const struct timeval *end);
+static double ms_between(const struct timespec *start, const struct timespec *end);
+static void lock_shared(void);
+static void unlock_shared(void);
+static int wait_shared(pthread_cond_t *cond, const struct timespec *deadline);
+static void request_frame(int signum);
+static void request_dump(int signum);
 
 /**************** client_start ****************/
-/* client_start is the parent which spawns each of the player threads. It is called from main() in AMStartup.c
+/* client_start is the parent which plays each of the avatars. It is called from main() in AMStartup.c
  * Memory: Takes the class_variables struct as a pointer from AMStartup.c containing initialization parameters
  * Does not free this memory at the end of the run; freeing class_variables_t *cv is the responsibility of the
  * caller program (AMStartup).
@@ -67,8 +117,10 @@ static const int prev_move_path_fill   = 3;                             // Indic
  *  - initializes structures shared by all of the threads (e.g. map)
  *  - creates a struct (thread_initial_info) to pass to each thread containing useful information (e.g. pointers to shared data structures, 
  *    and the thread's ID)
- *  - spawns the threads
- *  - upon closing of each thread, it frees memory which was allocated within this function
+ *  - plays the avatars selected by the mode of cv: spawns a thread for each (CLIENT_MODE_THREADS), or plays them all
+ *    from this thread with client_event_loop (CLIENT_MODE_EPOLL)
+ *  - once the avatars are done, it frees memory which was allocated within this function, and reports the time from
+ *    reading each turn's message to sending its move, and the CPU time the game took
  * 
  * Return:
  *  - false if any error occurs that should terminate the program
@@ -83,6 +135,21 @@ bool client_start(class_variables_t *cv)
     map_t *SOT_shared_map;
     SOT_shared_map = map_new(class_variables_get_MazeWidth(cv), class_variables_get_MazeHeight(cv));
 
+    // The meeting point (see avatar_at_point) must never be sealed off as a dead end. It starts at the top right
+    // corner, until the rendezvous elects a better one from the avatars' positions
+    if (!map_setTargetXY(SOT_shared_map, class_variables_get_MazeWidth(cv) - 1, 0))
+    {
+        fprintf(stderr, "Error, could not allocate the map's distance field. Returning from client_start function with 'false' return value.\n");
+        return false;
+    }
+
+    // The maze is perfect, so the map can infer edges that no avatar has probed
+    if (!map_setInference(SOT_shared_map, true))
+    {
+        fprintf(stderr, "Error, could not allocate the map's inference. Returning from client_start function with 'false' return value.\n");
+        return false;
+    }
+
     // SOT_Last_move_global
     last_move_t *SOT_last_move_global;
     SOT_last_move_global = last_move_new();
@@ -90,143 +157,210 @@ bool client_start(class_variables_t *cv)
     // SOT_avatar_array
     avatar_t **SOT_avatar_array = avatar_array_new(class_variables_get_num_avatars(cv));
 
-    /*** 2. Spawn threads ***/
+    // SOT_occupancy, which says who is on each cell: every change to SOT_avatar_array's positions goes to it too
+    occupancy_t *SOT_occupancy = occupancy_new(class_variables_get_MazeWidth(cv), class_variables_get_MazeHeight(cv),
+        class_variables_get_num_avatars(cv));
 
-    // Create array of avatar threads
-    pthread_t client_threads[class_variables_get_num_avatars(cv) - 1];
+    // SOT_rendezvous
+    rendezvous_t *SOT_rendezvous = rendezvous_new(class_variables_get_MazeWidth(cv), class_variables_get_MazeHeight(cv));
+    if (SOT_rendezvous == NULL)
+    {
+        fprintf(stderr, "Error, could not allocate the rendezvous. Returning from client_start function with 'false' return value.\n");
+        return false;
+    }
 
-    // For each thread to be created ...
+    // SOT_convoy
+    convoy_t *SOT_convoy = convoy_new(class_variables_get_num_avatars(cv), class_variables_get_MazeWidth(cv), class_variables_get_MazeHeight(cv));
+    if (SOT_convoy == NULL)
+    {
+        fprintf(stderr, "Error, could not allocate the convoy. Returning from client_start function with 'false' return value.\n");
+        return false;
+    }
+
+    // SOT_pairing
+    pairing_t *SOT_pairing = pairing_new(class_variables_get_MazeWidth(cv), class_variables_get_MazeHeight(cv));
+    if (SOT_pairing == NULL)
+    {
+        fprintf(stderr, "Error, could not allocate the pairing. Returning from client_start function with 'false' return value.\n");
+        return false;
+    }
+
+    // SOT_speculation
+    speculation_t *SOT_speculation = speculation_new(class_variables_get_num_avatars(cv), class_variables_get_MazeWidth(cv), class_variables_get_MazeHeight(cv));
+    if (SOT_speculation == NULL)
+    {
+        fprintf(stderr, "Error, could not allocate the speculation. Returning from client_start function with 'false' return value.\n");
+        return false;
+    }
+
+    // SOT_recorder, which prints and logs each turn once its move is sent
+    recorder_t *SOT_recorder = recorder_new(class_variables_get_log_file_name(cv), class_variables_get_log_format(cv),
+        SOT_shared_map, &mutexReadAndWrite,
+        class_variables_get_MazeWidth(cv), class_variables_get_MazeHeight(cv), class_variables_get_num_avatars(cv),
+        class_variables_get_fps(cv));
+    if (SOT_recorder == NULL)
+    {
+        fprintf(stderr, "Error, could not start the recorder. Returning from client_start function with 'false' return value.\n");
+        return false;
+    }
+
+    // The frames show a view following what the user chose, or an overview, if either was chosen
+    recorder_set_view(SOT_recorder, class_variables_get_view_follow(cv), class_variables_get_overview_block(cv));
+
+    // A frame is drawn whenever SIGUSR2 is sent, however the frame rate is set; reads and writes interrupted by it resume
+    frameRecorder = SOT_recorder;
+    struct sigaction frame_action;
+    memset(&frame_action, 0, sizeof(frame_action));
+    frame_action.sa_handler = request_frame;
+    frame_action.sa_flags = SA_RESTART;
+    sigemptyset(&frame_action.sa_mask);
+    sigaction(SIGUSR2, &frame_action, NULL);
+
+    // And the map is dumped to a file whenever SIGUSR1 is sent, in any mode
+    struct sigaction dump_action = frame_action;
+    dump_action.sa_handler = request_dump;
+    sigaction(SIGUSR1, &dump_action, NULL);
+
+    // Set up each avatar's wake-up for deciding ahead
     for (int i = 0; i < class_variables_get_num_avatars(cv); i++)
     {
+        pthread_cond_init(&condMoveSent[i], NULL);
+    }
 
-        // Create a struct holding values to pass to the thread
+    // Start timing the game
+    memset(&turnLatency, 0, sizeof(turnLatency));
+    memset(&lockStats, 0, sizeof(lockStats));
+    struct rusage usage_start;
+    getrusage(RUSAGE_SELF, &usage_start);
+
+    /*** 2. Create a struct for each avatar holding values to pass to it ***/
+    thread_initial_info_t *thread_infos[class_variables_get_num_avatars(cv)];
+    for (int i = 0; i < class_variables_get_num_avatars(cv); i++)
+    {
         thread_initial_info_t *thread_info = thread_initial_info_new(cv, i);
         thread_initial_info_set_SOT_shared_map(thread_info, SOT_shared_map);
         thread_initial_info_set_SOT_last_move_global(thread_info, SOT_last_move_global);
         thread_initial_info_set_SOT_avatar_array(thread_info, SOT_avatar_array);
+        thread_initial_info_set_SOT_occupancy(thread_info, SOT_occupancy);
+        thread_initial_info_set_SOT_rendezvous(thread_info, SOT_rendezvous);
+        thread_initial_info_set_SOT_convoy(thread_info, SOT_convoy);
+        thread_initial_info_set_SOT_pairing(thread_info, SOT_pairing);
+        thread_initial_info_set_SOT_speculation(thread_info, SOT_speculation);
+        thread_initial_info_set_SOT_recorder(thread_info, SOT_recorder);
+        thread_infos[i] = thread_info;
+    }
+
+    /*** 3. Play the avatars: all of them from this thread, or each from a thread of its own ***/
+    bool played = true;
+    if (class_variables_get_mode(cv) == CLIENT_MODE_EPOLL)
+    {
+        printf("STATUS: Client Start: Playing %d avatars from one thread.\n", class_variables_get_num_avatars(cv));
+        played = client_event_loop(thread_infos, class_variables_get_num_avatars(cv));
+    }
+    else
+    {
+        // Create array of avatar threads
+        pthread_t client_threads[class_variables_get_num_avatars(cv)];
 
-        // Create the thread
-        int return_value = pthread_create(&client_threads[i], NULL, thread_avatar, thread_info);
-        if (return_value != 0)
+        // For each thread to be created ...
+        for (int i = 0; i < class_variables_get_num_avatars(cv); i++)
         {
-            fprintf(stderr, "Error, could not spawn thread %d. Returning from client_start function with 'false' return value.\n", i);
-            return false;
+
+            // Create the thread
+            int return_value = pthread_create(&client_threads[i], NULL, thread_avatar, thread_infos[i]);
+            if (return_value != 0)
+            {
+                fprintf(stderr, "Error, could not spawn thread %d. Returning from client_start function with 'false' return value.\n", i);
+                return false;
+            }
+            printf("STATUS: Client Start: Thread #%d spawned.\n", i);
         }
-        printf("STATUS: Client Start: Thread #%d spawned.\n", i);
-    }
 
-    /*** 3. Join the parent to the children threads, so that the parent will not close until the threads close ***/
-    for (int i = 0; i < class_variables_get_num_avatars(cv); i++)
-    {
-        pthread_join(client_threads[i], NULL);
+        // Join the parent to the children threads, so that the parent will not close until the threads close
+        for (int i = 0; i < class_variables_get_num_avatars(cv); i++)
+        {
+            pthread_join(client_threads[i], NULL);
+        }
     }
 
-    /*** 4. Once the threads have closed, close out data structures shared by all threads ***/
+    /*** 4. Once the avatars are done, close out data structures shared by all of them ***/
+
+    // Let the recorder finish logging first: it reads the shared map to print
+    signal(SIGUSR2, SIG_IGN);
+    signal(SIGUSR1, SIG_IGN);
+    frameRecorder = NULL;
+    long frames = recorder_get_frames(SOT_recorder);
+    recorder_delete(SOT_recorder);
     map_delete(SOT_shared_map);
     last_move_delete(SOT_last_move_global);
     avatar_array_delete(SOT_avatar_array, class_variables_get_num_avatars(cv));
+    occupancy_delete(SOT_occupancy);
+    printf("STATUS: Client Start: meeting point polled %d times, and moved %d times.\n",
+        rendezvous_getPolls(SOT_rendezvous), rendezvous_getElections(SOT_rendezvous));
+    rendezvous_delete(SOT_rendezvous);
+    convoy_delete(SOT_convoy);
+    pairing_delete(SOT_pairing);
+    printf("STATUS: Client Start: %d turns decided ahead of %d speculated.\n",
+        speculation_getTaken(SOT_speculation), speculation_getBegun(SOT_speculation));
+    speculation_delete(SOT_speculation);
+
+    // Report the turn latency and the CPU time the game took
+    struct rusage usage_end;
+    getrusage(RUSAGE_SELF, &usage_end);
+    printf("STATUS: Client Start: %s mode: %ld turns, %.3f ms mean and %.3f ms longest from reading a turn to sending its move; "
+        "%.3f s user and %.3f s system CPU time.\n",
+        (class_variables_get_mode(cv) == CLIENT_MODE_EPOLL) ? "epoll" : "threads", turnLatency.turns,
+        (turnLatency.turns > 0) ? turnLatency.total_ms / turnLatency.turns : 0.0, turnLatency.longest_ms,
+        seconds_between(&usage_start.ru_utime, &usage_end.ru_utime), seconds_between(&usage_start.ru_stime, &usage_end.ru_stime));
+    printf("STATUS: Client Start: lock taken %ld times: %.3f ms mean and %.3f ms longest wait to take it, "
+        "%.3f ms mean and %.3f ms longest held.\n", lockStats.acquisitions,
+        (lockStats.acquisitions > 0) ? lockStats.wait_ms / lockStats.acquisitions : 0.0, lockStats.longest_wait_ms,
+        (lockStats.acquisitions > 0) ? lockStats.hold_ms / lockStats.acquisitions : 0.0, lockStats.longest_hold_ms);
+    if (class_variables_get_fps(cv) == RECORDER_HEADLESS)
+    {
+        printf("STATUS: Client Start: headless, no frames drawn; the map is dumped to %s.map.\n", class_variables_get_log_file_name(cv));
+    }
+    else
+    {
+        printf("STATUS: Client Start: %ld frames of the maze drawn during the game, at most %d a second%s.\n", frames,
+            class_variables_get_fps(cv), (class_variables_get_fps(cv) == 0) ? " (on request only)" : "");
+    }
+    for (int i = 0; i < class_variables_get_num_avatars(cv); i++)
+    {
+        pthread_cond_destroy(&condMoveSent[i]);
+    }
 
-    // 5. Return success
-    return true;
+    // 5. Return whether the avatars were played
+    return played;
 }
 
 /**************** thread_avatar ****************/
-/* thread_avatar is the primary driver function for each thread, representing a player.
- * Memory: Accepts a thread_initial_info object as parameter. 
- * TO DO: The function needs to call a thread_initial_info_delete before exiting.
- * TO DO: Need to learn how to manage memory when exiting from a thread. 
+/* thread_avatar is the primary driver function for each thread, representing a player, in CLIENT_MODE_THREADS.
+ * Memory: Accepts a thread_initial_info object as parameter, which the avatar's session frees when it closes.
  *
  * The function does the following:
- * - Establishes a connection with the server
- * - Sends an AM_AVATAR_READY signal to the server
+ * - Opens the avatar's session: establishes a connection with the server, sends an AM_AVATAR_READY signal to the
+ *   server, and sets up the avatar's move strategy
  * - Enters a while (1) loop. This while loop does the following:
  *    - Reads the latest message from the server
- *    - If the message is not an AM_AVATAR_TURN message, handles it appropriately
- *    - If the message is an AM_AVATAR_TURN message, but it is not the thread's turn, then 
- *      proceeds to the next iteration without taking any action
- *    - If the message is an AM_AVATAR_TURN message, and it is the thread's turn, then
- *       - Prints the current positions (CURRENT)
- *       - Saves the impact of the message to all relevant data structures (FUTURE)
- *       - Runs decision algorithm to determine next move (FUTURE)
- *       - Constructs a move north message (CURRENT - TEMP)
- *       - Calls print and logging (FUTURE)
- *       - Sends a move message to the server (CURRENT)
- * 
+ *    - Hands it to avatar_session_handle with the lock held, which plays the avatar's turn if it is one
+ *    - Exits once the maze is solved or an error is received
+ * - Closes the session
+ *
  */
 
 void *thread_avatar(void *avatar_args)
 {
 
-    /*** 1. Save Initial Variables ***/
-
-    // Save down the input argument (thread_initial_info) and pull out the thread_id for use
-    thread_initial_info_t *thread_info = (thread_initial_info_t *)avatar_args;
-    int thread_id = thread_initial_info_get_threadID(thread_info);
-
-    // Set pointer for a thread-scope (Scope 2) last_thread representing the thread's last successful move
-    last_move_t *last_thread_success_move;
-
-    // Declare local positional variables
-    int local_current_x;
-    int local_current_y;
-    int local_attempted_x;
-    int local_attempted_y;
-
-    /*** 2. Establish Server Connection ***/
-
-    // Create socket
-    int sock = socket(AF_INET, SOCK_STREAM, 0);
-    if (sock < 0)
+    /*** 1. Open this avatar's session ***/
+    avatar_session_t session;
+    if (!avatar_session_open(&session, (thread_initial_info_t *)avatar_args))
     {
-        fprintf(stderr, "error opening socket");
         pthread_exit(0);
     }
-
-    // Initialize fields
-    // create appropriate socket address struct
-    struct sockaddr_in servaddr;
-    servaddr.sin_family = AF_INET;
-    servaddr.sin_port = htons(thread_initial_info_get_mazePort(thread_info));
-
-    // create host struct, thereby validating given hostname
-    struct hostent *host = gethostbyname(thread_initial_info_get_hostName(thread_info)); // server hostname
-    if (host == NULL)
-    {
-        fprintf(stderr, "Error 5: unknown host\n");
-        pthread_exit(0);
-    }
-    memcpy(&servaddr.sin_addr, host->h_addr_list[0], host->h_length);
-
-    // connect to server, checking success
-    if ((connect(sock, (struct sockaddr *)&servaddr, sizeof(servaddr))) < 0)
-    {
-        fprintf(stderr, "Error connecting to server\n");
-        pthread_exit(0);
-    }
-
-    /*** 3. Send Client Ready Message to the Server ***/
-
-    // Lock the write section
-    pthread_mutex_lock(&mutexReadAndWrite);
-
-    AM_Message ready_message;
-    memset(&ready_message, 0, sizeof(ready_message));
-    ready_message.type = htonl(AM_AVATAR_READY);
-    ready_message.avatar_ready.AvatarId = htonl(thread_id);
-    if ((write(sock, &ready_message, sizeof(ready_message))) < 0)
-    {
-        fprintf(stderr, "Error writing ready message to server\n");
-        pthread_exit(0);
-    }
-    printf("Thread #%d: Ready message sent to server \n", thread_id);
-
-    // Unlock the write section
-    pthread_mutex_unlock(&mutexReadAndWrite);
     sleep(2);
 
-    /*** 4. Enter the Primary While Loop's Control ***/
-    int iteration_count = 0;
-    last_thread_success_move = last_move_new();
+    /*** 2. Enter the Primary While Loop's Control ***/
     while (1)
     {
 
@@ -238,572 +372,660 @@ void *thread_avatar(void *avatar_args)
 
         // Conduct the read and throw an error if any problem in reading
         int bytesRead;
-        if ((bytesRead = read(sock, &return_message, sizeof(return_message))) < 0)
+        if ((bytesRead = read(session.sock, &return_message, sizeof(return_message))) < 0)
         {
             fprintf(stderr, "\tError reading from server\n");
             exit(7);
         }
+        clock_gettime(CLOCK_MONOTONIC, &session.received);
 
-        /*** 2. Begin mutex lock over remainder of while-loop iteration ***/
-        pthread_mutex_lock(&mutexReadAndWrite);
+        /*** 2. Drop the message without taking the lock if it is a turn this avatar has nothing to do on ***/
+        if (!avatar_session_concerns(&session, &return_message))
+        {
+            session.iteration_count++;
+            continue;
+        }
 
-        /*** 3. Handle message types other than AM_AVATAR_TURN ***/
+        /*** 3. Otherwise, handle the message with the lock held ***/
+        lock_shared();
+        session_status_t status = avatar_session_handle(&session, &return_message);
+        unlock_shared();
 
-        // Set up for updating the map, in case the game is solved on this turn
-        avatar_t **avatar_array = thread_initial_info_get_SOT_avatar_array(thread_info);
-        last_move_t *SOT_last_move_global = thread_initial_info_get_SOT_last_move_global(thread_info);
-        int previous_move_code = -1;
+        // Exit once the maze is solved or an error is received
+        if (status != SESSION_CONTINUE)
+        {
+            break;
+        }
 
-        // If the game is solved:
-        if (ntohl(return_message.type) == AM_MAZE_SOLVED)
+        // DEBUG Setting: If the debug setting is on, and the number of cycles allowed has been reached, exit the thread
+        if (DEBUG_SWITCH_ITR == 1)
         {
-            // Only Thread 0 should write the solved message to the log
-            if (thread_id == 0)
+            if (session.iteration_count == END_RUN_ITR)
             {
-                if (iteration_count != 0) 
-                {
-                    
-                    // *** Special case handling for the last move ***/
-                    
-                    // Pull out the values of the global last_move
-                    int last_id = last_move_get_last_ID(SOT_last_move_global);
-                    int attempted_x = last_move_get_x_attempt(SOT_last_move_global);
-                    int attempted_y = last_move_get_y_attempt(SOT_last_move_global);
-                    int initial_x = last_move_get_initial_x(SOT_last_move_global);
-                    int initial_y = last_move_get_initial_y(SOT_last_move_global);
-
-                    // Because the maze was solved, this move must have succeeded. Record the previous_move_code for passing to logging
-                    previous_move_code = prev_move_path;
-
-                    // In the avatar array, update the position of the prior avatar
-                    position_setX(avatar_getPosition(avatar_array[last_id]), attempted_x);
-                    position_setY(avatar_getPosition(avatar_array[last_id]), attempted_y);
-
-                    // Wall-filler: this fills in traps identified by the previous thread.
-                    int wall_count = 0;
-                    if (map_isWallXY(thread_initial_info_get_SOT_shared_map(thread_info), initial_x + 1, initial_y, initial_x, initial_y)){wall_count++;}
-                    if (map_isWallXY(thread_initial_info_get_SOT_shared_map(thread_info), initial_x, initial_y + 1, initial_x, initial_y)){wall_count++;}
-                    if (map_isWallXY(thread_initial_info_get_SOT_shared_map(thread_info), initial_x - 1, initial_y, initial_x, initial_y)){wall_count++;}
-                    if (map_isWallXY(thread_initial_info_get_SOT_shared_map(thread_info), initial_x, initial_y - 1, initial_x, initial_y)){wall_count++;}
-                    if (wall_count > 2) {
-                        if (avatar_array_find_avatar(thread_initial_info_get_SOT_avatar_array(thread_info), 
-                        thread_initial_info_get_num_avatars(thread_info), initial_x, initial_y) == -1) {
-                            
-                            // Set the wall
-                            map_setWallXY(thread_initial_info_get_SOT_shared_map(thread_info), initial_x, initial_y, attempted_x, attempted_y);
-
-                            // Update the previous_move_code for passing to logging
-                            previous_move_code = prev_move_path_fill;
-                        }
-                    }
-                }
+                break;
+            }
+        }
 
-                // System call to clear the screen before ASCII print
-                // Acknowledgement: We learned to clear the screen from the following article: 
-                // https://stackoverflow.com/questions/2347770/how-do-you-clear-the-console-screen-in-c
-                system("@cls||clear");  
-                
-                // Print the ASCII map
-                print_map(
-                    thread_initial_info_get_MazeHeight(thread_info),
-                    thread_initial_info_get_MazeWidth(thread_info),
-                    thread_initial_info_get_SOT_avatar_array(thread_info),
-                    thread_initial_info_get_num_avatars(thread_info),
-                    thread_initial_info_get_SOT_shared_map(thread_info));
-
-                // Open the log file and save the AM_SOLVED message contents
-                FILE *fp;
-                fp = fopen(thread_initial_info_get_log_file_name(thread_info), "a");
-                if (fp != NULL) { 
-                    // Save the message
-                    fprintf(fp, "\n*** Received AM_MAZE_SOLVED ***\n");
-                    fprintf(fp, "Message contents: Num avatars: %d; Difficulty level: %d; Num moves: %d; Hash: %d\n",
-                            ntohl(return_message.maze_solved.nAvatars), ntohl(return_message.maze_solved.Difficulty),
-                            ntohl(return_message.maze_solved.nMoves), ntohl(return_message.maze_solved.Hash));
-
-                    // Close the log file
-                    fclose(fp);
-                }
+        /*** While loop iteration ends here ***/
+    }
 
-            }
+    // If execution exits the while loop, then free memory and exit.
+    avatar_session_close(&session);
+    return NULL;
+}
 
-            // Unlock and break loop
-            pthread_mutex_unlock(&mutexReadAndWrite);
-            break;
+/**************** client_event_loop ****************/
+/* client_event_loop plays every avatar from the calling thread, in CLIENT_MODE_EPOLL.
+ * Memory: Accepts a thread_initial_info object for each avatar, which the avatar's session frees when it closes.
+ *
+ * The server sends each AM_AVATAR_TURN message to every avatar's socket, but only the copy on the turn owner's socket
+ * matters. The function does the following:
+ * - Opens every avatar's session, and watches all of their sockets with one epoll instance
+ * - Until every session has closed, reads a message from each socket epoll reports readable, and:
+ *    - Drops the copy of another avatar's turn without taking any action
+ *    - Otherwise hands it to avatar_session_handle, as thread_avatar does. Once the turn owner has sent its move, the
+ *      avatar after it decides its next move while that move is in flight, without waiting (see speculate_next_turn)
+ *    - Closes the session once the maze is solved or an error is received
+ *
+ * Return:
+ *  - false if the epoll instance or a session could not be set up
+ *  - true otherwise
+ */
+bool client_event_loop(thread_initial_info_t **thread_infos, int num_avatars)
+{
+
+    /*** 1. Open every avatar's session, and watch its socket ***/
+    avatar_session_t sessions[num_avatars];
+    bool running[num_avatars];
+    int num_running = 0;
+    int epoll_fd = epoll_create1(0);
+    for (int i = 0; i < num_avatars; i++)
+    {
+        running[i] = false;
+        struct epoll_event event;
+        memset(&event, 0, sizeof(event));
+        event.events = EPOLLIN;
+        event.data.u32 = i;
+        if (epoll_fd < 0 || !avatar_session_open(&sessions[i], thread_infos[i]))
+        {
+            thread_initial_info_delete(thread_infos[i]);
+            continue;
+        }
+        running[i] = true;
+        num_running++;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, sessions[i].sock, &event) < 0)
+        {
+            fprintf(stderr, "Error watching the socket of avatar %d\n", i);
+            avatar_session_close(&sessions[i]);
+            running[i] = false;
+            num_running--;
         }
+    }
 
-        // If an error message is detected:
-        if (IS_AM_ERROR(ntohl(return_message.type)))
+    // Unless every avatar is in the game, no turn will come: close the sessions which did open
+    if (num_running < num_avatars)
+    {
+        fprintf(stderr, "Error, could not set up every avatar's session. Returning from client_event_loop with 'false' return value.\n");
+        for (int i = 0; i < num_avatars; i++)
         {
-            
-            FILE *fp;
-            fp = fopen(thread_initial_info_get_log_file_name(thread_info), "a");
-            if (fp != NULL) 
+            if (running[i])
             {
-                // Write both to log file and to screen
-                fprintf(fp, "\tThread #%d: Received error. Message type: %d \n", thread_id, ntohl(return_message.type));
-                fprintf(stdout, "\tThread #%d: Received error. Message type: %d \n", thread_id, ntohl(return_message.type));
-
-                // Handlers for specific error messages - 
-
-                // If the server is out of memory, close the thread gracefully and exit
-                if (ntohl(return_message.type) == AM_SERVER_OUT_OF_MEM)
-                {
-                    fprintf(fp, "\tThread #%d: The error message type is AM_SERVER_OUT_OF_MEM \n", thread_id);
-                    fprintf(stdout, "\tThread #%d: The error message type is AM_SERVER_OUT_OF_MEM \n", thread_id);
-                }
-                // If the server has timed out, close the thread gracefully and exit
-                if (ntohl(return_message.type) == AM_SERVER_TIMEOUT)
-                {
-                    fprintf(fp, "\tThread #%d: The error message type is AM_SERVER_TIMEOUT \n", thread_id);
-                    fprintf(stdout, "\tThread #%d: The error message type is AM_SERVER_TIMEOUT \n", thread_id);
-                }
-                // If there have been too many moves, close the thread gracefully and exit
-                if (ntohl(return_message.type) == AM_TOO_MANY_MOVES)
-                {
-                    fprintf(fp, "\tThread #%d: The error message type is AM_TOO_MANY_MOVES \n", thread_id);
-                    fprintf(stdout, "\tThread #%d: The error message type is AM_TOO_MANY_MOVES \n", thread_id);
-                }
-                // If the server disk quota has been exceeded, close the thread gracefully and exit
-                if (ntohl(return_message.type) == AM_SERVER_DISK_QUOTA){
-                    fprintf(fp, "\tThread #%d: The error message type is AM_SERVER_DISK_QUOTA \n", thread_id);
-                    fprintf(stdout, "\tThread #%d: The error message type is AM_SERVER_DISK_QUOTA \n", thread_id);
-
-                }
-                fclose(fp);
+                avatar_session_close(&sessions[i]);
             }
+        }
+        if (epoll_fd >= 0)
+        {
+            close(epoll_fd);
+        }
+        return false;
+    }
 
-            // Close variables
-            free(avatar_args);
-            last_move_delete(last_thread_success_move);
-            pthread_mutex_unlock(&mutexReadAndWrite);
+    /*** 2. Until every session has closed, handle the messages on whichever sockets have one ***/
+    while (num_running > 0)
+    {
 
-            // Exit
-            return NULL;
+        // Wait for messages
+        struct epoll_event events[AM_MAX_AVATAR];
+        int num_ready = epoll_wait(epoll_fd, events, AM_MAX_AVATAR, -1);
+        if (num_ready < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            fprintf(stderr, "\tError waiting for messages from server\n");
+            exit(7);
         }
 
-        /*** 5. Further execution of this iteration only if ... ***/
-
-        // If it is an AM_AVATAR_TURN message and it is this avatar's turn ...
-        if (ntohl(return_message.type) == AM_AVATAR_TURN && ntohl(return_message.avatar_turn.TurnId) == thread_id)
-        { 
-
-            /*** 1. Save the impact of the message to all relevant data structures ***/
-            // ALL CHANGES TO SHARED DATA STRUCTURES SHOULD OCCUR BETWEEN HERE -->
-            // Check if last move was succesful
-            // if succesful,
-            // - update last successful direction in thread_last_move
-            // - update the map
-            // - update the avatar_array
-
-
-            // If the last_thread_success_move has not been initialized beyond calling new (i.e., ID = -100), then initialize it
-            if (last_move_get_last_ID(last_thread_success_move) == -100) {
-
-                /**** Set local positional variables for the first run ***/
-                local_current_x = ntohl(return_message.avatar_turn.Pos[thread_id].x);
-                local_current_y = ntohl(return_message.avatar_turn.Pos[thread_id].y);
-                last_move_set_last_ID(last_thread_success_move, thread_id);
-                last_move_set_last_success_dir(last_thread_success_move, M_EAST);
-                last_move_set_initial_x(last_thread_success_move, ntohl(return_message.avatar_turn.Pos[thread_id].x)); // Initiates last successful move holder
-                last_move_set_initial_y(last_thread_success_move, ntohl(return_message.avatar_turn.Pos[thread_id].y));
-                last_move_set_x_attempt(last_thread_success_move, ntohl(return_message.avatar_turn.Pos[thread_id].x) + 1); // move east
-                last_move_set_y_attempt(last_thread_success_move, ntohl(return_message.avatar_turn.Pos[thread_id].y));
+        // For each socket with a message ...
+        for (int e = 0; e < num_ready; e++)
+        {
+            avatar_session_t *session = &sessions[events[e].data.u32];
+
+            // Read the message, and throw an error if any problem in reading
+            AM_Message return_message;
+            memset(&return_message, 0, sizeof(return_message));
+            int bytesRead;
+            if ((bytesRead = read(session->sock, &return_message, sizeof(return_message))) < 0)
+            {
+                fprintf(stderr, "\tError reading from server\n");
+                exit(7);
             }
+            clock_gettime(CLOCK_MONOTONIC, &session->received);
 
-            // Temporary storage for the outcome of the move, to pass to the logging section. Values defined by const ints in header section of this file
-            previous_move_code = -1;
+            // The lock is never contended in this mode; it is taken so that the handlers run as they do in thread_avatar
+            lock_shared();
+            session_status_t status = SESSION_CONTINUE;
 
-            // Implicitly, the positive-branch of this if-statement executes only for a single thread (because on iteration zero, it is only one thread's turn)
-            if (iteration_count == 0)
+            // If the server closed the connection, no more messages will come
+            if (bytesRead == 0)
             {
+                fprintf(stderr, "\tThread #%d: Server closed the connection\n", session->thread_id);
+                status = SESSION_ERROR;
+            }
+
+            // If it is the copy of another avatar's turn, drop it
+            else if (ntohl(return_message.type) == AM_AVATAR_TURN && (int)ntohl(return_message.avatar_turn.TurnId) != session->thread_id)
+            {
+                session->iteration_count++;
+            }
 
-                // For each of the avatars, create an avatar, set its position based on the return message, and save it to the avatar_array
-                for (int i = 0; i < thread_initial_info_get_num_avatars(thread_info); i++)
+            // Otherwise, handle it; if it was this avatar's turn, the avatar after it decides ahead on the move just sent
+            else
+            {
+                status = avatar_session_handle(session, &return_message);
+                int next_id = (session->thread_id + 1) % num_avatars;
+                if (status == SESSION_CONTINUE && ntohl(return_message.type) == AM_AVATAR_TURN && num_avatars > 1 && running[next_id])
                 {
-                    avatar_t *avatar = avatar_new(i);
-                    int current_x = ntohl(return_message.avatar_turn.Pos[i].x);
-                    int current_y = ntohl(return_message.avatar_turn.Pos[i].y);
-                    position_t *position = position_new();
-                    position_setX(position, current_x);
-                    position_setY(position, current_y);
-                    avatar_setPosition(avatar, position);
-                    position_delete(position);
-                    avatar_array_add(avatar_array, avatar);
-                
+                    speculate_next_turn(sessions[next_id].thread_info, sessions[next_id].strategy_state,
+                        sessions[next_id].last_thread_success_move, session->thread_id,
+                        ntohl(return_message.avatar_turn.Pos[next_id].x), ntohl(return_message.avatar_turn.Pos[next_id].y));
                 }
-
             }
+            unlock_shared();
 
-            // Else, since it is not the first iteration ...
-            else
+            // DEBUG Setting: If the debug setting is on, and the number of cycles allowed has been reached, close the session
+            if (DEBUG_SWITCH_ITR == 1 && session->iteration_count == END_RUN_ITR)
             {
+                status = SESSION_SOLVED;
+            }
 
-                // Update the position of the prior avatar in the avatar array
-                int last_id = last_move_get_last_ID(SOT_last_move_global);
-                int current_x = ntohl(return_message.avatar_turn.Pos[last_id].x);
-                int current_y = ntohl(return_message.avatar_turn.Pos[last_id].y);
-                int attempted_x = last_move_get_x_attempt(SOT_last_move_global);
-                int attempted_y = last_move_get_y_attempt(SOT_last_move_global);
-                int initial_x = last_move_get_initial_x(SOT_last_move_global);
-                int initial_y = last_move_get_initial_y(SOT_last_move_global);
+            // Close the session once the maze is solved or an error is received
+            if (status != SESSION_CONTINUE)
+            {
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL, session->sock, NULL);
+                avatar_session_close(session);
+                running[session - sessions] = false;
+                num_running--;
+            }
+        }
+    }
 
+    close(epoll_fd);
+    return true;
+}
 
-                // If the prior move was successful ...
-                if (current_x == attempted_x && current_y == attempted_y)
-                {
+/**************** avatar_session_open ****************/
+/* Opens the session of the avatar of thread_info: connects to the server, sends the AM_AVATAR_READY message, and sets
+ * up the avatar's state for the move strategy selected at startup.
+ * Memory: on success, the session owns thread_info, and avatar_session_close frees it. On failure, nothing is kept.
+ * Return: true if the session is open, false otherwise
+ */
+bool avatar_session_open(avatar_session_t *session, thread_initial_info_t *thread_info)
+{
 
-                    // Record the previous_move_code for passing to logging
-                    previous_move_code = prev_move_path;
-
-                    // In the avatar array, update the position of the prior avatar
-                    position_setX(avatar_getPosition(avatar_array[last_id]), current_x);
-                    position_setY(avatar_getPosition(avatar_array[last_id]), current_y);
-
-                    // Wall-filler: this fills in traps identified by the previous thread.
-
-                    // For the cell that the prior avatar left, check the relationships to the neighboring cells and see how many are walled
-                    int wall_count = 0;
-                    if (map_isWallXY(thread_initial_info_get_SOT_shared_map(thread_info), initial_x + 1, initial_y, initial_x, initial_y)){wall_count++;}
-                    if (map_isWallXY(thread_initial_info_get_SOT_shared_map(thread_info), initial_x, initial_y + 1, initial_x, initial_y)){wall_count++;}
-                    if (map_isWallXY(thread_initial_info_get_SOT_shared_map(thread_info), initial_x - 1, initial_y, initial_x, initial_y)){wall_count++;}
-                    if (map_isWallXY(thread_initial_info_get_SOT_shared_map(thread_info), initial_x, initial_y - 1, initial_x, initial_y)){wall_count++;}
-                    
-                    // If the number of walls found is 3 or greater, a trap is found
-                    if (wall_count > 2) {
-                        if (avatar_array_find_avatar(thread_initial_info_get_SOT_avatar_array(thread_info), 
-                        thread_initial_info_get_num_avatars(thread_info), initial_x, initial_y) == -1) {
-                            
-                            // Set the wall
-                            map_setWallXY(thread_initial_info_get_SOT_shared_map(thread_info), initial_x, initial_y, current_x, current_y);
-
-                            // Update the previous_move_code for passing to logging
-                            previous_move_code = prev_move_path_fill;
-                       }
-                    }
+    /*** 1. Save Initial Variables ***/
 
-                }
+    // Save down the thread_initial_info, and pull out the thread_id for use
+    memset(session, 0, sizeof(*session));
+    session->thread_info = thread_info;
+    session->thread_id = thread_initial_info_get_threadID(thread_info);
+    session->strategy = thread_initial_info_get_strategy(thread_info);
 
-                // If the prior move was not successful ...
-                else if (current_x == initial_x && current_y == initial_y)
-                {
-                    // Prior avatar did not move, so the path it tried to explore is a wall. Set it.
-                    map_setWallXY(thread_initial_info_get_SOT_shared_map(thread_info), attempted_x, attempted_y, initial_x, initial_y);
+    /*** 2. Establish Server Connection ***/
 
-                    // Set code for logging
-                    previous_move_code = prev_move_wall;
+    // Create socket
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0)
+    {
+        fprintf(stderr, "error opening socket");
+        return false;
+    }
 
-                }
+    // Initialize fields
+    // create appropriate socket address struct
+    struct sockaddr_in servaddr;
+    servaddr.sin_family = AF_INET;
+    servaddr.sin_port = htons(thread_initial_info_get_mazePort(thread_info));
 
-                // Update last move for individual avatar (if succesful)
-                local_current_x = ntohl(return_message.avatar_turn.Pos[thread_id].x);
-                local_current_y = ntohl(return_message.avatar_turn.Pos[thread_id].y);
-                local_attempted_x = last_move_get_x_attempt(last_thread_success_move);
-                local_attempted_y = last_move_get_y_attempt(last_thread_success_move);
+    // create host struct, thereby validating given hostname
+    struct hostent *host = gethostbyname(thread_initial_info_get_hostName(thread_info)); // server hostname
+    if (host == NULL)
+    {
+        fprintf(stderr, "Error 5: unknown host\n");
+        close(sock);
+        return false;
+    }
+    memcpy(&servaddr.sin_addr, host->h_addr_list[0], host->h_length);
 
-                if (local_current_x == local_attempted_x && local_current_y == local_attempted_y)
-                {
-                    // successful move, update last succesful direction
-                    int last_dir = find_last_direction(last_thread_success_move);
-                    //printf("Thead ID %d, Calculated Last Direction:%d\n", thread_id, last_dir);
-                    last_move_set_last_success_dir(last_thread_success_move, last_dir);
-                }
-            }
+    // connect to server, checking success
+    if ((connect(sock, (struct sockaddr *)&servaddr, sizeof(servaddr))) < 0)
+    {
+        fprintf(stderr, "Error connecting to server\n");
+        close(sock);
+        return false;
+    }
+    session->sock = sock;
 
+    /*** 3. Send Client Ready Message to the Server ***/
 
-            /*** 3. Run decision algorithm to determine next move ***/
-            // Any changes to shared data structures which are made by the decision algorithm must be clearly documented
-            // Again, this is to help us ensure data structure consistency across threads and avoid horrible errors (e.g. race conditions, deadlock)
+    // Lock the write section
+    lock_shared();
 
-            int attempted_move = move_for_rhr(last_thread_success_move, thread_initial_info_get_SOT_shared_map(thread_info), local_current_x, local_current_y);
+    AM_Message ready_message;
+    memset(&ready_message, 0, sizeof(ready_message));
+    ready_message.type = htonl(AM_AVATAR_READY);
+    ready_message.avatar_ready.AvatarId = htonl(session->thread_id);
+    if ((write(sock, &ready_message, sizeof(ready_message))) < 0)
+    {
+        fprintf(stderr, "Error writing ready message to server\n");
+        unlock_shared();
+        close(sock);
+        return false;
+    }
+    printf("Thread #%d: Ready message sent to server \n", session->thread_id);
 
+    /*** 4. Set up this avatar's state for the move strategy selected at startup ***/
+    session->last_thread_success_move = last_move_new();
+    session->strategy_state = session->strategy->init(thread_initial_info_get_SOT_shared_map(thread_info), session->thread_id,
+        thread_initial_info_get_num_avatars(thread_info));
 
-            /*** 4. Create a move message to move the avatar in the direction returned by the decision algorithm. ***/
-            AM_Message move_message;
-            memset(&move_message, 0, sizeof(move_message));
-            move_message.type = htonl(AM_AVATAR_MOVE);
-            move_message.avatar_move.AvatarId = htonl(thread_id);
-            // Calculate next move for the avatar
-            move_message.avatar_move.Direction = htonl(attempted_move);
+    // Unlock the write section
+    unlock_shared();
+    return true;
+}
 
-            /*** 5. Update the SOT_last_move_global struct for the move requested in this iteration ***/
-            last_move_set_last_ID(SOT_last_move_global, thread_id);
+/**************** avatar_session_close ****************/
+/* Closes the session: tears down the avatar's strategy state, frees its thread_initial_info and last move, and closes
+ * its socket
+ */
+void avatar_session_close(avatar_session_t *session)
+{
+    session->strategy->teardown(session->strategy_state);
+    thread_initial_info_delete(session->thread_info);
+    last_move_delete(session->last_thread_success_move);
+    close(session->sock);
+}
 
-            last_move_set_initial_x(SOT_last_move_global, ntohl(return_message.avatar_turn.Pos[thread_id].x));
-            last_move_set_initial_y(SOT_last_move_global, ntohl(return_message.avatar_turn.Pos[thread_id].y));
+/**************** avatar_session_concerns ****************/
+/* Tells, from the message type and TurnId alone, whether avatar_session_handle would do anything with the message.
+ * It does nothing with an AM_AVATAR_TURN message unless the turn is this avatar's, or the turn of the avatar before
+ * it and the strategy decides ahead. Reads only the message and the session, so it is called without the lock.
+ * Return: false if the message can be dropped, true otherwise
+ */
+bool avatar_session_concerns(avatar_session_t *session, const AM_Message *message)
+{
+    if (ntohl(message->type) != AM_AVATAR_TURN)
+    {
+        return true;
+    }
+    int num_avatars = thread_initial_info_get_num_avatars(session->thread_info);
+    int turn_id = ntohl(message->avatar_turn.TurnId);
+    return turn_id == session->thread_id ||
+        (session->strategy->speculate && num_avatars > 1 && (turn_id + 1) % num_avatars == session->thread_id);
+}
 
-            last_move_set_initial_x(last_thread_success_move, ntohl(return_message.avatar_turn.Pos[thread_id].x));
-            last_move_set_initial_y(last_thread_success_move, ntohl(return_message.avatar_turn.Pos[thread_id].y));
+/**************** avatar_session_handle ****************/
+/* avatar_session_handle handles one message from the server to the avatar of the session. Called with the lock held,
+ * by thread_avatar or client_event_loop.
+ *
+ * The function does the following:
+ * - If the message is not an AM_AVATAR_TURN message, handles it appropriately
+ * - If the message is an AM_AVATAR_TURN message, and it is the avatar's turn, then
+ *    - Saves the impact of the message to all relevant data structures
+ *    - Runs decision algorithm to determine next move
+ *    - Calls print and logging
+ *    - Sends a move message to the server
+ * - If the message is an AM_AVATAR_TURN message for the avatar before this one, decides this avatar's next move ahead
+ *   (see speculate_next_turn)
+ * - If the message is any other AM_AVATAR_TURN message, takes no action
+ *
+ * Return:
+ *  - SESSION_SOLVED if the maze is solved, SESSION_ERROR if an error was received; the caller then closes the session
+ *  - SESSION_CONTINUE otherwise
+ */
+session_status_t avatar_session_handle(avatar_session_t *session, const AM_Message *message)
+{
+    // Pull out the session's variables for use
+    thread_initial_info_t *thread_info = session->thread_info;
+    int thread_id = session->thread_id;
+    int sock = session->sock;
+    const strategy_t *strategy = session->strategy;
+    void *strategy_state = session->strategy_state;
+    last_move_t *last_thread_success_move = session->last_thread_success_move;
+    int iteration_count = session->iteration_count;
 
-            // Based on direction, set the attempted x and y for both the global-scope (Scope 1) and the thread-scope (Scope 2) last-move structs
-            if (attempted_move == M_EAST)
-            {
+    // Declare local positional variables
+    int local_current_x;
+    int local_current_y;
+    int local_attempted_x;
+    int local_attempted_y;
 
-                last_move_set_x_attempt(SOT_last_move_global, ntohl(return_message.avatar_turn.Pos[thread_id].x) + 1);
-                last_move_set_y_attempt(SOT_last_move_global, ntohl(return_message.avatar_turn.Pos[thread_id].y));
+    /*** 1. Handle message types other than AM_AVATAR_TURN ***/
 
-                last_move_set_x_attempt(last_thread_success_move, ntohl(return_message.avatar_turn.Pos[thread_id].x) + 1);
-                last_move_set_y_attempt(last_thread_success_move, ntohl(return_message.avatar_turn.Pos[thread_id].y));
+    // Set up for updating the map, in case the game is solved on this turn
+    avatar_t **avatar_array = thread_initial_info_get_SOT_avatar_array(thread_info);
+    occupancy_t *occupancy = thread_initial_info_get_SOT_occupancy(thread_info);
+    last_move_t *SOT_last_move_global = thread_initial_info_get_SOT_last_move_global(thread_info);
+    int previous_move_code = -1;
 
-            }
-            else if (attempted_move == M_SOUTH)
+    // If the game is solved:
+    if (ntohl(message->type) == AM_MAZE_SOLVED)
+    {
+        // Only Thread 0 should write the solved message to the log
+        if (thread_id == 0)
+        {
+            if (iteration_count != 0) 
             {
+                
+                // *** Special case handling for the last move ***/
+                
+                // Pull out the values of the global last_move
+                int last_id = last_move_get_last_ID(SOT_last_move_global);
+                int attempted_x = last_move_get_x_attempt(SOT_last_move_global);
+                int attempted_y = last_move_get_y_attempt(SOT_last_move_global);
+                int initial_x = last_move_get_initial_x(SOT_last_move_global);
+                int initial_y = last_move_get_initial_y(SOT_last_move_global);
 
-                last_move_set_x_attempt(SOT_last_move_global, ntohl(return_message.avatar_turn.Pos[thread_id].x));
-                last_move_set_y_attempt(SOT_last_move_global, ntohl(return_message.avatar_turn.Pos[thread_id].y) + 1);
-
-                last_move_set_x_attempt(last_thread_success_move, ntohl(return_message.avatar_turn.Pos[thread_id].x));
-                last_move_set_y_attempt(last_thread_success_move, ntohl(return_message.avatar_turn.Pos[thread_id].y) + 1);
-
-            }
-            else if (attempted_move == M_WEST)
-            {
+                // Because the maze was solved, this move must have succeeded. Record the previous_move_code for passing to logging
+                previous_move_code = prev_move_path;
 
-                last_move_set_x_attempt(SOT_last_move_global, ntohl(return_message.avatar_turn.Pos[thread_id].x) - 1);
-                last_move_set_y_attempt(SOT_last_move_global, ntohl(return_message.avatar_turn.Pos[thread_id].y));
+                // In the avatar array, update the position of the prior avatar
+                position_setX(avatar_getPosition(avatar_array[last_id]), attempted_x);
+                position_setY(avatar_getPosition(avatar_array[last_id]), attempted_y);
+                occupancy_move(occupancy, last_id, attempted_x, attempted_y);
 
-                last_move_set_x_attempt(last_thread_success_move, ntohl(return_message.avatar_turn.Pos[thread_id].x) - 1);
-                last_move_set_y_attempt(last_thread_success_move, ntohl(return_message.avatar_turn.Pos[thread_id].y));
+                // Wall-filler: this fills in traps identified by the previous thread, and any corridor they close off.
+                if (map_fillDeadEnds(thread_initial_info_get_SOT_shared_map(thread_info), initial_x, initial_y, occupancy) > 0) {
 
+                    // Update the previous_move_code for passing to logging
+                    previous_move_code = prev_move_path_fill;
+                }
             }
-            else if (attempted_move == M_NORTH)
+
+            // Hand the final positions and the message to the recorder, to print and log
+            turn_record_t record;
+            memset(&record, 0, sizeof(record));
+            record.kind = RECORD_SOLVED;
+            record.num_avatars = thread_initial_info_get_num_avatars(thread_info);
+            for (int i = 0; i < record.num_avatars; i++)
             {
+                record.positions[i].x = avatar_getX(avatar_array[i]);
+                record.positions[i].y = avatar_getY(avatar_array[i]);
+            }
+            record.solved_avatars = ntohl(message->maze_solved.nAvatars);
+            record.solved_difficulty = ntohl(message->maze_solved.Difficulty);
+            record.solved_moves = ntohl(message->maze_solved.nMoves);
+            record.solved_hash = ntohl(message->maze_solved.Hash);
+            record.target.x = map_getTargetX(thread_initial_info_get_SOT_shared_map(thread_info));
+            record.target.y = map_getTargetY(thread_initial_info_get_SOT_shared_map(thread_info));
+            recorder_submit(thread_initial_info_get_SOT_recorder(thread_info), &record);
+        }
 
-                last_move_set_x_attempt(SOT_last_move_global, ntohl(return_message.avatar_turn.Pos[thread_id].x));
-                last_move_set_y_attempt(SOT_last_move_global, ntohl(return_message.avatar_turn.Pos[thread_id].y) - 1);
+        return SESSION_SOLVED;
+    }
 
-                last_move_set_x_attempt(last_thread_success_move, ntohl(return_message.avatar_turn.Pos[thread_id].x));
-                last_move_set_y_attempt(last_thread_success_move, ntohl(return_message.avatar_turn.Pos[thread_id].y) - 1);
+    // If an error message is detected:
+    if (IS_AM_ERROR(ntohl(message->type)))
+    {
 
-            }
+        // Hand the error to the recorder, to log and show on the screen
+        turn_record_t record;
+        memset(&record, 0, sizeof(record));
+        record.kind = RECORD_ERROR;
+        record.avatar_id = thread_id;
+        record.message_type = ntohl(message->type);
+        record.target.x = map_getTargetX(thread_initial_info_get_SOT_shared_map(thread_info));
+        record.target.y = map_getTargetY(thread_initial_info_get_SOT_shared_map(thread_info));
+        recorder_submit(thread_initial_info_get_SOT_recorder(thread_info), &record);
+
+        // The caller closes the session
+        return SESSION_ERROR;
+    }
 
-            /*** 5. Calls to PRINT and LOGGING ***/
-            // All calls to print and logging happen in this section (except for AM_MAZE_SOLVED). Any decisions made before which affect logging are constructed
-            // and passed to here for logging.
-            
-            // Clear the screen between prints
-            system("@cls||clear");
-
-            // Call the simpleprint module
-            print_map(
-                thread_initial_info_get_MazeHeight(thread_info),
-                thread_initial_info_get_MazeWidth(thread_info),
-                thread_initial_info_get_SOT_avatar_array(thread_info),
-                thread_initial_info_get_num_avatars(thread_info),
-                thread_initial_info_get_SOT_shared_map(thread_info));
-
-            // Logging
-
-            // Open the file
-            FILE *fp;
-            fp = fopen(thread_initial_info_get_log_file_name(thread_info), "a");
-            
-            // If an error is encountered opening the file, skip this log cycle; otherwise, log to file
-            if (fp != NULL) 
-            {
-                // Log the iteration number and turn ID:
-                fprintf(fp, "\n\nIteration: %d. It is avatar #%d's turn. Current positions by avatar: \n", iteration_count, thread_id);
+    /*** 2. Further execution of this message only if ... ***/
+
+    // If it is an AM_AVATAR_TURN message and it is this avatar's turn ...
+    if (ntohl(message->type) == AM_AVATAR_TURN && ntohl(message->avatar_turn.TurnId) == thread_id)
+    { 
+
+        /*** 1. Save the impact of the message to all relevant data structures ***/
+        // ALL CHANGES TO SHARED DATA STRUCTURES SHOULD OCCUR BETWEEN HERE -->
+        // Check if last move was succesful
+        // if succesful,
+        // - update last successful direction in thread_last_move
+        // - update the map
+        // - update the avatar_array
+
+
+        // If the last_thread_success_move has not been initialized beyond calling new (i.e., ID = -100), then initialize it
+        if (last_move_get_last_ID(last_thread_success_move) == -100) {
+
+            /**** Set local positional variables for the first run ***/
+            local_current_x = ntohl(message->avatar_turn.Pos[thread_id].x);
+            local_current_y = ntohl(message->avatar_turn.Pos[thread_id].y);
+            last_move_set_last_ID(last_thread_success_move, thread_id);
+            last_move_set_last_success_dir(last_thread_success_move, M_EAST);
+            last_move_set_initial_x(last_thread_success_move, ntohl(message->avatar_turn.Pos[thread_id].x)); // Initiates last successful move holder
+            last_move_set_initial_y(last_thread_success_move, ntohl(message->avatar_turn.Pos[thread_id].y));
+            last_move_set_x_attempt(last_thread_success_move, ntohl(message->avatar_turn.Pos[thread_id].x) + 1); // move east
+            last_move_set_y_attempt(last_thread_success_move, ntohl(message->avatar_turn.Pos[thread_id].y));
+        }
 
-                // Log the current position of each avatar:
-                for (int avatar_idx = 0; avatar_idx < thread_initial_info_get_num_avatars(thread_info); avatar_idx++)
-                {
-                    int log_current_x = ntohl(return_message.avatar_turn.Pos[avatar_idx].x);
-                    int log_current_y = ntohl(return_message.avatar_turn.Pos[avatar_idx].y);
-                    fprintf(fp, "\tAvatar ID: %d X: %d Y: %d \n", avatar_idx, log_current_x, log_current_y);
-                }
+        // Temporary storage for the outcome of the move, to pass to the logging section. Values defined by const ints in header section of this file
+        previous_move_code = -1;
 
-                // If it is not the first turn, then log the results of the prior turn, 
-                if (iteration_count != 0 ) { 
-                    
-                    fprintf(fp, "\tThe result of the previous turn is: ");
-                    if (previous_move_code == prev_move_wall) 
-                    {
-                        fprintf(fp, "Wall found.");
-                    } 
-                    else if (previous_move_code == prev_move_path) 
-                    {
-                        fprintf(fp, "Move successful.");
-                    } 
-                    else if (previous_move_code == prev_move_path_fill) 
-                    {
-                        fprintf(fp, "Move successful and wall filled behind.");
-                    }
-                } else {
-                    fprintf(fp, "\tFirst move, so no prior move to report.");
-                }
+        // The move to request, and whether it was decided ahead of this turn (see speculate_next_turn)
+        uint32_t attempted_move = M_NULL_MOVE;
+        bool speculated = false;
 
-                // Log the requested move
-                fprintf(fp, "\n\tAvatar #%d is now requesting to move ", thread_id);
-                if (attempted_move == M_EAST)
-                {
-                    fprintf(fp, "east.\n");
-                }
-                else if (attempted_move == M_SOUTH)
-                {
-                    fprintf(fp, "south.\n");
-                }
-                else if (attempted_move == M_WEST)
-                {
-                    fprintf(fp, "west.\n");
-                }
-                else if (attempted_move == M_NORTH)
-                {
-                    fprintf(fp, "north.\n");
-                }
+        // Implicitly, the positive-branch of this if-statement executes only for a single thread (because on iteration zero, it is only one thread's turn)
+        if (iteration_count == 0)
+        {
 
-                // Close the log file
-                fclose(fp);
+            // For each of the avatars, create an avatar, set its position based on the return message, and save it to the avatar_array
+            for (int i = 0; i < thread_initial_info_get_num_avatars(thread_info); i++)
+            {
+                avatar_t *avatar = avatar_new(i);
+                int current_x = ntohl(message->avatar_turn.Pos[i].x);
+                int current_y = ntohl(message->avatar_turn.Pos[i].y);
+                position_t *position = position_new();
+                position_setX(position, current_x);
+                position_setY(position, current_y);
+                avatar_setPosition(avatar, position);
+                position_delete(position);
+                avatar_array_add(avatar_array, avatar);
+                occupancy_move(occupancy, i, current_x, current_y);
+            
             }
 
+        }
 
-            /*** 6. Write message out to the server ***/
+        // Else, since it is not the first iteration ...
+        else
+        {
 
-            // Conduct the write and throw an error if any problem in writing
-            int bytesWritten;
-            if ((bytesWritten = write(sock, &move_message, sizeof(move_message))) < 0)
+            // Pull out the values of the global last_move, the prior avatar's move, and where it ended up
+            int last_id = last_move_get_last_ID(SOT_last_move_global);
+            int current_x = ntohl(message->avatar_turn.Pos[last_id].x);
+            int current_y = ntohl(message->avatar_turn.Pos[last_id].y);
+            speculate_key_t key = {thread_id, last_id,
+                last_move_get_initial_x(SOT_last_move_global), last_move_get_initial_y(SOT_last_move_global),
+                last_move_get_x_attempt(SOT_last_move_global), last_move_get_y_attempt(SOT_last_move_global)};
+
+            // Update local positional variables for this avatar
+            local_current_x = ntohl(message->avatar_turn.Pos[thread_id].x);
+            local_current_y = ntohl(message->avatar_turn.Pos[thread_id].y);
+            local_attempted_x = last_move_get_x_attempt(last_thread_success_move);
+            local_attempted_y = last_move_get_y_attempt(last_thread_success_move);
+
+            // If this avatar decided its move for this outcome while the prior move was in flight, take it: this copies
+            // the map, avatar array, convoy and rendezvous it decided on into the shared ones, and the turn is done
+            bool moved = (current_x == key.attempted_x && current_y == key.attempted_y);
+            bool blocked = (current_x == key.initial_x && current_y == key.initial_y);
+            speculated = (moved || blocked) && speculation_take(thread_initial_info_get_SOT_speculation(thread_info), key,
+                moved ? SPECULATE_MOVED : SPECULATE_BLOCKED,
+                thread_initial_info_get_SOT_shared_map(thread_info), avatar_array, occupancy, thread_initial_info_get_SOT_convoy(thread_info),
+                thread_initial_info_get_SOT_rendezvous(thread_info), &attempted_move, &previous_move_code);
+
+            if (!speculated)
             {
-                fprintf(stderr, "\tError sending move to server\n");
-                exit(7);
+                // Save the outcome of the prior move to the map and the avatar array
+                previous_move_code = apply_last_move(thread_initial_info_get_SOT_shared_map(thread_info), avatar_array, occupancy,
+                    SOT_last_move_global, current_x, current_y);
+
+                // Tell the strategy how this avatar's own last move turned out
+                strategy_observation_t observation = {
+                    last_move_get_initial_x(last_thread_success_move), last_move_get_initial_y(last_thread_success_move),
+                    local_attempted_x, local_attempted_y,
+                    local_current_x == local_attempted_x && local_current_y == local_attempted_y};
+                strategy->on_observation(strategy_state, thread_initial_info_get_SOT_shared_map(thread_info), observation);
             }
-
-            /*** 7. Handler for this iteration ends here ***/
-
         }
 
-        /*** 6. Exit lock ***/
-        pthread_mutex_unlock(&mutexReadAndWrite);
-
-        // Update the iteration count
-        iteration_count++;
 
-        // DEBUG Setting: If the debug setting is on, and the number of cycles allowed has been reached, exit the thread
-        if (DEBUG_SWITCH_ITR == 1)
+        /*** 3. Run decision algorithm to determine next move ***/
+        // Any changes to shared data structures which are made by the decision algorithm must be clearly documented
+        // Again, this is to help us ensure data structure consistency across threads and avoid horrible errors (e.g. race conditions, deadlock)
+        // A move decided ahead of the turn was decided by the same algorithm, on copies of the shared data structures
+        if (!speculated)
         {
-            if (iteration_count == END_RUN_ITR)
-            {
-                break;
-            }
+            attempted_move = decide_move(thread_info, strategy_state, thread_initial_info_get_SOT_shared_map(thread_info),
+                avatar_array, thread_initial_info_get_SOT_convoy(thread_info), thread_initial_info_get_SOT_rendezvous(thread_info),
+                local_current_x, local_current_y);
         }
 
-        /*** While loop iteration ends here ***/
-    }
 
-    // If execution exits the while loop, then free memory and exit.
-    thread_initial_info_delete(thread_info);
-    last_move_delete(last_thread_success_move);
-    return NULL; 
-    pthread_exit(0);
-}
+        /*** 4. Create a move message to move the avatar in the direction returned by the decision algorithm. ***/
+        AM_Message move_message;
+        memset(&move_message, 0, sizeof(move_message));
+        move_message.type = htonl(AM_AVATAR_MOVE);
+        move_message.avatar_move.AvatarId = htonl(thread_id);
+        // Calculate next move for the avatar
+        move_message.avatar_move.Direction = htonl(attempted_move);
 
-/**************** move_for_rhr ****************/
-/* Suggests next movement using right-hand method 
- * Given: previous location, current location, previous move 
- * Returns: uint32_t move type as defined in amazing.h 
- * 1. Checks if there's a difference between current position and last position
- *    i. if there's a difference, there's a wall between previous location and previous move 
- * 2. Suggests to go right unless previous move was right and no movement
- * 3. Suggests to go in another direction  
- */
-uint32_t move_for_rhr(last_move_t *last_move, map_t *amap, int current_x, int current_y)
-{
-    
-    // Check if avatar is at meeting point
-    if (avatar_at_point(current_x, current_y, map_getMazeWidth(amap))) {
-        return M_EAST; // stays at top right corner 
-    }
+        /*** 5. Update the SOT_last_move_global struct for the move requested in this iteration ***/
+        last_move_set_last_ID(SOT_last_move_global, thread_id);
 
-    // Depending on the direction of the last successful move, decide the next move in preference order according to the right hand rule
-    // for each direction considered, check whether there is a wall in that direction, and if not, return that as the direction to move next
+        last_move_set_initial_x(SOT_last_move_global, ntohl(message->avatar_turn.Pos[thread_id].x));
+        last_move_set_initial_y(SOT_last_move_global, ntohl(message->avatar_turn.Pos[thread_id].y));
 
-    // If the direction of the last successful move was west...
-    if (last_move_get_last_success_dir(last_move) == M_WEST)
-    {
-        if (!map_isWallXY(amap, current_x, current_y, current_x, current_y - 1))
-        {
-            return M_NORTH;
-        }
-        else if (!map_isWallXY(amap, current_x, current_y, current_x - 1, current_y)) 
-        {
-            return M_WEST;
-        }
-        else if (!map_isWallXY(amap, current_x, current_y, current_x, current_y + 1))
+        last_move_set_initial_x(last_thread_success_move, ntohl(message->avatar_turn.Pos[thread_id].x));
+        last_move_set_initial_y(last_thread_success_move, ntohl(message->avatar_turn.Pos[thread_id].y));
+
+        // Based on direction, set the attempted x and y for both the global-scope (Scope 1) and the thread-scope (Scope 2) last-move structs
+        if (attempted_move == M_EAST)
         {
-            return M_SOUTH;
+
+            last_move_set_x_attempt(SOT_last_move_global, ntohl(message->avatar_turn.Pos[thread_id].x) + 1);
+            last_move_set_y_attempt(SOT_last_move_global, ntohl(message->avatar_turn.Pos[thread_id].y));
+
+            last_move_set_x_attempt(last_thread_success_move, ntohl(message->avatar_turn.Pos[thread_id].x) + 1);
+            last_move_set_y_attempt(last_thread_success_move, ntohl(message->avatar_turn.Pos[thread_id].y));
+
         }
-        else
+        else if (attempted_move == M_SOUTH)
         {
-            return M_EAST;
-        }
-    }
 
-    // If the direction of the last successful move was north...
-    else if (last_move_get_last_success_dir(last_move) == M_NORTH)
-    {
-        if (!map_isWallXY(amap, current_x, current_y, current_x + 1, current_y))
-        {
-            return M_EAST;
+            last_move_set_x_attempt(SOT_last_move_global, ntohl(message->avatar_turn.Pos[thread_id].x));
+            last_move_set_y_attempt(SOT_last_move_global, ntohl(message->avatar_turn.Pos[thread_id].y) + 1);
+
+            last_move_set_x_attempt(last_thread_success_move, ntohl(message->avatar_turn.Pos[thread_id].x));
+            last_move_set_y_attempt(last_thread_success_move, ntohl(message->avatar_turn.Pos[thread_id].y) + 1);
+
         }
-        else if (!map_isWallXY(amap, current_x, current_y, current_x, current_y - 1))
+        else if (attempted_move == M_WEST)
         {
-            return M_NORTH;
-        }
 
-        else if (!map_isWallXY(amap, current_x, current_y, current_x - 1, current_y))
-        {
-            return M_WEST;
+            last_move_set_x_attempt(SOT_last_move_global, ntohl(message->avatar_turn.Pos[thread_id].x) - 1);
+            last_move_set_y_attempt(SOT_last_move_global, ntohl(message->avatar_turn.Pos[thread_id].y));
+
+            last_move_set_x_attempt(last_thread_success_move, ntohl(message->avatar_turn.Pos[thread_id].x) - 1);
+            last_move_set_y_attempt(last_thread_success_move, ntohl(message->avatar_turn.Pos[thread_id].y));
+
         }
-        else
+        else if (attempted_move == M_NORTH)
         {
-            return M_SOUTH;
-        }
-    }
 
-    // If the direction of the last successful move was east...
-    else if (last_move_get_last_success_dir(last_move) == M_EAST)
-    {
-        if (!map_isWallXY(amap, current_x, current_y, current_x, current_y + 1))
-        {
-            return M_SOUTH;
-        }
+            last_move_set_x_attempt(SOT_last_move_global, ntohl(message->avatar_turn.Pos[thread_id].x));
+            last_move_set_y_attempt(SOT_last_move_global, ntohl(message->avatar_turn.Pos[thread_id].y) - 1);
 
-        else if (!map_isWallXY(amap, current_x, current_y, current_x + 1, current_y))
-        {
-            return M_EAST;
-        }
+            last_move_set_x_attempt(last_thread_success_move, ntohl(message->avatar_turn.Pos[thread_id].x));
+            last_move_set_y_attempt(last_thread_success_move, ntohl(message->avatar_turn.Pos[thread_id].y) - 1);
 
-        else if (!map_isWallXY(amap, current_x, current_y, current_x, current_y - 1))
-        {
-            return M_NORTH;
         }
         else
         {
-            return M_WEST;
-        }
-    }
 
-    // If the direction of the last successful move was south...
-    else if (last_move_get_last_success_dir(last_move) == M_SOUTH)
-    {                                                                            
-        if (!map_isWallXY(amap, current_x, current_y, current_x - 1, current_y))
-        {
-            return M_WEST;
-        }
-        else if (!map_isWallXY(amap, current_x, current_y, current_x, current_y + 1)) 
-        {
-            return M_SOUTH;
+            // M_NULL_MOVE: the avatar stays where it is
+            last_move_set_x_attempt(SOT_last_move_global, ntohl(message->avatar_turn.Pos[thread_id].x));
+            last_move_set_y_attempt(SOT_last_move_global, ntohl(message->avatar_turn.Pos[thread_id].y));
+
+            last_move_set_x_attempt(last_thread_success_move, ntohl(message->avatar_turn.Pos[thread_id].x));
+            last_move_set_y_attempt(last_thread_success_move, ntohl(message->avatar_turn.Pos[thread_id].y));
+
         }
-        else if (!map_isWallXY(amap, current_x, current_y, current_x + 1, current_y))
+
+        // Wake the next avatar if it is waiting to decide ahead on this move; it runs once this iteration unlocks
+        pthread_cond_signal(&condMoveSent[(thread_id + 1) % thread_initial_info_get_num_avatars(thread_info)]);
+
+        /*** 6. Write message out to the server ***/
+
+        // Conduct the write and throw an error if any problem in writing
+        int bytesWritten;
+        if ((bytesWritten = write(sock, &move_message, sizeof(move_message))) < 0)
         {
-            return M_EAST;
+            fprintf(stderr, "\tError sending move to server\n");
+            exit(7);
         }
-        else
+
+        // Time the turn, from reading its message to sending the move
+        record_turn_latency(&session->received);
+
+        /*** 7. Hand the turn to the recorder, to PRINT and LOG ***/
+        // Printing and logging happen in the recorder's thread, once the move is sent, so the server never waits on them.
+        // Any decisions made before which affect logging are copied into the record.
+        turn_record_t record;
+        memset(&record, 0, sizeof(record));
+        record.kind = RECORD_TURN;
+        record.avatar_id = thread_id;
+        record.iteration = iteration_count;
+        record.num_avatars = thread_initial_info_get_num_avatars(thread_info);
+        for (int avatar_idx = 0; avatar_idx < record.num_avatars; avatar_idx++)
         {
-            return M_NORTH;
+            record.positions[avatar_idx].x = ntohl(message->avatar_turn.Pos[avatar_idx].x);
+            record.positions[avatar_idx].y = ntohl(message->avatar_turn.Pos[avatar_idx].y);
         }
+        record.outcome = previous_move_code;
+        record.move = attempted_move;
+        record.target.x = map_getTargetX(thread_initial_info_get_SOT_shared_map(thread_info));
+        record.target.y = map_getTargetY(thread_initial_info_get_SOT_shared_map(thread_info));
+        recorder_submit(thread_initial_info_get_SOT_recorder(thread_info), &record);
+
+        /*** 8. Handler for this iteration ends here ***/
+
     }
 
-    // Execution should not reach this point. Return -1 indicating error
-    return (uint32_t)(-1);
+    // If it is the turn of the avatar before this one, decide this avatar's next move while that move is in flight
+    else if (ntohl(message->type) == AM_AVATAR_TURN && thread_initial_info_get_num_avatars(thread_info) > 1 &&
+        (int)(ntohl(message->avatar_turn.TurnId) + 1) % thread_initial_info_get_num_avatars(thread_info) == thread_id)
+    {
+        speculate_next_turn(thread_info, strategy_state, last_thread_success_move, ntohl(message->avatar_turn.TurnId),
+            ntohl(message->avatar_turn.Pos[thread_id].x), ntohl(message->avatar_turn.Pos[thread_id].y));
+    }
+    // Update the iteration count
+    session->iteration_count++;
+    return SESSION_CONTINUE;
 }
 
 
@@ -839,18 +1061,294 @@ uint32_t find_last_direction(last_move_t *last_move)
 }
 
 /**************** avatar_at_point ****************/
-/* Finds if avatar is at a designated meeting point 
+/* Finds if avatar is at the meeting point
+ * @param: map_t *map: the shared map, whose target is the meeting point elected by the rendezvous module
  * @param: int current_x: avatar's current x position
  * @param: int current_y: avatar's current y position
- * @param: int maze_width: current maze's width 
- * @return: boolean if avatar is at designated meeting point (top right corner) 
- * Check if avatar is at: 
- * Y: 0
- * X: MAZE_WIDTH - 1 
+ * @return: boolean if avatar is at the meeting point
  */
-bool avatar_at_point(int current_x, int current_y, int maze_width) {
-    if ((current_x == maze_width - 1) && (current_y == 0)) {
+bool avatar_at_point(map_t *map, int current_x, int current_y) {
+    if ((current_x == map_getTargetX(map)) && (current_y == map_getTargetY(map))) {
         return true; 
     }
     return false; 
 }
+
+
+/**************** apply_last_move ****************/
+/* Saves the outcome of the last move, the one described by last_move, to the map and the avatar array: the mover ended
+ * up at (current_x, current_y). Records the open path or the wall it found, moves it in the avatar array and its
+ * occupancy, and fills any trap this closes off.
+ * @return: the code of the outcome for the log (prev_move_stay, prev_move_path, prev_move_path_fill or prev_move_wall),
+ *          or -1 if the mover ended up somewhere it did not start from or ask for
+ */
+int apply_last_move(map_t *map, avatar_t **avatar_array, occupancy_t *occupancy, last_move_t *last_move, int current_x, int current_y)
+{
+    int last_id = last_move_get_last_ID(last_move);
+    int attempted_x = last_move_get_x_attempt(last_move);
+    int attempted_y = last_move_get_y_attempt(last_move);
+    int initial_x = last_move_get_initial_x(last_move);
+    int initial_y = last_move_get_initial_y(last_move);
+    int move_code = -1;
+
+    // Edges inferred so far, to tell whether this update lets the map infer any more
+    int inferred_before = map_getInferredCount(map);
+
+    // If the prior avatar asked to stay where it was, there is nothing to learn from its move
+    if (attempted_x == initial_x && attempted_y == initial_y)
+    {
+        move_code = prev_move_stay;
+    }
+
+    // If the prior move was successful ...
+    else if (current_x == attempted_x && current_y == attempted_y)
+    {
+
+        // Record the move code for passing to logging
+        move_code = prev_move_path;
+
+        // In the avatar array, update the position of the prior avatar
+        position_setX(avatar_getPosition(avatar_array[last_id]), current_x);
+        position_setY(avatar_getPosition(avatar_array[last_id]), current_y);
+        occupancy_move(occupancy, last_id, current_x, current_y);
+
+        // The path the prior avatar took is open. Record it, so the map can infer walls from it
+        map_setOpenXY(map, initial_x, initial_y, attempted_x, attempted_y);
+
+        // Wall-filler: this fills in traps identified by the previous thread.
+
+        // If the cell that the prior avatar left is walled on three sides, it is a trap: seal it, along
+        // with every cell of the blind corridor that sealing it closes off
+        if (map_fillDeadEnds(map, initial_x, initial_y, occupancy) > 0) {
+
+            // Update the move code for passing to logging
+            move_code = prev_move_path_fill;
+        }
+
+    }
+
+    // If the prior move was not successful ...
+    else if (current_x == initial_x && current_y == initial_y)
+    {
+        // Prior avatar did not move, so the path it tried to explore is a wall. Set it.
+        map_setWallXY(map, attempted_x, attempted_y, initial_x, initial_y);
+
+        // The new wall may have closed off a blind corridor on the far side; seal all of it
+        map_fillDeadEnds(map, attempted_x, attempted_y, occupancy);
+
+        // Set code for logging
+        move_code = prev_move_wall;
+
+    }
+
+    // If the map inferred edges from this update, they may have left dead ends anywhere: seal them all
+    if (map_getInferredCount(map) != inferred_before) {
+        map_sweepDeadEnds(map, occupancy);
+    }
+
+    return move_code;
+}
+
+/**************** decide_move ****************/
+/* Runs the decision algorithm for the avatar of thread_info, at (current_x, current_y), on the given map, avatar array,
+ * convoy and rendezvous, which are either the shared ones or copies of them (see speculate_next_turn).
+ * Changes the convoy (merging avatars which have met, and its leaders), the map's target (and so its distance field),
+ * and what the rendezvous knows of its last election.
+ * @return: the move to request
+ */
+uint32_t decide_move(thread_initial_info_t *thread_info, void *strategy_state, map_t *map, avatar_t **avatar_array,
+    convoy_t *convoy, rendezvous_t *rendezvous, int current_x, int current_y)
+{
+    const strategy_t *strategy = thread_initial_info_get_strategy(thread_info);
+    int num_avatars = thread_initial_info_get_num_avatars(thread_info);
+    int thread_id = thread_initial_info_get_threadID(thread_info);
+
+    // Merge avatars which have met into groups. Changes the convoy
+    convoy_update(convoy, avatar_array, num_avatars);
+
+    // Re-elect the meeting point from the updated map and positions. Changes the map's target (and so its distance field)
+    rendezvous_update(rendezvous, map, avatar_array, num_avatars);
+
+    // If the strategy moves groups as convoys, a member of a group who is not at its head follows the group's
+    // leader. Anyone else, including the leader, walks towards the nearest avatar of another group the known map
+    // connects it to if the strategy pairs avatars, or failing that decides with the move strategy. Changes the
+    // convoy's leader
+    uint32_t attempted_move;
+    if ((!strategy->convoy || !convoy_follow(convoy, map, avatar_array, thread_id, &attempted_move)) &&
+        (!strategy->pairing || pairing_converge(thread_initial_info_get_SOT_pairing(thread_info), map, avatar_array,
+            num_avatars, convoy, thread_id, &attempted_move) == -1))
+    {
+        attempted_move = strategy->choose_move(strategy_state, map, avatar_array, num_avatars, thread_id, current_x, current_y);
+    }
+    return attempted_move;
+}
+
+/**************** speculate_next_turn ****************/
+/* Called by the avatar of thread_info on the turn of the avatar before it (mover_id), with the shared structures locked.
+ * Waits, for at most SPECULATE_WAIT_S seconds, until the mover has sent its move, and then decides this avatar's next
+ * move for each outcome of that move, on copies of the shared structures held by the shared speculation. The shared
+ * structures themselves are not changed; the turn takes the copies for the outcome the server reports.
+ * Only for strategies with speculate set, and only once this avatar has had a turn of its own.
+ */
+void speculate_next_turn(thread_initial_info_t *thread_info, void *strategy_state, last_move_t *last_thread_success_move,
+    int mover_id, int current_x, int current_y)
+{
+    const strategy_t *strategy = thread_initial_info_get_strategy(thread_info);
+    last_move_t *SOT_last_move_global = thread_initial_info_get_SOT_last_move_global(thread_info);
+    speculation_t *speculation = thread_initial_info_get_SOT_speculation(thread_info);
+    map_t *map = thread_initial_info_get_SOT_shared_map(thread_info);
+    if (!strategy->speculate || last_move_get_last_ID(last_thread_success_move) == -100)
+    {
+        return;
+    }
+
+    // Wait for the mover to send its move; this releases the lock meanwhile. If it never does, decide on the turn
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += SPECULATE_WAIT_S;
+    while (last_move_get_last_ID(SOT_last_move_global) != mover_id)
+    {
+        if (wait_shared(&condMoveSent[thread_initial_info_get_threadID(thread_info)], &deadline) != 0)
+        {
+            return;
+        }
+    }
+
+    // Key the speculation by the move in flight
+    speculate_key_t key = {thread_initial_info_get_threadID(thread_info), mover_id,
+        last_move_get_initial_x(SOT_last_move_global), last_move_get_initial_y(SOT_last_move_global),
+        last_move_get_x_attempt(SOT_last_move_global), last_move_get_y_attempt(SOT_last_move_global)};
+    speculation_begin(speculation, key);
+
+    // This avatar's own last move turned out the same whatever the mover's does: tell the strategy now
+    strategy_observation_t observation = {
+        last_move_get_initial_x(last_thread_success_move), last_move_get_initial_y(last_thread_success_move),
+        last_move_get_x_attempt(last_thread_success_move), last_move_get_y_attempt(last_thread_success_move),
+        current_x == last_move_get_x_attempt(last_thread_success_move) && current_y == last_move_get_y_attempt(last_thread_success_move)};
+    strategy->on_observation(strategy_state, map, observation);
+
+    // For each outcome, apply it to a copy of the shared structures, and decide on the copy. A null move only has one
+    bool stays = (key.attempted_x == key.initial_x && key.attempted_y == key.initial_y);
+    for (int outcome = 0; outcome < (stays ? 1 : SPECULATE_NUM_OUTCOMES); outcome++)
+    {
+        // An outcome which could not be loaded is left undecided, and its turn is decided as usual
+        if (!speculation_load(speculation, outcome, map, thread_initial_info_get_SOT_avatar_array(thread_info),
+            thread_initial_info_get_SOT_convoy(thread_info), thread_initial_info_get_SOT_rendezvous(thread_info)))
+        {
+            break;
+        }
+        map_t *outcome_map = speculation_getMap(speculation, outcome);
+        avatar_t **outcome_avatars = speculation_getAvatars(speculation, outcome);
+        occupancy_t *outcome_occupancy = speculation_getOccupancy(speculation, outcome);
+        int mover_x = (outcome == SPECULATE_MOVED) ? key.attempted_x : key.initial_x;
+        int mover_y = (outcome == SPECULATE_MOVED) ? key.attempted_y : key.initial_y;
+        int move_code = apply_last_move(outcome_map, outcome_avatars, outcome_occupancy, SOT_last_move_global, mover_x, mover_y);
+        uint32_t move = decide_move(thread_info, strategy_state, outcome_map, outcome_avatars,
+            speculation_getConvoy(speculation, outcome), speculation_getRendezvous(speculation, outcome), current_x, current_y);
+        speculation_setMove(speculation, outcome, move, move_code);
+    }
+}
+
+/**************** record_turn_latency ****************/
+/* Adds the turn whose message was read at received, and whose move was just sent, to turnLatency. Called with the lock held
+ */
+static void record_turn_latency(const struct timespec *received)
+{
+    struct timespec sent;
+    clock_gettime(CLOCK_MONOTONIC, &sent);
+    double ms = ms_between(received, &sent);
+    turnLatency.turns++;
+    turnLatency.total_ms += ms;
+    if (ms > turnLatency.longest_ms)
+    {
+        turnLatency.longest_ms = ms;
+    }
+}
+
+/**************** seconds_between ****************/
+/* Returns the seconds from start to end
+ */
+static double seconds_between(const struct timeval *start, const struct timeval *end)
+{
+    return (end->tv_sec - start->tv_sec) + (end->tv_usec - start->tv_usec) / 1e6;
+}
+
+/**************** ms_between ****************/
+/* Returns the milliseconds from start to end
+ */
+static double ms_between(const struct timespec *start, const struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) * 1e3 + (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+/**************** lock_shared ****************/
+/* Takes mutexReadAndWrite, and adds the time it took to lockStats
+ */
+static void lock_shared(void)
+{
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pthread_mutex_lock(&mutexReadAndWrite);
+    clock_gettime(CLOCK_MONOTONIC, &lockAcquired);
+    double ms = ms_between(&start, &lockAcquired);
+    lockStats.acquisitions++;
+    lockStats.wait_ms += ms;
+    if (ms > lockStats.longest_wait_ms)
+    {
+        lockStats.longest_wait_ms = ms;
+    }
+}
+
+/**************** unlock_shared ****************/
+/* Adds the time the lock was held, since lock_shared (or wait_shared) returned, to lockStats, and releases mutexReadAndWrite
+ */
+static void unlock_shared(void)
+{
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double ms = ms_between(&lockAcquired, &end);
+    lockStats.hold_ms += ms;
+    if (ms > lockStats.longest_hold_ms)
+    {
+        lockStats.longest_hold_ms = ms;
+    }
+    pthread_mutex_unlock(&mutexReadAndWrite);
+}
+
+/**************** wait_shared ****************/
+/* Waits on cond until deadline, as pthread_cond_timedwait, with mutexReadAndWrite held. The lock is released while
+ * waiting, so the wait counts neither as holding it nor as waiting to take it
+ */
+static int wait_shared(pthread_cond_t *cond, const struct timespec *deadline)
+{
+    struct timespec released;
+    clock_gettime(CLOCK_MONOTONIC, &released);
+    lockStats.hold_ms += ms_between(&lockAcquired, &released);
+    int return_value = pthread_cond_timedwait(cond, &mutexReadAndWrite, deadline);
+    clock_gettime(CLOCK_MONOTONIC, &lockAcquired);
+    return return_value;
+}
+
+/**************** request_frame ****************/
+/* The SIGUSR2 handler: asks the recorder for a frame, if the game is on
+ */
+static void request_frame(int signum)
+{
+    recorder_t *rc = frameRecorder;
+    if (rc != NULL)
+    {
+        recorder_request_frame(rc);
+    }
+}
+
+/**************** request_dump ****************/
+/* The SIGUSR1 handler: asks the recorder for a dump of the map, if the game is on
+ */
+static void request_dump(int signum)
+{
+    recorder_t *rc = frameRecorder;
+    if (rc != NULL)
+    {
+        recorder_request_dump(rc);
+    }
+}
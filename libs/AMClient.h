@@ -23,13 +23,36 @@
  * 
  */
 /* ========================================================================== */
+#include <time.h>
 #include "AMlib.h"
 #include "map.h"
 #include "AMlib_avatar.h"
 #include "simpleprint.h"
 
+/** The state one avatar keeps for the whole game, in either mode (see client_start)
+ */
+typedef struct avatar_session {
+    thread_initial_info_t *thread_info;     // The avatar's initial info; owned by the session
+    int thread_id;                          // The avatar's ID
+    int sock;                               // The avatar's connection to the server
+    const strategy_t *strategy;             // The move strategy selected at startup, and the avatar's state for it
+    void *strategy_state;
+    last_move_t *last_thread_success_move;  // The avatar's own last move (Scope 2)
+    int iteration_count;                    // Number of messages the avatar has read
+    struct timespec received;               // When the avatar's latest message was read, to time its turn
+} avatar_session_t;
+
+/** What to do with a session once it has handled a message
+ */
+typedef enum session_status {
+    SESSION_CONTINUE = 0,                   // Read the next message
+    SESSION_SOLVED = 1,                     // The maze is solved: close the session
+    SESSION_ERROR = 2                       // An error was received: close the session
+} session_status_t;
+
 /** Function: client_start
- * Initializes mutex locked common datastructures and spawns thread_avatar threads 
+ * Initializes mutex locked common datastructures and plays the avatars, from a thread_avatar thread each, or all
+ * from one thread with client_event_loop, as selected by the mode of cv
  * @creates 
  * @param class_variables_t of server initial maze info/message
  * @return bool if mazed solved 
@@ -44,6 +67,39 @@ bool client_start(class_variables_t *cv);
 */
 void *thread_avatar(void *avatar_args);
 
+/** Function: client_event_loop
+ * Plays every avatar from the calling thread: one epoll loop reads all of the avatars' sockets, and only the turn
+ * owner's copy of each turn is handled
+ * @param thread_infos: the initial info of each avatar, owned by its session from then on
+ * @return bool false if the avatars' sessions could not be set up
+ */
+bool client_event_loop(thread_initial_info_t **thread_infos, int num_avatars);
+
+/** Function: avatar_session_open
+ * Connects the avatar of thread_info to the server, sends its ready message, and sets up its strategy state
+ * @return bool true if the session is open; it then owns thread_info until avatar_session_close
+ */
+bool avatar_session_open(avatar_session_t *session, thread_initial_info_t *thread_info);
+
+/** Function: avatar_session_concerns
+ * Tells, from the message type and TurnId alone, whether avatar_session_handle would act on the message.
+ * Called without the lock.
+ * @return bool false if the message is a turn the avatar has nothing to do on, and can be dropped
+ */
+bool avatar_session_concerns(avatar_session_t *session, const AM_Message *message);
+
+/** Function: avatar_session_handle
+ * Handles one message from the server to the avatar of the session, playing its turn if it is one.
+ * Called with the lock held.
+ * @return session_status_t whether to read the next message, or close the session
+ */
+session_status_t avatar_session_handle(avatar_session_t *session, const AM_Message *message);
+
+/** Function: avatar_session_close
+ * Frees the avatar's state and closes its connection
+ */
+void avatar_session_close(avatar_session_t *session);
+
 /************************************************
  *  client_start() Local Helper Functions 
  ***********************************************/
@@ -62,16 +118,6 @@ void *thread_avatar(void *avatar_args);
  */
 // static void print_smessage(uint32_t raw_smsg)
 
-/* Suggests next movement using right-hand mehtod 
- * Given: previous location, current location, previous move 
- * Returns: uint32_t move type as defined in amazing.h 
- * 1. Checks if there's a difference between current position and last position
- *    i. if there's a difference, there's a wall between previous location and previous move 
- * 2. Suggests to go right unless previous move was right and no movement
- * 3. Suggests to go in another direction  
- */
-uint32_t move_for_rhr(last_move_t *last_move, map_t *amap, int current_x, int current_y);
-
 /* Given 2 positions, returns last direction as an interger based off of:
  *  West - 0
  *  North - 1
@@ -80,13 +126,32 @@ uint32_t move_for_rhr(last_move_t *last_move, map_t *amap, int current_x, int cu
  */
 uint32_t find_last_direction(last_move_t *last_move);
 
-/* Finds if avatar is at a designated meeting point
+/* Finds if avatar is at the meeting point
+ * @param: map_t *map: the shared map, whose target is the meeting point elected by the rendezvous module
  * @param: int current_x: avatar's current x position
  * @param: int current_y: avatar's current y position
- * @param: int maze_width: current maze's width
- * @return: boolean if avatar is at designated meeting point (top right corner)
- * Check if avatar is at:
- * Y: 0
- * X: MAZE_WIDTH - 1
+ * @return: boolean if avatar is at the meeting point
+ */
+bool avatar_at_point(map_t *map, int current_x, int current_y);
+
+/* Saves the outcome of the last move to the map and the avatar array: the mover ended up at (current_x, current_y)
+ * @param: map_t *map, avatar_t **avatar_array, occupancy_t *occupancy: the shared map, avatar array and its occupancy,
+ *         or copies of them
+ * @param: last_move_t *last_move: the last move requested, SOT_last_move_global
+ * @return: the code of the outcome for the log, or -1 if the mover is neither where it started nor where it asked to go
+ */
+int apply_last_move(map_t *map, avatar_t **avatar_array, occupancy_t *occupancy, last_move_t *last_move, int current_x, int current_y);
+
+/* Runs the decision algorithm for the avatar of thread_info at (current_x, current_y)
+ * @param: map, avatar_array, convoy: the shared structures, or copies of them; changed by the decision
+ * @param: rendezvous_t *rendezvous: scratch for electing the meeting point
+ * @return: the move to request
+ */
+uint32_t decide_move(thread_initial_info_t *thread_info, void *strategy_state, map_t *map, avatar_t **avatar_array,
+    convoy_t *convoy, rendezvous_t *rendezvous, int current_x, int current_y);
+
+/* Decides the next move of the avatar of thread_info for each outcome of the move of the avatar before it, mover_id,
+ * while that move is in flight. The avatar is at (current_x, current_y). Called with the shared structures locked.
  */
-bool avatar_at_point(int current_x, int current_y, int maze_width);
\ No newline at end of file
+void speculate_next_turn(thread_initial_info_t *thread_info, void *strategy_state, last_move_t *last_thread_success_move,
+    int mover_id, int current_x, int current_y);
\ No newline at end of file
@@ -29,6 +29,7 @@
 #include "AMlib.h"
 #include "AMlib_avatar.h"
 #include "map.h"
+#include "strategy.h"
 
 /**************** class_variables_struct ****************/
 typedef struct class_variables
@@ -40,10 +41,22 @@ typedef struct class_variables
     int mazeWidth;        // Provided by server
     int mazeHeight;       // Provided by server
     char *log_file_name;  // Constructed by this program
+    const strategy_t *strategy; // Provided by user, or the default
+    client_mode_t mode;   // Provided by user, or CLIENT_MODE_THREADS
+    log_format_t log_format; // Provided by user, or LOG_FORMAT_TEXT
+    int fps;              // Provided by user, or RECORDER_DEFAULT_FPS
+    int view_follow;      // Provided by user, or RENDER_FOLLOW_NONE
+    int overview_block;   // Provided by user, or 1
 } class_variables_t;
 
 /**************** class_variables_new ****************/
 /* Allocates memory for a class_variables struct, and writes the inputs into the struct 
+ * The move strategy starts as strategy_default(), until set with class_variables_set_strategy,
+ * the mode CLIENT_MODE_THREADS, until set with class_variables_set_mode, the log format
+ * LOG_FORMAT_TEXT, until set with class_variables_set_log_format, the frame rate
+ * RECORDER_DEFAULT_FPS, until set with class_variables_set_fps, and the frames show the whole
+ * maze, following nothing (RENDER_FOLLOW_NONE) in cells (a block of 1), until set with
+ * class_variables_set_view_follow and class_variables_set_overview_block
  * Memory: allocates memory for the struct. Caller is responsible for calling class_variables_delete
  * to delete the struct
  */
@@ -55,6 +68,12 @@ class_variables_t *class_variables_new(int num_avatars, int difficulty_level, co
     new_class_variables->difficulty_level = difficulty_level;
     new_class_variables->hostname = hostname;
     new_class_variables->log_file_name = NULL;
+    new_class_variables->strategy = strategy_default();
+    new_class_variables->mode = CLIENT_MODE_THREADS;
+    new_class_variables->log_format = LOG_FORMAT_TEXT;
+    new_class_variables->fps = RECORDER_DEFAULT_FPS;
+    new_class_variables->view_follow = RENDER_FOLLOW_NONE;
+    new_class_variables->overview_block = 1;
 
     return (new_class_variables);
 }
@@ -138,6 +157,66 @@ void class_variables_set_log_file_name(class_variables_t *cv, char *name)
     cv->log_file_name = name;
 }
 
+const strategy_t *class_variables_get_strategy(class_variables_t *cv)
+{
+    return cv->strategy;
+}
+
+void class_variables_set_strategy(class_variables_t *cv, const strategy_t *strategy)
+{
+    cv->strategy = strategy;
+}
+
+client_mode_t class_variables_get_mode(class_variables_t *cv)
+{
+    return cv->mode;
+}
+
+void class_variables_set_mode(class_variables_t *cv, client_mode_t mode)
+{
+    cv->mode = mode;
+}
+
+log_format_t class_variables_get_log_format(class_variables_t *cv)
+{
+    return cv->log_format;
+}
+
+void class_variables_set_log_format(class_variables_t *cv, log_format_t format)
+{
+    cv->log_format = format;
+}
+
+int class_variables_get_fps(class_variables_t *cv)
+{
+    return cv->fps;
+}
+
+void class_variables_set_fps(class_variables_t *cv, int fps)
+{
+    cv->fps = fps;
+}
+
+int class_variables_get_view_follow(class_variables_t *cv)
+{
+    return cv->view_follow;
+}
+
+void class_variables_set_view_follow(class_variables_t *cv, int follow)
+{
+    cv->view_follow = follow;
+}
+
+int class_variables_get_overview_block(class_variables_t *cv)
+{
+    return cv->overview_block;
+}
+
+void class_variables_set_overview_block(class_variables_t *cv, int block)
+{
+    cv->overview_block = block;
+}
+
 void class_variables_set_hostname(class_variables_t *cv, const char *hostname)
 {
     cv->hostname = hostname;
@@ -162,7 +241,14 @@ typedef struct thread_initial_info
     map_t *SOT_shared_map;              // Constructed by this program
     last_move_t *SOT_last_move_global;  // Constructed by this program
     avatar_t **SOT_avatar_array;        // Constructed by this program
+    occupancy_t *SOT_occupancy;         // Constructed by this program
+    rendezvous_t *SOT_rendezvous;       // Constructed by this program
+    convoy_t *SOT_convoy;               // Constructed by this program
+    pairing_t *SOT_pairing;             // Constructed by this program
+    speculation_t *SOT_speculation;     // Constructed by this program
+    recorder_t *SOT_recorder;           // Constructed by this program
     int threadID;                       // Constructed by this program
+    const strategy_t *strategy;         // Provided by user, or the default
 
 } thread_initial_info_t;
 
@@ -185,9 +271,16 @@ thread_initial_info_t *thread_initial_info_new(class_variables_t *class_v, int i
     new_initial->mazeHeight = class_v->mazeHeight;             // Provided by server
     new_initial->log_file_name = class_v->log_file_name;       // Constructed by this program
     new_initial->threadID = id;                                // Constructed by this program
+    new_initial->strategy = class_v->strategy;                 // Provided by user, or the default
     new_initial->SOT_shared_map = NULL;                        // Constructed by this program
     new_initial->SOT_last_move_global = NULL;                  // Constructed by this program
     new_initial->SOT_avatar_array = NULL;                      // Constructed by this program
+    new_initial->SOT_occupancy = NULL;                         // Constructed by this program
+    new_initial->SOT_rendezvous = NULL;                        // Constructed by this program
+    new_initial->SOT_convoy = NULL;                            // Constructed by this program
+    new_initial->SOT_pairing = NULL;                           // Constructed by this program
+    new_initial->SOT_speculation = NULL;                       // Constructed by this program
+    new_initial->SOT_recorder = NULL;                          // Constructed by this program
     return new_initial;
 }
 
@@ -231,6 +324,66 @@ avatar_t **thread_initial_info_get_SOT_avatar_array(thread_initial_info_t *tii)
     return tii->SOT_avatar_array;
 }
 
+void thread_initial_info_set_SOT_occupancy(thread_initial_info_t *tii, occupancy_t *occupancy)
+{
+    tii->SOT_occupancy = occupancy;
+}
+
+occupancy_t *thread_initial_info_get_SOT_occupancy(thread_initial_info_t *tii)
+{
+    return tii->SOT_occupancy;
+}
+
+void thread_initial_info_set_SOT_rendezvous(thread_initial_info_t *tii, rendezvous_t *rendezvous)
+{
+    tii->SOT_rendezvous = rendezvous;
+}
+
+rendezvous_t *thread_initial_info_get_SOT_rendezvous(thread_initial_info_t *tii)
+{
+    return tii->SOT_rendezvous;
+}
+
+void thread_initial_info_set_SOT_convoy(thread_initial_info_t *tii, convoy_t *convoy)
+{
+    tii->SOT_convoy = convoy;
+}
+
+convoy_t *thread_initial_info_get_SOT_convoy(thread_initial_info_t *tii)
+{
+    return tii->SOT_convoy;
+}
+
+void thread_initial_info_set_SOT_pairing(thread_initial_info_t *tii, pairing_t *pairing)
+{
+    tii->SOT_pairing = pairing;
+}
+
+pairing_t *thread_initial_info_get_SOT_pairing(thread_initial_info_t *tii)
+{
+    return tii->SOT_pairing;
+}
+
+void thread_initial_info_set_SOT_speculation(thread_initial_info_t *tii, speculation_t *speculation)
+{
+    tii->SOT_speculation = speculation;
+}
+
+speculation_t *thread_initial_info_get_SOT_speculation(thread_initial_info_t *tii)
+{
+    return tii->SOT_speculation;
+}
+
+void thread_initial_info_set_SOT_recorder(thread_initial_info_t *tii, recorder_t *recorder)
+{
+    tii->SOT_recorder = recorder;
+}
+
+recorder_t *thread_initial_info_get_SOT_recorder(thread_initial_info_t *tii)
+{
+    return tii->SOT_recorder;
+}
+
 int thread_initial_info_get_mazePort(thread_initial_info_t *tii)
 {
     return tii->mazePort;
@@ -267,6 +420,10 @@ int thread_initial_info_get_MazeHeight(thread_initial_info_t *tii)
 {
     return tii->mazeHeight;
 }
+const strategy_t *thread_initial_info_get_strategy(thread_initial_info_t *tii)
+{
+    return tii->strategy;
+}
 
 void thread_initial_info_set_mazePort(thread_initial_info_t *tii, int mazePort)
 {
@@ -304,6 +461,10 @@ void thread_initial_info_set_MazeHeight(thread_initial_info_t *tii, int mazeHeig
 {
     tii->mazeHeight = mazeHeight;
 }
+void thread_initial_info_set_strategy(thread_initial_info_t *tii, const strategy_t *strategy)
+{
+    tii->strategy = strategy;
+}
 
 /**************** last_move struct ****************/
 /* struct which holds the last attempted move by an avatar 
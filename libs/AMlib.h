@@ -20,6 +20,8 @@
  * is to the same data as the original allocation
  */
 /* ========================================================================== */
+#ifndef __AMLIB_H
+#define __AMLIB_H
 
 // Import C Standard libraries
 #include <stdlib.h>
@@ -31,16 +33,35 @@
 #include "amazing.h"
 #include "AMlib_avatar.h"
 #include "map.h"
+#include "strategy.h"
+#include "rendezvous.h"
+#include "convoy.h"
+#include "pairing.h"
+#include "speculate.h"
+#include "recorder.h"
+#include "render.h"
 
 /*** Structures Exported *********************************************************************************************************/
 typedef struct class_variables class_variables_t;
 typedef struct thread_initial_info thread_initial_info_t;
 typedef struct last_move last_move_t;
 
+// How the client runs the avatars (see client_start)
+typedef enum client_mode {
+    CLIENT_MODE_THREADS = 0,    // One thread per avatar, each reading its own socket
+    CLIENT_MODE_EPOLL = 1       // One thread, reading every avatar's socket through epoll
+} client_mode_t;
+
 /*** Functions for class_variables ***********************************************************************************************/
 
 /**************** class_variables_new ****************/
 /* Allocates memory for a class_variables struct, and writes the inputs into the struct 
+ * The move strategy starts as strategy_default(), until set with class_variables_set_strategy,
+ * the mode CLIENT_MODE_THREADS, until set with class_variables_set_mode, the log format
+ * LOG_FORMAT_TEXT, until set with class_variables_set_log_format, the frame rate
+ * RECORDER_DEFAULT_FPS, until set with class_variables_set_fps, and the frames show the whole
+ * maze, following nothing (RENDER_FOLLOW_NONE) in cells (a block of 1), until set with
+ * class_variables_set_view_follow and class_variables_set_overview_block
  * Memory: allocates memory for the struct. Caller is responsible for calling class_variables_delete
  * to delete the struct
  */
@@ -64,6 +85,12 @@ const char *class_variables_get_hostname(class_variables_t *cv);
 int class_variables_get_difficulty(class_variables_t *cv);
 int class_variables_get_mazePort(class_variables_t *cv);
 const char *class_variables_get_log_file_name(class_variables_t *cv);
+const strategy_t *class_variables_get_strategy(class_variables_t *cv);
+client_mode_t class_variables_get_mode(class_variables_t *cv);
+log_format_t class_variables_get_log_format(class_variables_t *cv);
+int class_variables_get_fps(class_variables_t *cv);
+int class_variables_get_view_follow(class_variables_t *cv);
+int class_variables_get_overview_block(class_variables_t *cv);
 void class_variables_set_MazeWidth(class_variables_t *cv, int MazeWidth);
 void class_variables_set_MazeHeight(class_variables_t *cv, int MazeHeight);
 void class_variables_set_num_avatars(class_variables_t *cv, int num_avatars);
@@ -71,6 +98,12 @@ void class_variables_set_difficulty(class_variables_t *cv, int difficulty);
 void class_variables_set_hostname(class_variables_t *cv, const char *hostname);
 void class_variables_set_mazePort(class_variables_t *cv, int mazePort);
 void class_variables_set_log_file_name(class_variables_t *cv, char *name);
+void class_variables_set_strategy(class_variables_t *cv, const strategy_t *strategy);
+void class_variables_set_mode(class_variables_t *cv, client_mode_t mode);
+void class_variables_set_log_format(class_variables_t *cv, log_format_t format);
+void class_variables_set_fps(class_variables_t *cv, int fps);
+void class_variables_set_view_follow(class_variables_t *cv, int follow);
+void class_variables_set_overview_block(class_variables_t *cv, int block);
 
 /*** Functions for thread_initial_info ******************************************************************************************/
 
@@ -102,6 +135,7 @@ int thread_initial_info_get_num_avatars(thread_initial_info_t *tii);
 int thread_initial_info_get_difficulty(thread_initial_info_t *tii);
 int thread_initial_info_get_MazeWidth(thread_initial_info_t *tii);
 int thread_initial_info_get_MazeHeight(thread_initial_info_t *tii);
+const strategy_t *thread_initial_info_get_strategy(thread_initial_info_t *tii);
 void thread_initial_info_set_mazePort(thread_initial_info_t *tii, int mazePort);
 void thread_initial_info_set_hostName(thread_initial_info_t *tii, char *hostname);
 void thread_initial_info_set_threadID(thread_initial_info_t *tii, int threadID);
@@ -110,12 +144,25 @@ void thread_initial_info_set_num_avatars(thread_initial_info_t *tii, int num_ava
 void thread_initial_info_set_difficulty(thread_initial_info_t *tii, int difficulty);
 void thread_initial_info_set_MazeWidth(thread_initial_info_t *tii, int mazeWidth);
 void thread_initial_info_set_MazeHeight(thread_initial_info_t *tii, int mazeHeight);
+void thread_initial_info_set_strategy(thread_initial_info_t *tii, const strategy_t *strategy);
 void thread_initial_info_set_SOT_shared_map(thread_initial_info_t *tii, map_t *mp);
 map_t *thread_initial_info_get_SOT_shared_map(thread_initial_info_t *tii);
 void thread_initial_info_set_SOT_last_move_global(thread_initial_info_t *tii, last_move_t *SOT_last_move_global);
 last_move_t *thread_initial_info_get_SOT_last_move_global(thread_initial_info_t *tii);
 void thread_initial_info_set_SOT_avatar_array(thread_initial_info_t *tii, avatar_t **avatar_array);
 avatar_t **thread_initial_info_get_SOT_avatar_array(thread_initial_info_t *tii);
+void thread_initial_info_set_SOT_occupancy(thread_initial_info_t *tii, occupancy_t *occupancy);
+occupancy_t *thread_initial_info_get_SOT_occupancy(thread_initial_info_t *tii);
+void thread_initial_info_set_SOT_rendezvous(thread_initial_info_t *tii, rendezvous_t *rendezvous);
+rendezvous_t *thread_initial_info_get_SOT_rendezvous(thread_initial_info_t *tii);
+void thread_initial_info_set_SOT_convoy(thread_initial_info_t *tii, convoy_t *convoy);
+convoy_t *thread_initial_info_get_SOT_convoy(thread_initial_info_t *tii);
+void thread_initial_info_set_SOT_pairing(thread_initial_info_t *tii, pairing_t *pairing);
+pairing_t *thread_initial_info_get_SOT_pairing(thread_initial_info_t *tii);
+void thread_initial_info_set_SOT_speculation(thread_initial_info_t *tii, speculation_t *speculation);
+speculation_t *thread_initial_info_get_SOT_speculation(thread_initial_info_t *tii);
+void thread_initial_info_set_SOT_recorder(thread_initial_info_t *tii, recorder_t *recorder);
+recorder_t *thread_initial_info_get_SOT_recorder(thread_initial_info_t *tii);
 
 /*** Functions for last_move *****************************************************************************************************/
 
@@ -146,3 +193,5 @@ void last_move_set_x_attempt(last_move_t *last_move, int x_attempt);
 void last_move_set_y_attempt(last_move_t *last_move, int y_attempt);
 void last_move_set_last_ID(last_move_t *last_move, int last_ID);
 void last_move_set_last_success_dir(last_move_t *last_move, int last_dir);
+
+#endif // __AMLIB_H
@@ -12,7 +12,8 @@
  * 
  * Description:     AMlib_avatar provides a library of structs relating to the notion
  *                  of an avatar. It provides position, avatar, and avatar_array structs
- *                  as well as their new, delete, getter, and setter functions.
+ *                  as well as their new, delete, getter, and setter functions, and the
+ *                  occupancy struct, which indexes an avatar array by cell.
  * 
  */
 /* ========================================================================== */
@@ -21,10 +22,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
 
 // Import project-specific libraries
 #include "amazing.h"
 
+// Every avatar has a bit of its own in an occupancy cell
+_Static_assert(AM_MAX_AVATAR <= 16, "occupancy cells hold a bit for each avatar in 16 bits");
+
 
 /**************** position struct ****************/
 typedef struct position {
@@ -44,6 +50,16 @@ typedef struct avatar_array {
     int num_avatars;
 } avatar_array_t;
 
+/**************** occupancy struct ****************/
+typedef struct occupancy {
+    int mazeWidth;
+    int mazeHeight;
+    int num_avatars;
+    uint16_t *cells;    // For each cell, y * mazeWidth + x, a bit for each avatar on it: avatar i is bit i
+    int *x;             // Where each avatar is, as placed; -1 if not on the maze
+    int *y;
+} occupancy_t;
+
 /*** position *******************************************************************************************************/
 
 /**************** position_new ****************/
@@ -230,4 +246,113 @@ int avatar_array_find_avatar(avatar_t **avatar_array, int num_avatar, int x, int
   }
   
   return -1;
-}
\ No newline at end of file
+}
+
+/*** occupancy ******************************************************************************************************/
+
+/**************** occupancy_new ****************/
+/* Initializes and returns a new occupancy of a mazeWidth x mazeHeight maze for num_avatars, with no avatar placed.
+ * Memory: allocates fresh memory for this structure. Caller must call occupancy_delete to free the memory
+ * associated with this structure
+ */
+occupancy_t *occupancy_new(int mazeWidth, int mazeHeight, int num_avatars)
+{
+  occupancy_t *occ = malloc(sizeof(occupancy_t));
+  if (occ == NULL) {
+    fprintf(stderr, "occupancy_new failed to allocate memory.\n");
+    exit(5);
+  }
+  occ->mazeWidth = mazeWidth;
+  occ->mazeHeight = mazeHeight;
+  occ->num_avatars = num_avatars;
+  occ->cells = calloc((size_t)mazeWidth * mazeHeight, sizeof(uint16_t));
+  occ->x = malloc(sizeof(int) * num_avatars);
+  occ->y = malloc(sizeof(int) * num_avatars);
+  if (occ->cells == NULL || occ->x == NULL || occ->y == NULL) {
+    fprintf(stderr, "occupancy_new failed to allocate memory.\n");
+    exit(5);
+  }
+  for (int i = 0; i < num_avatars; i++) {
+    occ->x[i] = -1;
+    occ->y[i] = -1;
+  }
+  return occ;
+}
+
+/**************** occupancy_delete ****************/
+/* Memory: frees the memory associated with the occupancy. The avatars it indexes are not touched
+ */
+bool occupancy_delete(occupancy_t *occ)
+{
+  if (occ == NULL) {
+    return false;
+  }
+  free(occ->cells);
+  free(occ->x);
+  free(occ->y);
+  free(occ);
+  return true;
+}
+
+/**************** occupancy_move ****************/
+/* Takes avatar_ID off the cell it was placed on, if any, and places it on (x, y). An (x, y) off the maze
+ * leaves it on no cell
+ */
+void occupancy_move(occupancy_t *occ, int avatar_ID, int x, int y)
+{
+  if (avatar_ID < 0 || avatar_ID >= occ->num_avatars) {
+    return;
+  }
+
+  // Take the avatar off its old cell
+  uint16_t bit = (uint16_t)(1u << avatar_ID);
+  if (occ->x[avatar_ID] >= 0) {
+    occ->cells[occ->y[avatar_ID] * occ->mazeWidth + occ->x[avatar_ID]] &= (uint16_t)~bit;
+  }
+
+  // And put it on the new one, if there is one
+  if (x >= 0 && x < occ->mazeWidth && y >= 0 && y < occ->mazeHeight) {
+    occ->cells[y * occ->mazeWidth + x] |= bit;
+    occ->x[avatar_ID] = x;
+    occ->y[avatar_ID] = y;
+  } else {
+    occ->x[avatar_ID] = -1;
+    occ->y[avatar_ID] = -1;
+  }
+}
+
+/**************** occupancy_sync ****************/
+/* Places every avatar in avatar_array where the array has it, so the occupancy indexes the array again after
+ * positions were changed without it. Takes time in the number of avatars only
+ */
+void occupancy_sync(occupancy_t *occ, avatar_t **avatar_array)
+{
+  for (int i = 0; i < occ->num_avatars; i++) {
+    if (avatar_array[i] != NULL) {
+      occupancy_move(occ, i, avatar_getX(avatar_array[i]), avatar_getY(avatar_array[i]));
+    }
+  }
+}
+
+/**************** occupancy_find_avatar ****************/
+/* Returns the lowest-numbered avatar placed on (x, y), or -1 if there is none or (x, y) is off the maze
+ */
+int occupancy_find_avatar(occupancy_t *occ, int x, int y)
+{
+  if (x < 0 || x >= occ->mazeWidth || y < 0 || y >= occ->mazeHeight) {
+    return -1;
+  }
+  unsigned int here = occ->cells[y * occ->mazeWidth + x];
+  return (here == 0) ? -1 : __builtin_ctz(here);
+}
+
+/**************** occupancy_count ****************/
+/* Returns the number of avatars placed on (x, y); 0 if (x, y) is off the maze
+ */
+int occupancy_count(occupancy_t *occ, int x, int y)
+{
+  if (x < 0 || x >= occ->mazeWidth || y < 0 || y >= occ->mazeHeight) {
+    return 0;
+  }
+  return __builtin_popcount(occ->cells[y * occ->mazeWidth + x]);
+}
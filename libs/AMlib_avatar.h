@@ -12,6 +12,10 @@
  *   * position
  *   * avatar
  *   * avatar_array
+ *   * occupancy: for each cell of the maze, the avatars on it, so that who is on a cell, and how
+ *     many, take one lookup rather than a scan of the avatar array. It is kept alongside an
+ *     avatar array, and must be told of every move with occupancy_move (or occupancy_sync).
+ *     It takes two bytes a cell, a bit for each avatar.
  * 
  * STATUS: position and avatar are implemented. Avatar_array is to be implemented
  */
@@ -30,6 +34,7 @@
 typedef struct position position_t;
 typedef struct avatar avatar_t;
 typedef struct avatar_array avatar_array_t;
+typedef struct occupancy occupancy_t;
 
 // *********************************** position **************************************
 
@@ -112,3 +117,39 @@ bool avatar_array_add(avatar_t **avatar_array, avatar_t *av);
  */
 int avatar_array_find_avatar(avatar_t **avatar_array, int num_avatar, int x, int y);
 
+// *********************************** occupancy **************************************
+
+/**************** occupancy_new ****************/
+/* Initializes and returns a new occupancy of a mazeWidth x mazeHeight maze for num_avatars, with no avatar placed.
+ * Memory: allocates fresh memory for this structure. Caller must call occupancy_delete to free the memory
+ * associated with this structure
+ */
+occupancy_t *occupancy_new(int mazeWidth, int mazeHeight, int num_avatars);
+
+/**************** occupancy_delete ****************/
+/* Memory: frees the memory associated with the occupancy. The avatars it indexes are not touched
+ */
+bool occupancy_delete(occupancy_t *occ);
+
+/**************** occupancy_move ****************/
+/* Takes avatar_ID off the cell it was placed on, if any, and places it on (x, y). An (x, y) off the maze
+ * leaves it on no cell
+ */
+void occupancy_move(occupancy_t *occ, int avatar_ID, int x, int y);
+
+/**************** occupancy_sync ****************/
+/* Places every avatar in avatar_array where the array has it, so the occupancy indexes the array again after
+ * positions were changed without it. Takes time in the number of avatars only
+ */
+void occupancy_sync(occupancy_t *occ, avatar_t **avatar_array);
+
+/**************** occupancy_find_avatar ****************/
+/* Returns the lowest-numbered avatar placed on (x, y), or -1 if there is none or (x, y) is off the maze.
+ * The same as avatar_array_find_avatar on the array the occupancy indexes, in one lookup
+ */
+int occupancy_find_avatar(occupancy_t *occ, int x, int y);
+
+/**************** occupancy_count ****************/
+/* Returns the number of avatars placed on (x, y); 0 if (x, y) is off the maze
+ */
+int occupancy_count(occupancy_t *occ, int x, int y);
@@ -0,0 +1,243 @@
+/* ========================================================================== */
+/* File: convoy.c
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Andrw Yang, Maria Roodnitsky, Siddharth Agrawal, Alexander Hirsch
+ * Component name:  convoy
+ *
+ * Date Created:    March 11, 2020
+ *
+ * Description:     This file implements the convoy module, which tracks groups of avatars
+ *                  that have met (see convoy.h).
+ *
+ *                  Groups only ever merge, and there are at most AM_MAX_AVATAR avatars, so
+ *                  membership is a plain array of group IDs, relabelled on each merge.
+ *                  A follower finds its way to the leader with a breadth-first search out
+ *                  from the leader over known-open edges; the leader is rarely more than a
+ *                  step away, so the search stops almost at once.
+ *
+ */
+/* ========================================================================== */
+
+// Import C Standard libraries
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Import project-specific libraries
+#include "amazing.h"
+#include "AMlib_avatar.h"
+#include "map.h"
+#include "convoy.h"
+
+/**************** convoy struct ****************/
+typedef struct convoy {
+    int num_avatars;
+    int mazeWidth;
+    int mazeHeight;
+    int group[AM_MAX_AVATAR];   // Group ID of each avatar: the lowest avatar ID in its group
+    int lead[AM_MAX_AVATAR];    // Leader of each group, indexed by group ID
+    int *queue;                 // Search scratch: cells in the order they were reached
+    uint32_t *seen;             // Search scratch: the search in which each cell was reached
+    uint32_t search;            // The number of the current search
+} convoy_t;
+
+/**************** local functions ****************/
+static bool at_same_cell(avatar_t *a, avatar_t *b);
+static bool step_towards(convoy_t *cv, map_t *mp, int from, int to, uint32_t *move);
+
+/**************** convoy_new ****************/
+/* Allocates a convoy, with every avatar leading a group of its own
+ * Memory: caller is responsible for calling convoy_delete
+ */
+convoy_t *convoy_new(int num_avatars, int mazeWidth, int mazeHeight)
+{
+    convoy_t *cv = malloc(sizeof(convoy_t));
+    if (cv == NULL) {
+        return NULL;
+    }
+    int num_cells = mazeWidth * mazeHeight;
+    cv->num_avatars = num_avatars;
+    cv->mazeWidth = mazeWidth;
+    cv->mazeHeight = mazeHeight;
+    for (int i = 0; i < AM_MAX_AVATAR; i++) {
+        cv->group[i] = i;
+        cv->lead[i] = i;
+    }
+    cv->queue = malloc(num_cells * sizeof(int));
+    cv->seen = calloc(num_cells, sizeof(uint32_t));
+    cv->search = 0;
+    if (cv->queue == NULL || cv->seen == NULL) {
+        convoy_delete(cv);
+        return NULL;
+    }
+    return cv;
+}
+
+/**************** convoy_delete ****************/
+/* Frees the convoy and its search scratch
+ */
+void convoy_delete(convoy_t *cv)
+{
+    if (cv == NULL) {
+        return;
+    }
+    free(cv->queue);
+    free(cv->seen);
+    free(cv);
+}
+
+/**************** convoy_copy ****************/
+/* Copies the groups and leaders of src into dst; the search scratch is not copied
+ * Memory: does not allocate memory
+ */
+void convoy_copy(convoy_t *dst, convoy_t *src)
+{
+    dst->num_avatars = src->num_avatars;
+    memcpy(dst->group, src->group, sizeof(dst->group));
+    memcpy(dst->lead, src->lead, sizeof(dst->lead));
+}
+
+/**************** convoy_update ****************/
+/* Merges the groups of every two avatars on the same cell. The merged group keeps a leader who
+ * stands on that cell if either group has one, so that no member is left following a leader
+ * who is now behind it. Avatars not yet placed in av_array are ignored.
+ * Memory: does not allocate memory
+ */
+int convoy_update(convoy_t *cv, avatar_t **av_array, int num_av)
+{
+    for (int i = 0; i < num_av; i++) {
+        for (int j = i + 1; j < num_av; j++) {
+            if (cv->group[i] == cv->group[j] || !at_same_cell(av_array[i], av_array[j])) {
+                continue;
+            }
+
+            // Pick the leader of the merged group, preferring one on the meeting cell
+            int lead_i = cv->lead[cv->group[i]];
+            int lead_j = cv->lead[cv->group[j]];
+            int lead = i;
+            if (at_same_cell(av_array[lead_i], av_array[i])) {
+                lead = lead_i;
+            } else if (at_same_cell(av_array[lead_j], av_array[j])) {
+                lead = lead_j;
+            }
+
+            // Relabel both groups with the lower of their IDs
+            int from = cv->group[i] > cv->group[j] ? cv->group[i] : cv->group[j];
+            int to = cv->group[i] < cv->group[j] ? cv->group[i] : cv->group[j];
+            for (int k = 0; k < num_av; k++) {
+                if (cv->group[k] == from) {
+                    cv->group[k] = to;
+                }
+            }
+            cv->lead[to] = lead;
+        }
+    }
+
+    // Count the groups left: one per avatar which is its own group's ID
+    int num_groups = 0;
+    for (int i = 0; i < num_av; i++) {
+        num_groups += (cv->group[i] == i);
+    }
+    return num_groups;
+}
+
+/**************** convoy_getGroup ****************/
+int convoy_getGroup(convoy_t *cv, int avatar_id)
+{
+    return cv->group[avatar_id];
+}
+
+/**************** convoy_getGroupSize ****************/
+int convoy_getGroupSize(convoy_t *cv, int avatar_id)
+{
+    int size = 0;
+    for (int i = 0; i < cv->num_avatars; i++) {
+        size += (cv->group[i] == cv->group[avatar_id]);
+    }
+    return size;
+}
+
+/**************** convoy_getLeader ****************/
+int convoy_getLeader(convoy_t *cv, int avatar_id)
+{
+    return cv->lead[cv->group[avatar_id]];
+}
+
+/**************** convoy_follow ****************/
+/* An avatar on its leader's cell (the group's head) takes over as leader, and decides its own
+ * move; any other member steps towards the leader.
+ * Memory: does not allocate memory
+ */
+bool convoy_follow(convoy_t *cv, map_t *mp, avatar_t **av_array, int avatar_id, uint32_t *move)
+{
+    int group = cv->group[avatar_id];
+    int lead = cv->lead[group];
+    if (lead == avatar_id || at_same_cell(av_array[lead], av_array[avatar_id])) {
+        cv->lead[group] = avatar_id;
+        return false;
+    }
+    int width = cv->mazeWidth;
+    int from = avatar_getY(av_array[avatar_id]) * width + avatar_getX(av_array[avatar_id]);
+    int to = avatar_getY(av_array[lead]) * width + avatar_getX(av_array[lead]);
+    return step_towards(cv, mp, from, to, move);
+}
+
+/**************** at_same_cell ****************/
+/* Returns true if both avatars are placed, and on the same cell
+ */
+static bool at_same_cell(avatar_t *a, avatar_t *b)
+{
+    return a != NULL && b != NULL && avatar_getX(a) == avatar_getX(b) && avatar_getY(a) == avatar_getY(b);
+}
+
+/**************** step_towards ****************/
+/* Searches out from cell to over known-open edges until it reaches cell from, and sets *move to
+ * the step back across the edge the search reached it by: the first step of a shortest open path
+ * from from to to. Returns false, leaving *move alone, if walls or unknown edges separate them.
+ */
+static bool step_towards(convoy_t *cv, map_t *mp, int from, int to, uint32_t *move)
+{
+    int width = cv->mazeWidth;
+
+    // Start a new search; on wraparound of the search number, forget every earlier search
+    if (++cv->search == 0) {
+        memset(cv->seen, 0, width * cv->mazeHeight * sizeof(uint32_t));
+        cv->search = 1;
+    }
+    int head = 0;
+    int tail = 0;
+    cv->queue[tail++] = to;
+    cv->seen[to] = cv->search;
+    while (head < tail) {
+        int cell = cv->queue[head++];
+        int x = cell % width;
+        int y = cell / width;
+        int neighbors[M_NUM_DIRECTIONS][2] = {
+            [M_WEST] = {x - 1, y}, [M_NORTH] = {x, y - 1}, [M_SOUTH] = {x, y + 1}, [M_EAST] = {x + 1, y}};
+        for (int direction = 0; direction < M_NUM_DIRECTIONS; direction++) {
+            int nx = neighbors[direction][0];
+            int ny = neighbors[direction][1];
+            if (!map_isOpenXY(mp, x, y, nx, ny)) {
+                continue;
+            }
+            int next = ny * width + nx;
+            if (cv->seen[next] == cv->search) {
+                continue;
+            }
+            if (next == from) {
+                // The search stepped from cell to from in this direction; the way back is the opposite one
+                static const uint32_t opposite[M_NUM_DIRECTIONS] = {
+                    [M_WEST] = M_EAST, [M_NORTH] = M_SOUTH, [M_SOUTH] = M_NORTH, [M_EAST] = M_WEST};
+                *move = opposite[direction];
+                return true;
+            }
+            cv->seen[next] = cv->search;
+            cv->queue[tail++] = next;
+        }
+    }
+    return false;
+}
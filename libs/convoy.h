@@ -0,0 +1,89 @@
+/* ========================================================================== */
+/* File: convoy.h
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Andrw Yang, Maria Roodnitsky, Siddharth Agrawal, Alexander Hirsch
+ * Component name:  convoy
+ *
+ * Date Created:    March 11, 2020
+ *
+ * Description:     This header file provides the interface with the convoy module. The
+ *                  convoy module tracks groups of avatars: once avatars stand on the same
+ *                  cell they are merged into one group for the rest of the game, and the
+ *                  group moves as a unit.
+ *
+ *                  Each group has a leader, the member standing at the group's head
+ *                  cell. Only a member at the head cell decides a move with the move
+ *                  strategy (and so becomes the leader); every other member follows,
+ *                  stepping along known-open edges towards the leader. Members are thus
+ *                  never more than a step or two apart, only the leader probes unknown
+ *                  edges, and a group never splits up again. The group's target is
+ *                  the leader's: the meeting point, which the other avatars head for too.
+ *
+ *                  One convoy is shared by all avatars, and, like the map, is only used
+ *                  with the shared structures locked.
+ *
+ */
+/* ========================================================================== */
+#ifndef __CONVOY_H
+#define __CONVOY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "AMlib_avatar.h"
+#include "map.h"
+
+/**************** global types ****************/
+typedef struct convoy convoy_t;
+
+/**************** functions ****************/
+
+/**************** convoy_new ****************/
+/* Allocates a convoy for num_avatars avatars on a mazeWidth x mazeHeight map, each avatar in a
+ * group of its own. Returns NULL if memory could not be allocated.
+ * Memory: caller is responsible for calling convoy_delete
+ */
+convoy_t *convoy_new(int num_avatars, int mazeWidth, int mazeHeight);
+
+/**************** convoy_delete ****************/
+/* Frees the memory associated with the convoy
+ */
+void convoy_delete(convoy_t *cv);
+
+/**************** convoy_copy ****************/
+/* Copies the groups of src, and their leaders, into dst
+ */
+void convoy_copy(convoy_t *dst, convoy_t *src);
+
+/**************** convoy_update ****************/
+/* Merges the groups of avatars in av_array which stand on the same cell. Returns the number of
+ * groups left.
+ */
+int convoy_update(convoy_t *cv, avatar_t **av_array, int num_av);
+
+/**************** convoy_getGroup ****************/
+/* Returns the ID of the avatar's group: the lowest avatar ID in it
+ */
+int convoy_getGroup(convoy_t *cv, int avatar_id);
+
+/**************** convoy_getGroupSize ****************/
+/* Returns the number of avatars in the avatar's group
+ */
+int convoy_getGroupSize(convoy_t *cv, int avatar_id);
+
+/**************** convoy_getLeader ****************/
+/* Returns the avatar ID of the leader of the avatar's group
+ */
+int convoy_getLeader(convoy_t *cv, int avatar_id);
+
+/**************** convoy_follow ****************/
+/* Decides whether the avatar leads its group this turn or follows it.
+ * If the avatar stands at its group's head cell, it becomes the leader: returns false, and the
+ * caller decides its move with the move strategy.
+ * Otherwise returns true and sets *move to the first step of the shortest known-open path to the
+ * leader. Returns false (the avatar leads) if there is no such path.
+ */
+bool convoy_follow(convoy_t *cv, map_t *mp, avatar_t **av_array, int avatar_id, uint32_t *move);
+
+#endif // __CONVOY_H
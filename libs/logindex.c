@@ -0,0 +1,402 @@
+/* ========================================================================== */
+/* File: logindex.c
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Andrw Yang, Maria Roodnitsky, Siddharth Agrawal, Alexander Hirsch
+ * Component name:  logindex
+ *
+ * Date Created:    March 15, 2020
+ *
+ * Description:     This file implements the logindex module, which writes the index and
+ *                  checkpoints kept beside a game's log, and reads them back with the log
+ *                  (see logindex.h for both formats).
+ *
+ */
+/* ========================================================================== */
+
+// Import C Standard libraries
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <arpa/inet.h>
+
+// Import project-specific libraries
+#include "amazing.h"
+#include "map.h"
+#include "turnlog.h"
+#include "logindex.h"
+
+/**************** file-local global variables ****************/
+static const char index_magic[4] = {'A', 'M', 'Z', 'I'};
+static const char checkpoint_magic[4] = {'A', 'M', 'Z', 'C'};
+static const uint16_t index_version = 1;
+
+#define INDEX_HEADER_SIZE 32                    // Bytes of the index before its first entry
+#define INDEX_ENTRY_SIZE 24                     // Bytes of each entry
+#define CHECKPOINT_HEADER_SIZE 8                // Bytes of the checkpoints before the first
+#define CHECKPOINT_HEAD_SIZE 8                  // Bytes of a checkpoint before its map
+#define NO_CHECKPOINT UINT32_MAX                // An entry's checkpoint when none was taken before it
+#define INDEX_BUFFER (64 * 1024)                // Bytes of the index buffered between flushes
+
+/**************** logindex struct ****************/
+typedef struct logindex {
+    FILE *log;                          // The log; only when reading
+    FILE *index;
+    FILE *checkpoints;
+    log_format_t format;
+    int mazeWidth;
+    int mazeHeight;
+    int num_avatars;
+    size_t packed_size;                 // Bytes of a checkpoint's map
+    uint8_t *buf;                       // A checkpoint, as written or read
+    long count;                         // Entries written, or in the index when it was opened
+    long checkpoint_count;              // Checkpoints written, or in the file when it was opened
+    long latest_record;                 // Writing: the record of the latest checkpoint, and the one before it
+    long previous_checkpoint;
+    int last_iteration;                 // Writing: the iteration of the last turn added
+} logindex_t;
+
+/**************** local functions ****************/
+static logindex_t *logindex_alloc(const char *log_file_name, const char *mode);
+static void put16(uint8_t *buf, uint16_t value);
+static void put32(uint8_t *buf, uint32_t value);
+static uint16_t get16(const uint8_t *buf);
+static uint32_t get32(const uint8_t *buf);
+
+/**************** logindex_new ****************/
+/* see logindex.h for description */
+logindex_t *logindex_new(const char *log_file_name, log_format_t format, int mazeWidth, int mazeHeight, int num_avatars)
+{
+    logindex_t *ix = logindex_alloc(log_file_name, "w");
+    if (ix == NULL) {
+        return NULL;
+    }
+    ix->format = format;
+    ix->mazeWidth = mazeWidth;
+    ix->mazeHeight = mazeHeight;
+    ix->num_avatars = num_avatars;
+    ix->latest_record = -1;
+    ix->previous_checkpoint = -1;
+    map_t *sizer = map_new(mazeWidth, mazeHeight);
+    if (sizer == NULL) {
+        logindex_delete(ix);
+        return NULL;
+    }
+    ix->packed_size = map_packedSize(sizer);
+    map_delete(sizer);
+    ix->buf = malloc(CHECKPOINT_HEAD_SIZE + ix->packed_size);
+    if (ix->buf == NULL) {
+        logindex_delete(ix);
+        return NULL;
+    }
+
+    // Buffer the index, so a batch of entries is written in as few writes as it will fit in
+    setvbuf(ix->index, NULL, _IOFBF, INDEX_BUFFER);
+
+    // The headers
+    uint8_t header[INDEX_HEADER_SIZE];
+    memset(header, 0, sizeof(header));
+    memcpy(header, index_magic, sizeof(index_magic));
+    put16(header + 4, index_version);
+    put16(header + 6, (uint16_t)format);
+    put16(header + 8, (uint16_t)num_avatars);
+    put32(header + 12, (uint32_t)mazeWidth);
+    put32(header + 16, (uint32_t)mazeHeight);
+    put32(header + 20, LOGINDEX_CHECKPOINT_INTERVAL);
+    put32(header + 24, (uint32_t)ix->packed_size);
+    uint8_t checkpoint_header[CHECKPOINT_HEADER_SIZE];
+    memset(checkpoint_header, 0, sizeof(checkpoint_header));
+    memcpy(checkpoint_header, checkpoint_magic, sizeof(checkpoint_magic));
+    put16(checkpoint_header + 4, index_version);
+    if (fwrite(header, 1, sizeof(header), ix->index) != sizeof(header)
+        || fwrite(checkpoint_header, 1, sizeof(checkpoint_header), ix->checkpoints) != sizeof(checkpoint_header)
+        || fflush(ix->checkpoints) != 0) {
+        logindex_delete(ix);
+        return NULL;
+    }
+    return ix;
+}
+
+/**************** logindex_add_record ****************/
+/* see logindex.h for description */
+bool logindex_add_record(logindex_t *ix, long offset, const turn_record_t *record)
+{
+    if (record->kind == RECORD_TURN) {
+        ix->last_iteration = record->iteration;
+    }
+
+    // The latest checkpoint at or before this record: a checkpoint may be of a record not yet logged
+    long checkpoint = (ix->latest_record <= ix->count) ? ix->checkpoint_count - 1 : ix->previous_checkpoint;
+
+    uint8_t entry[INDEX_ENTRY_SIZE];
+    memset(entry, 0, sizeof(entry));
+    uint64_t where = (uint64_t)offset;
+    put32(entry, (uint32_t)(where >> 32));
+    put32(entry + 4, (uint32_t)where);
+    put32(entry + 8, (uint32_t)ix->last_iteration);
+    put32(entry + 12, (checkpoint < 0) ? NO_CHECKPOINT : (uint32_t)checkpoint);
+    put16(entry + 16, (uint16_t)record->target.x);
+    put16(entry + 18, (uint16_t)record->target.y);
+    entry[20] = (uint8_t)record->kind;
+    entry[21] = (uint8_t)record->avatar_id;
+    ix->count++;
+    return fwrite(entry, 1, sizeof(entry), ix->index) == sizeof(entry);
+}
+
+/**************** logindex_add_checkpoint ****************/
+/* see logindex.h for description */
+bool logindex_add_checkpoint(logindex_t *ix, long record_number, map_t *map)
+{
+    put32(ix->buf, (uint32_t)record_number);
+    put16(ix->buf + 4, (uint16_t)map_getTargetX(map));
+    put16(ix->buf + 6, (uint16_t)map_getTargetY(map));
+    map_pack(map, ix->buf + CHECKPOINT_HEAD_SIZE);
+
+    // Entries from here on take this checkpoint once they reach its record, and the latest one until then
+    ix->previous_checkpoint = ix->checkpoint_count - 1;
+    ix->latest_record = record_number;
+    ix->checkpoint_count++;
+    size_t size = CHECKPOINT_HEAD_SIZE + ix->packed_size;
+    return fwrite(ix->buf, 1, size, ix->checkpoints) == size && fflush(ix->checkpoints) == 0;
+}
+
+/**************** logindex_flush ****************/
+/* see logindex.h for description */
+bool logindex_flush(logindex_t *ix)
+{
+    return fflush(ix->index) == 0;
+}
+
+/**************** logindex_open ****************/
+/* see logindex.h for description */
+logindex_t *logindex_open(const char *log_file_name)
+{
+    logindex_t *ix = logindex_alloc(log_file_name, "rb");
+    if (ix == NULL) {
+        return NULL;
+    }
+    ix->log = fopen(log_file_name, "rb");
+
+    // The index's header
+    uint8_t header[INDEX_HEADER_SIZE];
+    uint8_t checkpoint_header[CHECKPOINT_HEADER_SIZE];
+    if (ix->log == NULL
+        || fread(header, 1, sizeof(header), ix->index) != sizeof(header)
+        || memcmp(header, index_magic, sizeof(index_magic)) != 0 || get16(header + 4) != index_version
+        || fread(checkpoint_header, 1, sizeof(checkpoint_header), ix->checkpoints) != sizeof(checkpoint_header)
+        || memcmp(checkpoint_header, checkpoint_magic, sizeof(checkpoint_magic)) != 0) {
+        logindex_delete(ix);
+        return NULL;
+    }
+    ix->format = get16(header + 6);
+    ix->num_avatars = get16(header + 8);
+    ix->mazeWidth = (int)get32(header + 12);
+    ix->mazeHeight = (int)get32(header + 16);
+    ix->packed_size = get32(header + 24);
+    ix->buf = malloc(CHECKPOINT_HEAD_SIZE + ix->packed_size);
+    if (ix->buf == NULL || ix->num_avatars > AM_MAX_AVATAR) {
+        logindex_delete(ix);
+        return NULL;
+    }
+
+    // How many entries and checkpoints there are, from the sizes of the files; a part written is left out
+    fseek(ix->index, 0, SEEK_END);
+    ix->count = (ftell(ix->index) - INDEX_HEADER_SIZE) / INDEX_ENTRY_SIZE;
+    fseek(ix->checkpoints, 0, SEEK_END);
+    ix->checkpoint_count = (ftell(ix->checkpoints) - CHECKPOINT_HEADER_SIZE) / (long)(CHECKPOINT_HEAD_SIZE + ix->packed_size);
+    return ix;
+}
+
+/**************** getters ****************/
+/* see logindex.h for description */
+log_format_t logindex_get_format(logindex_t *ix)
+{
+    return ix->format;
+}
+
+int logindex_get_MazeWidth(logindex_t *ix)
+{
+    return ix->mazeWidth;
+}
+
+int logindex_get_MazeHeight(logindex_t *ix)
+{
+    return ix->mazeHeight;
+}
+
+int logindex_get_num_avatars(logindex_t *ix)
+{
+    return ix->num_avatars;
+}
+
+/**************** logindex_count ****************/
+/* see logindex.h for description */
+long logindex_count(logindex_t *ix)
+{
+    return ix->count;
+}
+
+/**************** logindex_checkpoint_count ****************/
+/* see logindex.h for description */
+long logindex_checkpoint_count(logindex_t *ix)
+{
+    return ix->checkpoint_count;
+}
+
+/**************** logindex_entry ****************/
+/* see logindex.h for description */
+bool logindex_entry(logindex_t *ix, long i, logindex_entry_t *entry)
+{
+    uint8_t buf[INDEX_ENTRY_SIZE];
+    if (i < 0 || i >= ix->count
+        || fseek(ix->index, INDEX_HEADER_SIZE + i * INDEX_ENTRY_SIZE, SEEK_SET) != 0
+        || fread(buf, 1, sizeof(buf), ix->index) != sizeof(buf)) {
+        return false;
+    }
+    entry->offset = (long)(((uint64_t)get32(buf) << 32) | get32(buf + 4));
+    entry->iteration = (int)get32(buf + 8);
+    entry->checkpoint = (get32(buf + 12) == NO_CHECKPOINT) ? -1 : (long)get32(buf + 12);
+    entry->target.x = get16(buf + 16);
+    entry->target.y = get16(buf + 18);
+    entry->kind = buf[20];
+    entry->avatar_id = buf[21];
+    return true;
+}
+
+/**************** logindex_find ****************/
+/* see logindex.h for description */
+long logindex_find(logindex_t *ix, int iteration)
+{
+    // The first entry of at least that iteration
+    long low = 0;
+    long high = ix->count;
+    logindex_entry_t entry;
+    while (low < high) {
+        long middle = low + (high - low) / 2;
+        if (!logindex_entry(ix, middle, &entry)) {
+            return -1;
+        }
+        if (entry.iteration < iteration) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    // Entries which are not turns share the iteration of the turn before them; step over them
+    for (long i = low; logindex_entry(ix, i, &entry) && entry.iteration == iteration; i++) {
+        if (entry.kind == RECORD_TURN) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**************** logindex_read ****************/
+/* see logindex.h for description */
+bool logindex_read(logindex_t *ix, long i, turn_record_t *record)
+{
+    logindex_entry_t entry;
+    bool truncated;
+    if (!logindex_entry(ix, i, &entry) || fseek(ix->log, entry.offset, SEEK_SET) != 0
+        || !turnlog_read_record(ix->log, ix->format, ix->num_avatars, record, &truncated)) {
+        return false;
+    }
+    record->target = entry.target;
+    return true;
+}
+
+/**************** logindex_load_checkpoint ****************/
+/* see logindex.h for description */
+bool logindex_load_checkpoint(logindex_t *ix, long c, map_t *map, long *record_number)
+{
+    size_t size = CHECKPOINT_HEAD_SIZE + ix->packed_size;
+    if (c < 0 || c >= ix->checkpoint_count || map_packedSize(map) != ix->packed_size
+        || fseek(ix->checkpoints, CHECKPOINT_HEADER_SIZE + c * (long)size, SEEK_SET) != 0
+        || fread(ix->buf, 1, size, ix->checkpoints) != size) {
+        return false;
+    }
+    *record_number = get32(ix->buf);
+    if (!map_setTargetXY(map, get16(ix->buf + 4), get16(ix->buf + 6))) {
+        return false;
+    }
+    map_unpack(map, ix->buf + CHECKPOINT_HEAD_SIZE);
+    return true;
+}
+
+/**************** logindex_delete ****************/
+/* see logindex.h for description */
+void logindex_delete(logindex_t *ix)
+{
+    if (ix == NULL) {
+        return;
+    }
+    if (ix->log != NULL) {
+        fclose(ix->log);
+    }
+    if (ix->index != NULL) {
+        fclose(ix->index);
+    }
+    if (ix->checkpoints != NULL) {
+        fclose(ix->checkpoints);
+    }
+    free(ix->buf);
+    free(ix);
+}
+
+/**************** logindex_alloc ****************/
+/* Allocates an index, and opens the index and checkpoints of the log at log_file_name with mode.
+ * Returns NULL, with neither open, if memory could not be allocated or either could not be opened
+ */
+static logindex_t *logindex_alloc(const char *log_file_name, const char *mode)
+{
+    logindex_t *ix = calloc(1, sizeof(logindex_t));
+    char *name = malloc(strlen(log_file_name) + strlen(".idx") + 1);
+    if (ix == NULL || name == NULL) {
+        free(ix);
+        free(name);
+        return NULL;
+    }
+    sprintf(name, "%s.idx", log_file_name);
+    ix->index = fopen(name, mode);
+    sprintf(name, "%s.ckp", log_file_name);
+    ix->checkpoints = fopen(name, mode);
+    free(name);
+    if (ix->index == NULL || ix->checkpoints == NULL) {
+        logindex_delete(ix);
+        return NULL;
+    }
+    return ix;
+}
+
+/**************** put16, put32, get16, get32 ****************/
+/* Write and read 2- and 4-byte unsigned integers in network byte order, at any alignment
+ */
+static void put16(uint8_t *buf, uint16_t value)
+{
+    value = htons(value);
+    memcpy(buf, &value, sizeof(value));
+}
+
+static void put32(uint8_t *buf, uint32_t value)
+{
+    value = htonl(value);
+    memcpy(buf, &value, sizeof(value));
+}
+
+static uint16_t get16(const uint8_t *buf)
+{
+    uint16_t value;
+    memcpy(&value, buf, sizeof(value));
+    return ntohs(value);
+}
+
+static uint32_t get32(const uint8_t *buf)
+{
+    uint32_t value;
+    memcpy(&value, buf, sizeof(value));
+    return ntohl(value);
+}
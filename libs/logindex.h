@@ -0,0 +1,176 @@
+/* ========================================================================== */
+/* File: logindex.h
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Andrw Yang, Maria Roodnitsky, Siddharth Agrawal, Alexander Hirsch
+ * Component name:  logindex
+ *
+ * Date Created:    March 15, 2020
+ *
+ * Description:     This header file provides the interface with the logindex module, which
+ *                  writes and reads the two files kept beside a game's log, so a tool can
+ *                  go to any turn of the log without reading the turns before it:
+ *
+ *                  - the index, the log's name ending in .idx as well, with an entry of
+ *                    fixed size for every record of the log: where the record starts in
+ *                    the log, its iteration, and the meeting point once it was played, and
+ *                  - the checkpoints, the log's name ending in .ckp, the edges of the
+ *                    shared map (see map_pack), taken whenever LOGINDEX_CHECKPOINT_INTERVAL
+ *                    records have been logged since the last.
+ *
+ *                  Entry i of the index is at a fixed offset, so it is read with one seek,
+ *                  and the entries are in order of iteration, so the record of an iteration
+ *                  is found by binary search. Each entry also names the latest checkpoint
+ *                  taken at or before its record: the map after any record is that
+ *                  checkpoint with the records after it replayed on it (see AMReplay).
+ *                  A checkpoint is of the last record submitted when it is taken, which
+ *                  may be ahead of the last logged, so checkpoints are about
+ *                  LOGINDEX_CHECKPOINT_INTERVAL records apart, and never more than that
+ *                  and the records the recorder's ring holds.
+ *
+ *                  Every integer is unsigned and in network byte order, like the binary
+ *                  log. The index starts with 32 bytes
+ *
+ *                      4 bytes     "AMZI"
+ *                      2 bytes     format version, 1
+ *                      2 bytes     format of the log (a log_format_t)
+ *                      2 bytes     number of avatars
+ *                      2 bytes     reserved, 0
+ *                      4 bytes     maze width
+ *                      4 bytes     maze height
+ *                      4 bytes     records between checkpoints
+ *                      4 bytes     bytes of a checkpoint's map, P
+ *                      4 bytes     reserved, 0
+ *
+ *                  followed by one 24-byte entry per record
+ *
+ *                      8 bytes     offset of the record in the log
+ *                      4 bytes     iteration of the turn, or of the last turn before it
+ *                      4 bytes     number of the latest checkpoint at or before it
+ *                                  (0xFFFFFFFF if none)
+ *                      2 bytes     X of the meeting point once the record was played
+ *                      2 bytes     Y of the meeting point
+ *                      1 byte      kind (a record_kind_t)
+ *                      1 byte      avatar ID
+ *                      2 bytes     reserved, 0
+ *
+ *                  The checkpoints start with 8 bytes, "AMZC" and the 2-byte format
+ *                  version, 1, and 2 reserved; then each checkpoint is
+ *
+ *                      4 bytes     number of the record the map is as of, the last
+ *                                  record submitted when it was taken
+ *                      2 bytes     X of the meeting point
+ *                      2 bytes     Y of the meeting point
+ *                      P bytes     the map's edges, from map_pack
+ *
+ */
+/* ========================================================================== */
+#ifndef __LOGINDEX_H
+#define __LOGINDEX_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "amazing.h"
+#include "map.h"
+#include "turnlog.h"
+
+/**************** global types ****************/
+typedef struct logindex logindex_t;
+
+#define LOGINDEX_CHECKPOINT_INTERVAL 1024   // Records logged before the next checkpoint is taken
+
+// What the index says about a record
+typedef struct logindex_entry {
+    long offset;            // Where the record starts in the log
+    int iteration;          // The iteration of the turn, or of the last turn before the record (0 if none)
+    long checkpoint;        // The latest checkpoint at or before the record, or -1 if none
+    XYPos target;           // The meeting point once the record was played
+    record_kind_t kind;
+    int avatar_id;
+} logindex_entry_t;
+
+/**************** functions ****************/
+
+/**************** logindex_new ****************/
+/* Creates, or empties, the index and checkpoints of the log at log_file_name, written in format, for a
+ * mazeWidth x mazeHeight maze and num_avatars avatars, and writes their headers. Returns NULL if
+ * either could not be created, or memory could not be allocated.
+ * Memory: caller is responsible for calling logindex_delete
+ */
+logindex_t *logindex_new(const char *log_file_name, log_format_t format, int mazeWidth, int mazeHeight, int num_avatars);
+
+/**************** logindex_add_record ****************/
+/* Adds the entry for the next record of the log, record, which starts offset bytes into the log.
+ * Returns false if it could not be written
+ */
+bool logindex_add_record(logindex_t *ix, long offset, const turn_record_t *record);
+
+/**************** logindex_add_checkpoint ****************/
+/* Adds a checkpoint of map, as it was once record record_number (counting from 0) had been played.
+ * The entries of that record and every record after it name the checkpoint, until the next one.
+ * Checkpoints must be added in order of record. Returns false if it could not be written
+ */
+bool logindex_add_checkpoint(logindex_t *ix, long record_number, map_t *map);
+
+/**************** logindex_flush ****************/
+/* Writes out the entries and checkpoints added so far. Returns false if they could not be written
+ */
+bool logindex_flush(logindex_t *ix);
+
+/**************** logindex_open ****************/
+/* Opens the log at log_file_name with its index and checkpoints, to read. Returns NULL if any of them
+ * could not be opened, or the index is not one this version reads.
+ * Memory: caller is responsible for calling logindex_delete
+ */
+logindex_t *logindex_open(const char *log_file_name);
+
+/**************** getters ****************/
+/* The format of the log, the size of the maze and the number of avatars, from the index's header */
+log_format_t logindex_get_format(logindex_t *ix);
+int logindex_get_MazeWidth(logindex_t *ix);
+int logindex_get_MazeHeight(logindex_t *ix);
+int logindex_get_num_avatars(logindex_t *ix);
+
+/**************** logindex_count ****************/
+/* Returns the number of records in the index of a log opened with logindex_open
+ */
+long logindex_count(logindex_t *ix);
+
+/**************** logindex_checkpoint_count ****************/
+/* Returns the number of checkpoints of a log opened with logindex_open
+ */
+long logindex_checkpoint_count(logindex_t *ix);
+
+/**************** logindex_entry ****************/
+/* Reads the entry of record i into entry. Returns false if there is no such record
+ */
+bool logindex_entry(logindex_t *ix, long i, logindex_entry_t *entry);
+
+/**************** logindex_find ****************/
+/* Returns the number of the record of the turn of the given iteration, found by binary search, or -1
+ * if the log has no such turn
+ */
+long logindex_find(logindex_t *ix, int iteration);
+
+/**************** logindex_read ****************/
+/* Reads record i from the log into record, with the meeting point from its entry. Returns false if
+ * there is no such record, or it could not be read from the log
+ */
+bool logindex_read(logindex_t *ix, long i, turn_record_t *record);
+
+/**************** logindex_load_checkpoint ****************/
+/* Sets map, a map of the maze's size, to checkpoint c: its target and edges, and all the map derives
+ * from them (see map_unpack). Sets *record_number to the record the map is as of. Returns false if
+ * there is no such checkpoint, it could not be read, or the map's distance field could not be allocated
+ */
+bool logindex_load_checkpoint(logindex_t *ix, long c, map_t *map, long *record_number);
+
+/**************** logindex_delete ****************/
+/* Closes the files of the index, writing out what was added to them, and frees the memory
+ * associated with it
+ */
+void logindex_delete(logindex_t *ix);
+
+#endif // __LOGINDEX_H
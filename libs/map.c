@@ -14,17 +14,69 @@
  *                  and functions for use by other components. It implements its own 
  *                  data structure to store the map.
  * 
- *                  The map is implemented as a 2D data grid, where the dimensions are:
- *                      dataHeight = 2*MazeHeight - 1
- *                      dataWidth = 2*MazeWidth - 1
+ *                  The map stores only the relationships between cells, as two packed
+ *                  edge planes:
+ *                      horizontal edges: (MazeWidth-1) x MazeHeight, the edge between
+ *                                        (x,y) and (x+1,y) is stored at y*(MazeWidth-1) + x
+ *                      vertical edges:   MazeWidth x (MazeHeight-1), the edge between
+ *                                        (x,y) and (x,y+1) is stored at y*MazeWidth + x
  *                  
- *                  In this data structure, even indexed rows and column pairs e.g. (0,0),
- *                  (0,2), (2,0) represent cells, while odd numbered rows and columns e.g.
- *                  (0,1), (1,0) represent relationships between cells
+ *                  Each edge takes 2 bits, so four edges are packed into every byte: the
+ *                  edge planes of a 1000x1000 maze take about 0.5 MB.
+ *                  
+ *                  Alongside the edge planes, every cell keeps a 4-bit wall mask with one bit
+ *                  per side (MAP_WALL_WEST, MAP_WALL_NORTH, MAP_WALL_SOUTH, MAP_WALL_EAST),
+ *                  packed two cells per byte. Sides on the border of the maze are set from the
+ *                  start. The setters keep the masks in sync with the edge planes, so a full
+ *                  neighborhood can be read with map_wallMask in a single load.
+ *                  
+ *                  The map struct and all of its planes live in one contiguous allocation,
+ *                  with each plane starting on a cache line (MAP_ALIGN bytes). Every plane is
+ *                  row-major, so a row-wise scan of the maze walks memory sequentially. The
+ *                  arrays behind inference get a block of their own, laid out the same way,
+ *                  the first time inference is turned on, and so do those behind the distance
+ *                  field, the first time a target is set: a map which is only drawn or
+ *                  checkpointed never pays for them. The block itself takes about 1.1 bytes a
+ *                  cell (1.1 MB at 1000x1000); inference adds 13 bytes a cell, and the distance
+ *                  field 9, with a repair heap sized by the largest repair so far.
+ *                  
+ *                  map_fillDeadEnds seals known dead ends. Because the maze is perfect (a
+ *                  tree), a cell walled on three sides which holds no avatar and is not the
+ *                  meeting point can never be on the way to the meeting point, so its last
+ *                  side can be walled off as well. Sealing it may in turn leave its neighbor
+ *                  walled on three sides, so the fill cascades down the whole blind corridor.
+ *                  
+ *                  map_sweepDeadEnds finds every dead end on the map in one pass, for use after
+ *                  a burst of discovery. The pass reads the wall mask plane a vector at a time
+ *                  (AVX2 or SSE2, chosen at run time, with a portable 64-bit fallback), counts
+ *                  the walls of every cell at once, and writes the cells walled on exactly three
+ *                  sides into a bitmap, one bit per cell, kept at the end of the map's block.
+ *                  Compile with -DMAP_NO_AVX2 or -DMAP_NO_SIMD to force the narrower kernels.
+ *                  
+ *                  With map_setInference enabled, the map also infers edges nobody probed, again
+ *                  because the maze is a tree. A union-find over the open edges tracks which cells
+ *                  are known to be connected; an unknown edge joining two connected cells would
+ *                  close a cycle, so it is a wall. And every cell is reachable, so a cell walled
+ *                  on three sides must be open on the fourth. (Sealed dead ends keep this true:
+ *                  a sealed side only ever hides a blind corridor hanging off the cell.) Each
+ *                  inferred edge feeds back into both rules through a worklist of cells.
+ *                  
+ *                  Once map_setTargetXY names the meeting point, the map also keeps the distance
+ *                  of every cell from it, counting steps over every edge not known to be a wall
+ *                  (open or unknown). The field is built by one BFS and then kept up to date as
+ *                  edges change: a new wall only raises the distances of the cells whose every
+ *                  shortest path crossed it, so only those are found (in BFS order from the
+ *                  wall) and re-seeded from their unaffected neighbors, as in LPA* and D* Lite.
+ *                  A removed wall can only lower distances, and spreads out from the edge.
+ *                  Moving the target is both at once: the new target lowers the cells now
+ *                  nearer to it, and the old one, no longer a source, raises the cells which
+ *                  only it supported, so only cells whose distance changes are repaired.
+ *                  The heap the repairs use grows as they need it, and no further.
+ *                  map_nextStepXY then reads a move off the field in constant time.
  *                  
  *                  The possible states for a relationship between cells are 'unknown', 
- *                  'wall', and 'open'. State of cells is represented with integer values 
- *                  (e.g. wallNum, openNum, unknownNum).
+ *                  'wall', and 'open'. State of cells is represented with the map_state_t 
+ *                  values MAP_UNKNOWN, MAP_OPEN and MAP_WALL exported by map.h.
  * 
  *                  Status can be get and set through functions like isWall and setWall.
  *                  These functions are parallel in function between the versions for 'unknown',
@@ -32,8 +84,10 @@
  *                  position structs are provided for each function, enabling flexibility for
  *                  the caller to use the version which best matches their usage pattern.
  *                  
- *                  A supporting findDataLocation function converts users input points into
- *                  locations in the data structure, and checks for validity of input
+ *                  Every getter and setter is routed through map_getEdge and map_setEdge,
+ *                  which take value-typed map_cell_t coordinates and never allocate. A
+ *                  supporting inline findDataLocation function converts those points into
+ *                  an edge plane and index in the data structure, and checks for validity of input
  *
  */
 /* ========================================================================== */
@@ -42,26 +96,97 @@
 #include <stdio.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#if !defined(MAP_NO_SIMD) && (defined(__x86_64__) || defined(__i386__))
+#define MAP_X86_KERNELS
+#include <immintrin.h>
+#endif
 
 // Import project specific libraries
 #include "AMlib_avatar.h"
+#include "map.h"
 
 
 /**************** global types ****************/
 typedef struct map {
-    int **columns;      // Stores pointers to each column
+    uint8_t *hEdges;    // Packed 2-bit states of the edges between (x,y) and (x+1,y)
+    uint8_t *vEdges;    // Packed 2-bit states of the edges between (x,y) and (x,y+1)
+    uint8_t *wallMasks; // Packed 4-bit wall masks of each cell, stored at y*MazeWidth + x
     int mazeHeight;
     int mazeWidth;
-    int dataHeight;
-    int dataWidth;
-    int unknownNum;     // Representative value for 'unknown'
-    int openNum;        // Representative value for 'unknown'
-    int wallNum;        // Representative value for 'unknown'
+    uint64_t *deadEnds; // Bitmap written by the dead-end sweep, bit y*MazeWidth + x per cell
+    size_t maskBytes;   // Size of the wall mask plane, padding included (a multiple of MAP_ALIGN)
+    int32_t *ufParent;  // Union-find over open edges: parent cell, or -(component size) for a root
+                        // (NULL until inference is first turned on; it heads the inference block)
+    int32_t *ufNext;    // Circular list of the cells of each component, for walking the smaller one
+    int32_t *worklist;  // Stack of cells to check for an inferable open side
+    uint8_t *queued;    // Whether each cell is on the worklist
+    int worklistSize;
+    bool inference;     // Whether edges are inferred, see map_setInference
+    int inferredEdges;  // Number of edges inferred so far
+    int wallChanges;    // Number of times an edge became, or stopped being, a wall
+    int32_t *distance;  // Steps from each cell to the target over non-wall edges, or MAP_UNREACHABLE
+                        // (NULL until a target is first set; it heads the distance block)
+    int32_t *repair;    // FIFO of the cells a new wall may have pushed further from the target
+    uint8_t *affected;  // Per-cell flags used while repairing the distance field
+    uint64_t *heap;     // Binary min-heap of (distance << 32 | cell), used while repairing, grown as needed
+    int heapSize;
+    int heapCapacity;
+    bool heapOverflow;  // A push found the heap full and could not grow it, so the repair must be redone
+    int targetX;        // Cell which dead-end filling must never seal (the meeting point)
+    int targetY;
+    size_t blockBytes;  // Size of the allocation holding this struct and the planes copied with the edges
 } map_t;
 
+/**************** file-local constants ****************/
+static const size_t MAP_ALIGN = 64;     // Every plane starts on a cache line boundary
+static const int32_t MAP_UNREACHABLE = INT32_MAX;   // Distance of a cell cut off from the target
+static const int AFFECTED_QUEUED = 1;   // Distance repair flags: on the repair FIFO,
+static const int AFFECTED_RAISED = 2;   // and found to have lost every shortest path
+static const int HEAP_INITIAL = 256;    // Entries of the repair heap when it is first needed
+
+// Cartesian step for each direction in amazing.h, indexed by M_WEST, M_NORTH, M_SOUTH, M_EAST
+static const int DIR_DX[M_NUM_DIRECTIONS] = {-1, 0, 0, 1};
+static const int DIR_DY[M_NUM_DIRECTIONS] = {0, -1, 1, 0};
+
 
 /**************** Function prototypes ****************/
-static position_t *findDataLocation(map_t *mp, position_t *pos1, position_t *pos2);
+static inline bool findDataLocation(map_t *mp, int x1, int y1, int x2, int y2, uint8_t **plane, int *index);
+static inline map_cell_t cellOf(position_t *pos);
+static inline int getEdge(uint8_t *plane, int index);
+static inline void setEdge(uint8_t *plane, int index, int value);
+static size_t planeBytes(int edgeCount);
+static size_t alignUp(size_t bytes);
+static inline int getMask(uint8_t *masks, int cell);
+static inline void setMaskBit(uint8_t *masks, int cell, int bit, bool on);
+static bool writeEdge(map_t *mp, map_cell_t c1, map_cell_t c2, map_state_t state);
+static int ufFind(map_t *mp, int cell);
+static void ufUnite(map_t *mp, int a, int b);
+static void ufLink(map_t *mp, int small, int large);
+static void pushCell(map_t *mp, int cell);
+static void runInference(map_t *mp);
+static bool inferenceAlloc(map_t *mp);
+static void ufReset(map_t *mp);
+static bool distanceAlloc(map_t *mp);
+static void distanceFree(map_t *mp);
+static void copyBlock(map_t *dst, map_t *src);
+static void distanceRebuild(map_t *mp);
+static void distanceRaise(map_t *mp, int a, int b);
+static void distanceUnsupport(map_t *mp, int start);
+static void distanceRetarget(map_t *mp, int from, int to);
+static void distanceLower(map_t *mp, int a, int b);
+static void distanceSpread(map_t *mp);
+static inline int neighborOf(map_t *mp, int cell, int dir);
+static void heapPush(map_t *mp, int32_t distance, int cell);
+static uint64_t heapPop(map_t *mp);
+static void sweepScalar(const uint8_t *masks, size_t maskBytes, uint64_t *bitmap);
+#ifdef MAP_X86_KERNELS
+static void sweepSSE2(const uint8_t *masks, size_t maskBytes, uint64_t *bitmap);
+#ifndef MAP_NO_AVX2
+static void sweepAVX2(const uint8_t *masks, size_t maskBytes, uint64_t *bitmap);
+#endif
+#endif
 bool map_validXY(map_t *mp, int x, int y);
 bool map_neighborAndValidXY(map_t *mp, int x1, int y1, int x2, int y2);
 
@@ -69,35 +194,54 @@ bool map_neighborAndValidXY(map_t *mp, int x1, int y1, int x2, int y2);
 /**************** map_new ****************/
 /* Memory: returns a newly allocated map object. Caller must later free this memory
  * using map_delete.
- * Implementation: The grid is implemented as an array of arrays. The senior array
- * represents row position, and the junior array corresponding to each row position
- * is a column. As a result, calls can be performed against the map of the format [x][y]. 
+ * Implementation: The map is implemented as two packed edge planes, one for the
+ * horizontal (east-west) relationships and one for the vertical (north-south)
+ * relationships. Every edge takes 2 bits, so a plane of n edges takes (n+3)/4 bytes.
+ * The struct, both edge planes, the wall mask plane and the dead-end bitmap are carved out
+ * of a single cache-line aligned allocation, in that order. The inference and distance field
+ * arrays are left to map_setInference and map_setTargetXY.
  * 
  */
 map_t* map_new(int mazeWidth, int mazeHeight) 
 {
+    // Lay out the block: struct, horizontal edges, vertical edges, wall masks (two cells per byte),
+    // dead-end bitmap (one 64-bit word for every 32 bytes of masks, so the sweep writes whole words)
+    size_t hOffset = alignUp(sizeof(map_t));
+    size_t vOffset = hOffset + alignUp(planeBytes((mazeWidth - 1) * mazeHeight));
+    size_t maskOffset = vOffset + alignUp(planeBytes(mazeWidth * (mazeHeight - 1)));
+    size_t maskBytes = alignUp(((size_t)mazeWidth * mazeHeight + 1) / 2);
+    size_t deadEndOffset = maskOffset + maskBytes;
+    size_t blockBytes = deadEndOffset + alignUp(maskBytes / 32 * sizeof(uint64_t));
+
+    // Allocate the block and zero it, which leaves every edge at 0, the value of MAP_UNKNOWN
+    uint8_t *block = aligned_alloc(MAP_ALIGN, blockBytes);
+    if (block == NULL) {
+        fprintf(stderr, "map_new failed to allocate memory.\n");
+        return NULL;
+    }
+    memset(block, 0, blockBytes);
 
-    // Allocate and initialize the map struct
-    map_t *mp = malloc(sizeof(map_t));
+    // Initialize the map struct at the front of the block
+    map_t *mp = (map_t *)block;
     mp->mazeWidth = mazeWidth;
     mp->mazeHeight = mazeHeight;
-    mp->dataWidth = 2*mazeWidth - 1;
-    mp->dataHeight = 2*mazeHeight - 1;
-    mp->unknownNum = 0;
-    mp->openNum = 1;
-    mp->wallNum = 2;
-    mp->columns = (int **)malloc(mp->dataWidth * sizeof(int *));
-
-    // Allocate all the columns
-    for (int i = 0; i < mp->dataWidth; i++) {
-        mp->columns[i] = (int *)malloc(mp->dataHeight * sizeof(int));
-    }
-
-    // Initialize each map location to the value of unknown
-    for (int i = 0; i < (2*mazeWidth - 1); i++) {
-        for (int j = 0; j < (2*mazeHeight - 1); j++) {
-            mp->columns[i][j] = mp->unknownNum;
-
+    mp->blockBytes = blockBytes;
+    mp->targetX = -1;
+    mp->targetY = -1;
+    mp->hEdges = block + hOffset;
+    mp->vEdges = block + vOffset;
+    mp->wallMasks = block + maskOffset;
+    mp->maskBytes = maskBytes;
+    mp->deadEnds = (uint64_t *)(block + deadEndOffset);
+
+    // Wall off the border of the maze in the wall masks
+    for (int y = 0; y < mazeHeight; y++) {
+        for (int x = 0; x < mazeWidth; x++) {
+            int cell = y * mazeWidth + x;
+            setMaskBit(mp->wallMasks, cell, MAP_WALL_WEST, x == 0);
+            setMaskBit(mp->wallMasks, cell, MAP_WALL_NORTH, y == 0);
+            setMaskBit(mp->wallMasks, cell, MAP_WALL_SOUTH, y == mazeHeight - 1);
+            setMaskBit(mp->wallMasks, cell, MAP_WALL_EAST, x == mazeWidth - 1);
         }
     }
 
@@ -110,329 +254,645 @@ map_t* map_new(int mazeWidth, int mazeHeight)
  */
 bool map_delete(map_t *mp) 
 {
-    // Free each of the columns
-    for (int i = 0; i < mp->dataWidth; i++) {
-        free(mp->columns[i]);
-    }
-
-    // Free the array of pointers to the columns
-    free(mp->columns);
-
-    // Free the remaining memory allocated for the struct
+    // The struct and its planes share one allocation, but for the inference and distance blocks and the heap
+    free(mp->ufParent);
+    free(mp->distance);
+    free(mp->heap);
     free(mp);
 
     // Return
     return true;
 }
 
-/**************** map_isWall ****************/
-/* Boolean return for whether a wall exists between position 1 and position 2
- * Input: pointer to a valid map and two position objects
- * Returns true if a wall exists, false otherwise
+/**************** map_copy ****************/
+/* Copies what is known about the map src into dst, a map of the same size: its edges, wall
+ * masks, components of open edges, target and distance field. Returns false, leaving dst
+ * alone, if the sizes differ or dst's inference or distance arrays could not be allocated.
+ * Implementation: the edge planes up to the end of the dead-end bitmap, the union-find and the
+ * distance field are the whole state of a map; the worklist, repair and heap planes are
+ * scratch, left empty between calls, and are not copied. The planes lie in the same order in
+ * every block, so each state run is one memcpy.
+ * Memory: allocates dst's inference and distance arrays if src has them and dst does not yet;
+ * they are freed again if src has none
  */
-bool map_isWall(map_t *mp, position_t *pos1, position_t *pos2)
+bool map_copy(map_t *dst, map_t *src)
 {
-    if ( !map_validXY(mp, position_getX(pos1), position_getY(pos1)) || !map_validXY(mp, position_getX(pos2), position_getY(pos2)) ) {
-        return true;
+    if (dst->mazeWidth != src->mazeWidth || dst->mazeHeight != src->mazeHeight) {
+        return false;
     }
-
-    // Get the value of the spot representing this cell-to-cell connection
-    position_t *index = findDataLocation(mp, pos1, pos2);
-    if (index == NULL) {
+    if ((src->ufParent != NULL && !inferenceAlloc(dst)) || (src->distance != NULL && !distanceAlloc(dst))) {
         return false;
     }
-    int value = mp->columns[position_getX(index)][position_getY(index)];
-    position_delete(index);
+    copyBlock(dst, src);
+    if (src->ufParent != NULL) {
+        memcpy(dst->ufParent, src->ufParent, (uint8_t *)src->worklist - (uint8_t *)src->ufParent);
+    } else {
+        free(dst->ufParent);
+        dst->ufParent = NULL;
+    }
+    if (src->distance != NULL) {
+        memcpy(dst->distance, src->distance, (uint8_t *)src->repair - (uint8_t *)src->distance);
+    } else {
+        distanceFree(dst);
+    }
+    dst->inference = src->inference;
+    return true;
+}
 
-    // Check whether the value matches that of a wall, and return
-    if (value != mp->wallNum) {
+/**************** map_copyEdges ****************/
+/* Copies the edges, wall masks, dead-end bitmap and target of the map src into dst, a map of the
+ * same size, for a reader which only draws or saves the maze. Returns false, leaving dst alone,
+ * if the sizes differ. dst is left without inference or a distance field.
+ * Memory: does not allocate memory, and frees dst's inference and distance arrays if it has any
+ */
+bool map_copyEdges(map_t *dst, map_t *src)
+{
+    if (dst->mazeWidth != src->mazeWidth || dst->mazeHeight != src->mazeHeight) {
         return false;
     }
+    copyBlock(dst, src);
+    free(dst->ufParent);
+    dst->ufParent = NULL;
+    dst->inference = false;
+    distanceFree(dst);
     return true;
 }
 
-/**************** map_isWallXY ****************/
-/* XY version of map_isWall
- * Boolean return for whether a wall exists between position 1 and position 2
- * Input: pointer to a valid map and two position objects
- * Returns true if a wall exists, false otherwise
+/**************** copyBlock ****************/
+/* Copies the edge planes, wall masks and dead-end bitmap of src into dst, a map of the same size,
+ * with its counts and target. The three planes and the bitmap are one run of the block.
  */
-bool map_isWallXY(map_t *mp, int x1, int y1, int x2, int y2)
+static void copyBlock(map_t *dst, map_t *src)
 {
-    // Check validity of points
-    if ( !map_validXY(mp, x1, y1) || !map_validXY(mp, x2, y2) ) {
-        return true;
-    } 
-
-    // Construct position objects
-    position_t* pos1 = position_new();
-    position_setX(pos1, x1);
-    position_setY(pos1, y1);
-
-    position_t* pos2 = position_new();
-    position_setX(pos2, x2);
-    position_setY(pos2, y2);
-
-    // Get the data position of the spot representing this cell-to-cell connection
-    position_t *index = findDataLocation(mp, pos1, pos2);
-    if (index == NULL) {
-        position_delete(pos1);
-        position_delete(pos2);
-        return false;
+    memcpy(dst->hEdges, src->hEdges, (uint8_t *)src + src->blockBytes - src->hEdges);
+    dst->inferredEdges = src->inferredEdges;
+    dst->wallChanges = src->wallChanges;
+    dst->targetX = src->targetX;
+    dst->targetY = src->targetY;
+}
+
+/**************** map_packedSize ****************/
+/* Returns the number of bytes map_pack writes for the map: both edge planes, 2 bits an edge
+ */
+size_t map_packedSize(map_t *mp)
+{
+    return planeBytes((mp->mazeWidth - 1) * mp->mazeHeight) + planeBytes(mp->mazeWidth * (mp->mazeHeight - 1));
+}
+
+/**************** map_pack ****************/
+/* Writes the map's edges to buf, map_packedSize bytes: the horizontal edge plane, then the vertical
+ * one, as they are stored. The target, the count of inferred edges and all the map derives from its
+ * edges are left out.
+ * Memory: does not allocate memory
+ */
+void map_pack(map_t *mp, uint8_t *buf)
+{
+    size_t hBytes = planeBytes((mp->mazeWidth - 1) * mp->mazeHeight);
+    memcpy(buf, mp->hEdges, hBytes);
+    memcpy(buf + hBytes, mp->vEdges, planeBytes(mp->mazeWidth * (mp->mazeHeight - 1)));
+}
+
+/**************** map_unpack ****************/
+/* Sets the edges of mp, a map of the size buf was packed from, to those packed in buf, and rebuilds
+ * the wall masks, and the components of open edges and the distance field (to the map's own target), if
+ * it keeps them, from them. No edge is inferred: buf is taken to hold every edge its map had inferred.
+ * Memory: does not allocate memory
+ */
+void map_unpack(map_t *mp, const uint8_t *buf)
+{
+    size_t hBytes = planeBytes((mp->mazeWidth - 1) * mp->mazeHeight);
+    memcpy(mp->hEdges, buf, hBytes);
+    memcpy(mp->vEdges, buf + hBytes, planeBytes(mp->mazeWidth * (mp->mazeHeight - 1)));
+
+    // Wall masks: the border, and every wall known
+    int cells = mp->mazeWidth * mp->mazeHeight;
+    for (int cell = 0; cell < cells; cell++) {
+        int x = cell % mp->mazeWidth;
+        int y = cell / mp->mazeWidth;
+        setMaskBit(mp->wallMasks, cell, MAP_WALL_WEST, x == 0);
+        setMaskBit(mp->wallMasks, cell, MAP_WALL_NORTH, y == 0);
+        setMaskBit(mp->wallMasks, cell, MAP_WALL_SOUTH, y == mp->mazeHeight - 1);
+        setMaskBit(mp->wallMasks, cell, MAP_WALL_EAST, x == mp->mazeWidth - 1);
     }
 
-    // Get the value of the cell
-    int value = mp->columns[position_getX(index)][position_getY(index)];
-    position_delete(index);
+    // Components, if the map keeps them: every cell on its own, then joined along each open edge
+    if (mp->ufParent != NULL) {
+        ufReset(mp);
+    }
+    for (int cell = 0; cell < cells; cell++) {
+        int x = cell % mp->mazeWidth;
+        int y = cell / mp->mazeWidth;
+        for (int dir = M_SOUTH; dir <= M_EAST; dir++) {
+            map_cell_t here = {x, y};
+            map_cell_t there = {x + DIR_DX[dir], y + DIR_DY[dir]};
+            map_state_t state = map_getEdge(mp, here, there);
+            if (state == MAP_WALL) {
+                setMaskBit(mp->wallMasks, cell, 1 << dir, true);
+                setMaskBit(mp->wallMasks, there.y * mp->mazeWidth + there.x, 1 << (M_NUM_DIRECTIONS - 1 - dir), true);
+            } else if (state == MAP_OPEN && mp->ufParent != NULL) {
+                int rootA = ufFind(mp, cell);
+                int rootB = ufFind(mp, there.y * mp->mazeWidth + there.x);
+                if (rootA != rootB) {
+                    bool aSmaller = mp->ufParent[rootA] > mp->ufParent[rootB];
+                    ufLink(mp, aSmaller ? rootA : rootB, aSmaller ? rootB : rootA);
+                }
+            }
+        }
+    }
 
-    // Free memory
-    position_delete(pos1);
-    position_delete(pos2);
+    mp->wallChanges++;
+    distanceRebuild(mp);
+}
 
-    // Check whether the value matches that of a wall, and return
-    if (value != mp->wallNum) {
+/**************** map_getEdge ****************/
+/* Value-typed core of every getter. Returns the state (MAP_UNKNOWN, MAP_OPEN or MAP_WALL) of
+ * the relationship between cell 1 and cell 2, or MAP_INVALID if the cells are off the map or
+ * are not cardinal neighbors.
+ * Memory: does not allocate memory
+ */
+map_state_t map_getEdge(map_t *mp, map_cell_t c1, map_cell_t c2)
+{
+    uint8_t *plane;
+    int index;
+    if (!findDataLocation(mp, c1.x, c1.y, c2.x, c2.y, &plane, &index)) {
+        return MAP_INVALID;
+    }
+    return (map_state_t)getEdge(plane, index);
+}
+
+/**************** map_setEdge ****************/
+/* Value-typed core of every setter. Sets the relationship between cell 1 and cell 2 to state.
+ * With inference enabled, then infers every edge that follows from the change.
+ * Returns true if successful, false if the cells are off the map or are not cardinal neighbors
+ * Memory: does not allocate memory
+ */
+bool map_setEdge(map_t *mp, map_cell_t c1, map_cell_t c2, map_state_t state)
+{
+    if (!writeEdge(mp, c1, c2, state)) {
         return false;
     }
+    if (mp->inference) {
+        int cell1 = c1.y * mp->mazeWidth + c1.x;
+        int cell2 = c2.y * mp->mazeWidth + c2.x;
+        if (state == MAP_OPEN) {
+            // Newly connected cells: unknown edges between them are walls
+            ufUnite(mp, cell1, cell2);
+        } else if (state == MAP_WALL) {
+            // Both cells gained a wall, and may now be walled on three sides
+            pushCell(mp, cell1);
+            pushCell(mp, cell2);
+        }
+        runInference(mp);
+    }
     return true;
 }
 
-/**************** map_setWall ****************/
-/* For the positions given by the user, set the relationship between the cells to the value of 'wall'
- * Returns true if successful, false otherwise
+/**************** map_setInference ****************/
+/* Turns edge inference on or off. It is off for a new map. Turning it on does not go back over
+ * edges set earlier, so turn it on before any edge is set.
+ * Returns false, leaving inference off, if the arrays behind it could not be allocated.
+ * Memory: the first time inference is turned on, allocates its arrays (13 bytes a cell), which
+ * the map keeps until map_delete
  */
-bool map_setWall(map_t *mp, position_t *pos1, position_t *pos2)
+bool map_setInference(map_t *mp, bool enabled)
 {
-    // Get the position in the array
-    // If the position pair given is invalid, then return false
-    position_t *index = findDataLocation(mp, pos1, pos2);
-    if (index == NULL) {
+    if (enabled && !inferenceAlloc(mp)) {
         return false;
     }
-
-    // Otherwise, set the position in the array for the value of 'wall'
-    mp->columns[position_getX(index)][position_getY(index)] = mp->wallNum;
-    position_delete(index);
+    mp->inference = enabled;
     return true;
 }
 
-/**************** map_setWallXY ****************/
-/* XY version of map_setWall
- * For the positions given by the user, set the relationship between the cells to the value of 'wall'
- * Returns true if successful, false otherwise
+/**************** map_getInferredCount ****************/
+/* Returns the number of edges inferred so far (walls and open sides alike). Each one is a
+ * probe the avatars no longer need to make.
  */
-bool map_setWallXY(map_t *mp, int x1, int y1, int x2, int y2){
-    
-    // Convert the given Cartesian pairs to position structs
-    position_t* pos1 = position_new();
-    position_setX(pos1, x1);
-    position_setY(pos1, y1);
-
-    position_t* pos2 = position_new();
-    position_setX(pos2, x2);
-    position_setY(pos2, y2);
-
-    // Find the data location of the relationship between the positions
-    // If the location isn't valid and a NULL is returned, close data and return false
-    position_t *index = findDataLocation(mp, pos1, pos2);
-    if (index == NULL) {
-        position_delete(pos1);
-        position_delete(pos2);
+int map_getInferredCount(map_t *mp)
+{
+    return mp->inferredEdges;
+}
+
+/**************** map_getWallChanges ****************/
+/* Returns the number of times an edge became, or stopped being, a wall (an unpack counts as one).
+ * Anything worked out from the walls alone still holds while it is unchanged.
+ */
+int map_getWallChanges(map_t *mp)
+{
+    return mp->wallChanges;
+}
+
+/**************** map_isConnectedXY ****************/
+/* Returns true if a path of known-open edges joins (x1, y1) and (x2, y2). Inference keeps track
+ * of the cells joined by open edges, so this is O(1) amortized; with inference off nothing is
+ * tracked, and it returns true for any two cells on the map, leaving the caller to search.
+ * Returns false if either cell is off the map.
+ */
+bool map_isConnectedXY(map_t *mp, int x1, int y1, int x2, int y2)
+{
+    if (!map_validXY(mp, x1, y1) || !map_validXY(mp, x2, y2)) {
         return false;
     }
+    if (!mp->inference) {
+        return true;
+    }
+    return ufFind(mp, y1 * mp->mazeWidth + x1) == ufFind(mp, y2 * mp->mazeWidth + x2);
+}
 
-    // Otherwise, set the value of the relationship between cells to 'wall'
-    mp->columns[position_getX(index)][position_getY(index)] = mp->wallNum;
-    position_delete(index);
-        
-    // Free memory
-    position_delete(pos1);
-    position_delete(pos2);
+/**************** writeEdge ****************/
+/* Stores state for the relationship between cell 1 and cell 2, and keeps the wall masks of
+ * both cells and the distance field in sync. Does no inference.
+ * Returns true if successful, false if the cells are off the map or are not cardinal neighbors
+ */
+static bool writeEdge(map_t *mp, map_cell_t c1, map_cell_t c2, map_state_t state)
+{
+    uint8_t *plane;
+    int index;
+    if (!findDataLocation(mp, c1.x, c1.y, c2.x, c2.y, &plane, &index)) {
+        return false;
+    }
+    bool wasWall = (getEdge(plane, index) == MAP_WALL);
+    setEdge(plane, index, state);
+    if (wasWall != (state == MAP_WALL)) {
+        mp->wallChanges++;
+    }
 
+    // Keep the wall masks of both cells in sync: the side of cell 1 facing cell 2, and the opposite side of cell 2
+    int bit1;
+    int bit2;
+    if (c2.x > c1.x) {
+        bit1 = MAP_WALL_EAST;
+        bit2 = MAP_WALL_WEST;
+    } else if (c2.x < c1.x) {
+        bit1 = MAP_WALL_WEST;
+        bit2 = MAP_WALL_EAST;
+    } else if (c2.y > c1.y) {
+        bit1 = MAP_WALL_SOUTH;
+        bit2 = MAP_WALL_NORTH;
+    } else {
+        bit1 = MAP_WALL_NORTH;
+        bit2 = MAP_WALL_SOUTH;
+    }
+    setMaskBit(mp->wallMasks, c1.y * mp->mazeWidth + c1.x, bit1, state == MAP_WALL);
+    setMaskBit(mp->wallMasks, c2.y * mp->mazeWidth + c2.x, bit2, state == MAP_WALL);
+
+    // Repair the distance field if the edge became, or stopped being, a wall, or rebuild it if the repair heap could not grow
+    if (mp->distance != NULL && map_validXY(mp, mp->targetX, mp->targetY) && wasWall != (state == MAP_WALL)) {
+        int cell1 = c1.y * mp->mazeWidth + c1.x;
+        int cell2 = c2.y * mp->mazeWidth + c2.x;
+        if (state == MAP_WALL) {
+            distanceRaise(mp, cell1, cell2);
+        } else {
+            distanceLower(mp, cell1, cell2);
+        }
+        if (mp->heapOverflow) {
+            distanceRebuild(mp);
+        }
+    }
     return true;
 }
 
-/**************** map_isOpen ****************/
-/* Boolean return for whether a wall exists between position 1 and position 2
- * Input: pointer to a valid map and two position objects
- * Returns true if the path is open, false otherwise
+/**************** map_wallMask ****************/
+/* Returns the 4-bit wall mask of the cell at (x, y): the OR of MAP_WALL_WEST, MAP_WALL_NORTH,
+ * MAP_WALL_SOUTH and MAP_WALL_EAST for each side known to be a wall. Sides on the border of
+ * the maze are always walls. A cell off the map is reported as walled on every side.
+ * Memory: does not allocate memory
  */
-bool map_isOpen(map_t *mp, position_t *pos1, position_t *pos2)
+int map_wallMask(map_t *mp, int x, int y)
 {
-
-    // Get the value of the spot representing this cell-to-cell connection
-    position_t *index = findDataLocation(mp, pos1, pos2);
-    if (index == NULL) {
-        return false;
+    if ((unsigned)x >= (unsigned)mp->mazeWidth || (unsigned)y >= (unsigned)mp->mazeHeight) {
+        return MAP_WALL_ALL;
     }
+    return getMask(mp->wallMasks, y * mp->mazeWidth + x);
+}
 
-    // Get the value of the position stored at this data cell
-    int value = mp->columns[position_getX(index)][position_getY(index)];
-    position_delete(index);
+/**************** map_wallCount ****************/
+/* Returns the number of sides (0-4) of the cell at (x, y) known to be walls, counting the
+ * border of the maze as walls
+ */
+int map_wallCount(map_t *mp, int x, int y)
+{
+    return __builtin_popcount(map_wallMask(mp, x, y));
+}
 
-    // Check whether the value matches that of a wall, and return
-    if (value != mp->openNum) {
+/**************** map_setTargetXY ****************/
+/* Sets the meeting point of the avatars. Dead-end filling never seals the meeting point,
+ * however many of its sides are walls. Moves the distance field to the new target, repairing
+ * only the cells whose distance changes if there was a target before, or builds it if not.
+ * Returns false, leaving the target as it was, if the distance field could not be allocated;
+ * once a map has one, it always returns true.
+ * Memory: the first time a target on the map is set, allocates the distance field (9 bytes a
+ * cell), which the map keeps until map_delete
+ */
+bool map_setTargetXY(map_t *mp, int x, int y)
+{
+    bool hadField = mp->distance != NULL && map_validXY(mp, mp->targetX, mp->targetY);
+    if (hadField && x == mp->targetX && y == mp->targetY) {
+        return true;
+    }
+    if (map_validXY(mp, x, y) && !distanceAlloc(mp)) {
         return false;
     }
+    int from = mp->targetY * mp->mazeWidth + mp->targetX;
+    mp->targetX = x;
+    mp->targetY = y;
+    if (hadField && map_validXY(mp, x, y)) {
+        distanceRetarget(mp, from, y * mp->mazeWidth + x);
+        if (mp->heapOverflow) {
+            distanceRebuild(mp);
+        }
+    } else {
+        distanceRebuild(mp);
+    }
     return true;
 }
 
-/**************** map_isOpenXY ****************/
-/* XY version of map_isOpen
- * Boolean return for whether a wall exists between position 1 and position 2
- * Input: pointer to a valid map and two position objects
- * Returns true if the path is open, false otherwise
+/**************** map_getTargetX ****************/
+/* Returns the x coordinate of the meeting point, or -1 if none has been set
  */
-bool map_isOpenXY(map_t *mp, int x1, int y1, int x2, int y2)
+int map_getTargetX(map_t *mp)
 {
-    // Convert the Cartesian inputs into position structs
-    position_t* pos1 = position_new();
-    position_setX(pos1, x1);
-    position_setY(pos1, y1);
+    return mp->targetX;
+}
 
-    position_t* pos2 = position_new();
-    position_setX(pos2, x2);
-    position_setY(pos2, y2);
+/**************** map_getTargetY ****************/
+/* Returns the y coordinate of the meeting point, or -1 if none has been set
+ */
+int map_getTargetY(map_t *mp)
+{
+    return mp->targetY;
+}
 
-    // Get the value of the spot representing this cell-to-cell connection
-    position_t *index = findDataLocation(mp, pos1, pos2);
-    if (index == NULL) {
-        position_delete(pos1);
-        position_delete(pos2);
-        return false;
+/**************** map_distanceXY ****************/
+/* Returns the number of steps from (x, y) to the target over edges not known to be walls,
+ * or -1 if there is no target, (x, y) is off the map, or walls cut it off from the target.
+ * Memory: does not allocate memory
+ */
+int map_distanceXY(map_t *mp, int x, int y)
+{
+    if (mp->distance == NULL || !map_validXY(mp, x, y) || mp->distance[y * mp->mazeWidth + x] == MAP_UNREACHABLE) {
+        return -1;
     }
+    return mp->distance[y * mp->mazeWidth + x];
+}
 
-    // Get the value of the position stored at this data cell
-    int value = mp->columns[position_getX(index)][position_getY(index)];
-    position_delete(index);
+/**************** map_nextStepXY ****************/
+/* Returns the direction (M_WEST, M_NORTH, M_SOUTH or M_EAST) of a step from (x, y) to a neighbor
+ * one step closer to the target, across an edge which is not a wall. A known-open edge is
+ * preferred over an unknown one, since the unknown one may yet turn out to be a wall.
+ * Returns M_NULL_MOVE at the target, and wherever map_distanceXY is -1.
+ * Memory: does not allocate memory. Reads only the cell's wall mask and four distances.
+ */
+int map_nextStepXY(map_t *mp, int x, int y)
+{
+    int here = map_distanceXY(mp, x, y);
+    if (here <= 0) {
+        return M_NULL_MOVE;
+    }
+    int cell = y * mp->mazeWidth + x;
+    int mask = getMask(mp->wallMasks, cell);
+    int best = M_NULL_MOVE;
+    for (int dir = 0; dir < M_NUM_DIRECTIONS; dir++) {
+        if ((mask & (1 << dir)) || mp->distance[neighborOf(mp, cell, dir)] != here - 1) {
+            continue;
+        }
+        map_cell_t from = {x, y};
+        map_cell_t to = {x + DIR_DX[dir], y + DIR_DY[dir]};
+        if (map_getEdge(mp, from, to) == MAP_OPEN) {
+            return dir;
+        }
+        if (best == M_NULL_MOVE) {
+            best = dir;
+        }
+    }
+    return best;
+}
 
-    // Free memory
-    position_delete(pos1);
-    position_delete(pos2);
+/**************** map_fillDeadEnds ****************/
+/* Seals the known dead end at (x, y), if there is one, and every cell that becomes a dead end
+ * as a result. A dead end is a cell walled on exactly three sides which holds no avatar placed
+ * in occ and is not the meeting point set by map_setTargetXY. Sealing sets a wall on the
+ * remaining side, which adds a wall to the neighbor on that side, so the neighbor is checked
+ * next; the walk stops at the first cell which is not a dead end.
+ * Call this for both cells of every newly learned wall, and for every cell an avatar leaves.
+ * Returns the number of cells sealed (0 if (x, y) was not a dead end).
+ * Memory: does not allocate memory. occ is only read.
+ */
+int map_fillDeadEnds(map_t *mp, int x, int y, occupancy_t *occ)
+{
+    int sealed = 0;
 
-    // Check whether the value matches that of a wall, and return
-    if (value != mp->openNum) {
-        return false;
+    // Each sealed cell can only make its one open neighbor a new dead end, so the worklist
+    // never holds more than the single cell being examined
+    while (map_wallCount(mp, x, y) == 3) {
+
+        // Never seal the meeting point or a cell an avatar is standing in
+        if (x == mp->targetX && y == mp->targetY) {
+            break;
+        }
+        if (occupancy_count(occ, x, y) != 0) {
+            break;
+        }
+
+        // Wall off the one side which is not yet a wall
+        int dir = __builtin_ctz(~map_wallMask(mp, x, y) & MAP_WALL_ALL);
+        map_cell_t cell = {x, y};
+        map_cell_t next = {x + DIR_DX[dir], y + DIR_DY[dir]};
+        map_setEdge(mp, cell, next, MAP_WALL);
+        sealed++;
+
+        // Continue with the neighbor which just gained a wall
+        x = next.x;
+        y = next.y;
     }
-    return true;
+
+    return sealed;
 }
 
-/**************** map_setOpen ****************/
-/* For the positions given by the user, set the relationship between the cells to the value of 'open'
- * Returns true if successful, false otherwise
+/**************** map_findDeadEnds ****************/
+/* Finds every dead end on the map in one pass over the wall mask plane: every cell walled on
+ * exactly three sides, other than the meeting point. Occupancy is not checked here.
+ * Writes the result into the map's dead-end bitmap, where cell (x, y) is bit (y*MazeWidth + x) % 64
+ * of word (y*MazeWidth + x) / 64, and points *bitmap at it if bitmap is not NULL. The bitmap stays
+ * valid until the next call on the same map.
+ * Returns the number of dead ends found.
+ * Memory: does not allocate memory.
  */
-bool map_setOpen(map_t *mp, position_t *pos1, position_t *pos2)
+int map_findDeadEnds(map_t *mp, const uint64_t **bitmap)
 {
-    // Get the position in the array
-    // If the position pair given is invalid, then return false
-    position_t *index = findDataLocation(mp, pos1, pos2);
-    if (index == NULL) {
-        return false;
+    // Pick the widest kernel this CPU supports
+#ifdef MAP_X86_KERNELS
+#ifndef MAP_NO_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        sweepAVX2(mp->wallMasks, mp->maskBytes, mp->deadEnds);
+    } else
+#endif
+    if (__builtin_cpu_supports("sse2")) {
+        sweepSSE2(mp->wallMasks, mp->maskBytes, mp->deadEnds);
+    } else {
+        sweepScalar(mp->wallMasks, mp->maskBytes, mp->deadEnds);
+    }
+#else
+    sweepScalar(mp->wallMasks, mp->maskBytes, mp->deadEnds);
+#endif
+
+    // The meeting point is never a dead end
+    if (map_validXY(mp, mp->targetX, mp->targetY)) {
+        int target = mp->targetY * mp->mazeWidth + mp->targetX;
+        mp->deadEnds[target / 64] &= ~((uint64_t)1 << (target % 64));
     }
 
-    // Otherwise, set the position in the array for the value of 'wall'
-    mp->columns[position_getX(index)][position_getY(index)] = mp->openNum;
-    position_delete(index);
-    return true;
+    if (bitmap != NULL) {
+        *bitmap = mp->deadEnds;
+    }
+    int found = 0;
+    for (size_t w = 0; w < mp->maskBytes / 32; w++) {
+        found += __builtin_popcountll(mp->deadEnds[w]);
+    }
+    return found;
 }
 
-
-/**************** map_setOpenXY ****************/
-/* XY version of map_setOpen
- * For the positions given by the user, set the relationship between the cells to the value of 'open'
- * Returns true if successful, false otherwise
+/**************** map_sweepDeadEnds ****************/
+/* Finds every dead end on the map with map_findDeadEnds and seals each one with map_fillDeadEnds,
+ * so that whole blind corridors collapse. Meant to be called after a burst of discovery, when
+ * calling map_fillDeadEnds cell by cell would mean checking many cells which are not dead ends.
+ * Returns the number of cells sealed.
+ * Memory: does not allocate memory. occ is only read.
  */
-bool map_setOpenXY(map_t *mp, int x1, int y1, int x2, int y2)
+int map_sweepDeadEnds(map_t *mp, occupancy_t *occ)
 {
+    if (map_findDeadEnds(mp, NULL) == 0) {
+        return 0;
+    }
 
-    // Convert the Cartesian coordinates into position structs
-    position_t* pos1 = position_new();
-    position_setX(pos1, x1);
-    position_setY(pos1, y1);
+    // Fill from every dead end found. A fill which runs into a dead end further on in the
+    // bitmap seals it too, and the fill started there later finds four walls and stops at once.
+    int sealed = 0;
+    for (size_t w = 0; w < mp->maskBytes / 32; w++) {
+        uint64_t bits = mp->deadEnds[w];
+        while (bits != 0) {
+            int cell = (int)(w * 64) + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            sealed += map_fillDeadEnds(mp, cell % mp->mazeWidth, cell / mp->mazeWidth, occ);
+        }
+    }
+    return sealed;
+}
 
-    position_t* pos2 = position_new();
-    position_setX(pos2, x2);
-    position_setY(pos2, y2);
+/**************** map_isWall ****************/
+/* Boolean return for whether a wall exists between position 1 and position 2
+ * Input: pointer to a valid map and two position objects
+ * Returns true if a wall exists or either position is off the map, false otherwise
+ */
+bool map_isWall(map_t *mp, position_t *pos1, position_t *pos2)
+{
+    return map_isWallXY(mp, position_getX(pos1), position_getY(pos1), position_getX(pos2), position_getY(pos2));
+}
 
-    // Find the data location associated with the relationship between these two points
-    // If the function returns NULL, indicating invalid inputs, close memory and return false
-    position_t *index = findDataLocation(mp, pos1, pos2);
-    if (index == NULL) {
-        position_delete(pos1);
-        position_delete(pos2);
-        return false;
+/**************** map_isWallXY ****************/
+/* XY version of map_isWall
+ * Boolean return for whether a wall exists between position 1 and position 2
+ * Input: pointer to a valid map and two Cartesian coordinate pairs
+ * Returns true if a wall exists or either position is off the map, false otherwise
+ */
+bool map_isWallXY(map_t *mp, int x1, int y1, int x2, int y2)
+{
+    uint8_t *plane;
+    int index;
+    if (!findDataLocation(mp, x1, y1, x2, y2, &plane, &index)) {
+        // Positions off the map are treated as walled off; on-map pairs which are not neighbors are not
+        return !map_validXY(mp, x1, y1) || !map_validXY(mp, x2, y2);
     }
 
-    // Set the value of the data location
-    mp->columns[position_getX(index)][position_getY(index)] = mp->openNum;
-    position_delete(index);
-    
-    // Free memory
-    position_delete(pos1);
-    position_delete(pos2);
+    // Check whether the value matches that of a wall, and return
+    return getEdge(plane, index) == MAP_WALL;
+}
 
-    return true;
+/**************** map_setWall ****************/
+/* For the positions given by the user, set the relationship between the cells to the value of 'wall'
+ * Returns true if successful, false otherwise
+ */
+bool map_setWall(map_t *mp, position_t *pos1, position_t *pos2)
+{
+    return map_setEdge(mp, cellOf(pos1), cellOf(pos2), MAP_WALL);
+}
+
+/**************** map_setWallXY ****************/
+/* XY version of map_setWall
+ * For the positions given by the user, set the relationship between the cells to the value of 'wall'
+ * Returns true if successful, false otherwise
+ */
+bool map_setWallXY(map_t *mp, int x1, int y1, int x2, int y2)
+{
+    map_cell_t c1 = {x1, y1};
+    map_cell_t c2 = {x2, y2};
+    return map_setEdge(mp, c1, c2, MAP_WALL);
+}
 
+/**************** map_isOpen ****************/
+/* Boolean return for whether the path between position 1 and position 2 is open
+ * Input: pointer to a valid map and two position objects
+ * Returns true if the path is open, false otherwise
+ */
+bool map_isOpen(map_t *mp, position_t *pos1, position_t *pos2)
+{
+    return map_getEdge(mp, cellOf(pos1), cellOf(pos2)) == MAP_OPEN;
+}
 
+/**************** map_isOpenXY ****************/
+/* XY version of map_isOpen
+ * Boolean return for whether the path between position 1 and position 2 is open
+ * Input: pointer to a valid map and two Cartesian coordinate pairs
+ * Returns true if the path is open, false otherwise
+ */
+bool map_isOpenXY(map_t *mp, int x1, int y1, int x2, int y2)
+{
+    map_cell_t c1 = {x1, y1};
+    map_cell_t c2 = {x2, y2};
+    return map_getEdge(mp, c1, c2) == MAP_OPEN;
 }
 
+/**************** map_setOpen ****************/
+/* For the positions given by the user, set the relationship between the cells to the value of 'open'
+ * Returns true if successful, false otherwise
+ */
+bool map_setOpen(map_t *mp, position_t *pos1, position_t *pos2)
+{
+    return map_setEdge(mp, cellOf(pos1), cellOf(pos2), MAP_OPEN);
+}
+
+/**************** map_setOpenXY ****************/
+/* XY version of map_setOpen
+ * For the positions given by the user, set the relationship between the cells to the value of 'open'
+ * Returns true if successful, false otherwise
+ */
+bool map_setOpenXY(map_t *mp, int x1, int y1, int x2, int y2)
+{
+    map_cell_t c1 = {x1, y1};
+    map_cell_t c2 = {x2, y2};
+    return map_setEdge(mp, c1, c2, MAP_OPEN);
+}
 
 /**************** map_isUnknown ****************/
-/* Boolean return for whether a wall exists between position 1 and position 2
+/* Boolean return for whether the relationship between position 1 and position 2 is unknown
  * Input: pointer to a valid map and two position objects
  * Returns true if the path status is unknown, false otherwise
  */
 bool map_isUnknown(map_t *mp, position_t *pos1, position_t *pos2)
 {
-
-    // Get the value of the spot representing this cell-to-cell connection
-    position_t *index = findDataLocation(mp, pos1, pos2);
-    if (index == NULL) {
-        return false;
-    }
-    int value = mp->columns[position_getX(index)][position_getY(index)];
-    position_delete(index);
-
-    // Check whether the value matches that of a wall, and return
-    if (value != mp->unknownNum) {
-        return false;
-    }
-    return true;
+    return map_getEdge(mp, cellOf(pos1), cellOf(pos2)) == MAP_UNKNOWN;
 }
 
 /**************** map_isUnknownXY ****************/
 /* XY version of map_isUnknown
- * Boolean return for whether a wall exists between position 1 and position 2
- * Input: pointer to a valid map and two position objects
+ * Boolean return for whether the relationship between position 1 and position 2 is unknown
+ * Input: pointer to a valid map and two Cartesian coordinate pairs
  * Returns true if the path status is unknown, false otherwise
  */
 bool map_isUnknownXY(map_t *mp, int x1, int y1, int x2, int y2)
 {
-    position_t* pos1 = position_new();
-    position_setX(pos1, x1);
-    position_setY(pos1, y1);
-
-    position_t* pos2 = position_new();
-    position_setX(pos2, x2);
-    position_setY(pos2, y2);
-
-    // Get the value of the spot representing this cell-to-cell connection
-    position_t *index = findDataLocation(mp, pos1, pos2);
-    if (index == NULL) {
-        position_delete(pos1);
-        position_delete(pos2);
-        return false;
-    }
-    int value = mp->columns[position_getX(index)][position_getY(index)];
-    position_delete(index);
-
-    position_delete(pos1);
-    position_delete(pos2);
-
-    // Check whether the value matches that of a wall, and return
-    if (value != mp->unknownNum) {
-        return false;
-    }
-    return true;
+    map_cell_t c1 = {x1, y1};
+    map_cell_t c2 = {x2, y2};
+    return map_getEdge(mp, c1, c2) == MAP_UNKNOWN;
 }
 
 /**************** map_setUnknown ****************/
@@ -441,19 +901,9 @@ bool map_isUnknownXY(map_t *mp, int x1, int y1, int x2, int y2)
  */
 bool map_setUnknown(map_t *mp, position_t *pos1, position_t *pos2)
 {
-    // Get the value of the spot representing this cell-to-cell connection
-    position_t *index = findDataLocation(mp, pos1, pos2);
-    if (index == NULL) {
-        return false;
-    }
-
-    // Set the value of the data location to 'unknown'
-    mp->columns[position_getX(index)][position_getY(index)] = mp->unknownNum;
-    position_delete(index);
-    return true;
+    return map_setEdge(mp, cellOf(pos1), cellOf(pos2), MAP_UNKNOWN);
 }
 
-
 /**************** map_setUnknownXY ****************/
 /* XY version of setUnknown
  * For the positions given by the user, set the relationship between the cells to the value of 'unknown'
@@ -461,32 +911,9 @@ bool map_setUnknown(map_t *mp, position_t *pos1, position_t *pos2)
  */
 bool map_setUnknownXY(map_t *mp, int x1, int y1, int x2, int y2)
 {
-    // Convert Cartesian coordinates into position structs
-    position_t* pos1 = position_new();
-    position_setX(pos1, x1);
-    position_setY(pos1, y1);
-
-    position_t* pos2 = position_new();
-    position_setX(pos2, x2);
-    position_setY(pos2, y2);
-
-    // Find the data location of the relationships between data positions
-    position_t *index = findDataLocation(mp, pos1, pos2);
-    if (index == NULL) {
-        position_delete(pos1);
-        position_delete(pos2);
-        return false;
-    }
-
-    // Set the value of the data location to 'unknown'
-    mp->columns[position_getX(index)][position_getY(index)] = mp->openNum;
-    position_delete(index);
-        
-    // Free temporary memory
-    position_delete(pos1);
-    position_delete(pos2);
-
-    return true;
+    map_cell_t c1 = {x1, y1};
+    map_cell_t c2 = {x2, y2};
+    return map_setEdge(mp, c1, c2, MAP_UNKNOWN);
 }
 
 /**************** map_validXY ****************/
@@ -543,40 +970,643 @@ int map_getMazeWidth(map_t *mp) {
     return mp->mazeWidth;
 }
 
+/**************** map_getMazeHeight ****************/
+/* Returns the maze height*/
+int map_getMazeHeight(map_t *mp) {
+    return mp->mazeHeight;
+}
+
 /**************** findDataLocation ****************/
-/* For a given map and a pair of points expressed as position structs, returns a position struct
- * containing the data location of the relationship between the positions in the map 
- * Returns a newly allocated position struct if relationship found; returns NULL if the relationship
- * was invalid.
- * Memory: Allocates fresh memory for the position struct. Caller is responsible for calling
- * position_delete() on this struct. 
+/* For a given map and a pair of points expressed as Cartesian coordinates, finds the edge plane
+ * and the index within that plane which store the relationship between the points.
+ * Returns true and writes plane and index if the relationship was found; returns false if 
+ * the points are off the map or are not cardinal neighbors.
+ * Memory: does not allocate memory. plane is set to point into the map's own storage.
  */
-static position_t *findDataLocation(map_t *mp, position_t *pos1, position_t *pos2)
+static inline bool findDataLocation(map_t *mp, int x1, int y1, int x2, int y2, uint8_t **plane, int *index)
 {
-    // Check for not a neighbor pair or invalid points, and if so, print error and return NULL
-    if (!map_neighborAndValidXY(mp, position_getX(pos1), position_getY(pos1), position_getX(pos2), position_getY(pos2))) {
-        return NULL;
+    // Both points must be on the map
+    if ((unsigned)x1 >= (unsigned)mp->mazeWidth || (unsigned)y1 >= (unsigned)mp->mazeHeight ||
+        (unsigned)x2 >= (unsigned)mp->mazeWidth || (unsigned)y2 >= (unsigned)mp->mazeHeight) {
+        return false;
+    }
+
+    // Points sharing a row one column apart are joined by a horizontal edge, stored against the western cell
+    int x_difference = x2 - x1;
+    int y_difference = y2 - y1;
+    if (y_difference == 0 && (x_difference == 1 || x_difference == -1)) {
+        *plane = mp->hEdges;
+        *index = y1 * (mp->mazeWidth - 1) + (x_difference > 0 ? x1 : x2);
+        return true;
     }
 
-    // If input tests pass, then compute the data location
-    int x_index_pos2 = 2*position_getX(pos2);
-    int y_index_pos2 = 2*position_getY(pos2);
+    // Points sharing a column one row apart are joined by a vertical edge, stored against the northern cell
+    if (x_difference == 0 && (y_difference == 1 || y_difference == -1)) {
+        *plane = mp->vEdges;
+        *index = (y_difference > 0 ? y1 : y2) * mp->mazeWidth + x1;
+        return true;
+    }
 
-    // Obtain the Cartesian difference between the two points
-    int x_difference = position_getX(pos2) - position_getX(pos1);
-    int y_difference = position_getY(pos2) - position_getY(pos1);
+    // Otherwise the points are not cardinal neighbors
+    return false;
+}
 
-    // Obtain the map index position of the relationship between the two points (left / right 1, or up / down 1, 
-    // from the second of the given points)
-    int x_index = x_index_pos2 - x_difference;
-    int y_index = y_index_pos2 - y_difference;
+/**************** cellOf ****************/
+/* Converts a position struct into a value-typed map cell
+ */
+static inline map_cell_t cellOf(position_t *pos)
+{
+    map_cell_t cell = {position_getX(pos), position_getY(pos)};
+    return cell;
+}
 
-    // Create a position struct (index) to represent this index location
-    position_t *index = position_new();
-    position_setX(index, x_index);
-    position_setY(index, y_index);
-    
-    // Return the index
-    return index;
+/**************** getEdge ****************/
+/* Returns the 2-bit value stored for the edge at index in the given packed plane
+ */
+static inline int getEdge(uint8_t *plane, int index)
+{
+    return (plane[index >> 2] >> ((index & 3) * 2)) & 3;
 }
 
+/**************** setEdge ****************/
+/* Stores the 2-bit value for the edge at index in the given packed plane, leaving the
+ * three other edges sharing its byte untouched
+ */
+static inline void setEdge(uint8_t *plane, int index, int value)
+{
+    int shift = (index & 3) * 2;
+    plane[index >> 2] = (uint8_t)((plane[index >> 2] & ~(3 << shift)) | ((value & 3) << shift));
+}
+
+/**************** getMask ****************/
+/* Returns the 4-bit wall mask stored for the given cell index in the packed mask plane
+ */
+static inline int getMask(uint8_t *masks, int cell)
+{
+    return (masks[cell >> 1] >> ((cell & 1) * 4)) & 0xF;
+}
+
+/**************** setMaskBit ****************/
+/* Sets (on == true) or clears one wall bit of the given cell index in the packed mask plane
+ */
+static inline void setMaskBit(uint8_t *masks, int cell, int bit, bool on)
+{
+    int shifted = bit << ((cell & 1) * 4);
+    if (on) {
+        masks[cell >> 1] |= shifted;
+    } else {
+        masks[cell >> 1] &= ~shifted;
+    }
+}
+
+/**************** sweepScalar ****************/
+/* Portable dead-end kernel. Reads the wall mask plane eight bytes (16 cells) at a time and sets
+ * bit i of bitmap for every cell i whose mask has exactly three bits set.
+ * Counts the bits of all 16 nibbles at once, then compresses the one flag per nibble to one bit.
+ */
+static void sweepScalar(const uint8_t *masks, size_t maskBytes, uint64_t *bitmap)
+{
+    for (size_t byte = 0; byte < maskBytes; byte += 32) {
+        uint64_t word = 0;
+        for (int part = 0; part < 4; part++) {
+            uint64_t v;
+            memcpy(&v, masks + byte + part * 8, sizeof(v));
+
+            // Wall count of every nibble, then zero the nibbles which hold exactly 3
+            v = v - ((v >> 1) & 0x5555555555555555ULL);
+            v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+            v ^= 0x3333333333333333ULL;
+
+            // Flag (bit 4k) the nibbles which are now zero, and pack the 16 flags into 16 bits
+            v |= v >> 1;
+            v |= v >> 2;
+            v = ~v & 0x1111111111111111ULL;
+            v = (v | (v >> 3)) & 0x0303030303030303ULL;
+            v = (v | (v >> 6)) & 0x000F000F000F000FULL;
+            v = (v | (v >> 12)) & 0x000000FF000000FFULL;
+            v = (v | (v >> 24)) & 0xFFFFULL;
+            word |= v << (part * 16);
+        }
+        bitmap[byte / 32] = word;
+    }
+}
+
+#ifdef MAP_X86_KERNELS
+/**************** sweepSSE2 ****************/
+/* SSE2 dead-end kernel: as sweepScalar, 16 bytes (32 cells) per step. After counting, a byte
+ * compare per nibble gives one flag byte per cell; interleaving the low and high nibble flags
+ * puts them in cell order, so a movemask turns them straight into bitmap bits.
+ */
+__attribute__((target("sse2")))
+static void sweepSSE2(const uint8_t *masks, size_t maskBytes, uint64_t *bitmap)
+{
+    const __m128i m55 = _mm_set1_epi8(0x55);
+    const __m128i m33 = _mm_set1_epi8(0x33);
+    const __m128i lowNibble = _mm_set1_epi8(0x0F);
+    const __m128i highNibble = _mm_set1_epi8((char)0xF0);
+    const __m128i zero = _mm_setzero_si128();
+
+    for (size_t byte = 0; byte < maskBytes; byte += 16) {
+        __m128i v = _mm_load_si128((const __m128i *)(masks + byte));
+
+        // Wall count of every nibble, then zero the nibbles which hold exactly 3
+        v = _mm_sub_epi8(v, _mm_and_si128(_mm_srli_epi16(v, 1), m55));
+        v = _mm_add_epi8(_mm_and_si128(v, m33), _mm_and_si128(_mm_srli_epi16(v, 2), m33));
+        v = _mm_xor_si128(v, m33);
+
+        // One flag byte per cell: even cells live in low nibbles, odd cells in high nibbles
+        __m128i even = _mm_cmpeq_epi8(_mm_and_si128(v, lowNibble), zero);
+        __m128i odd = _mm_cmpeq_epi8(_mm_and_si128(v, highNibble), zero);
+        uint64_t first = (uint16_t)_mm_movemask_epi8(_mm_unpacklo_epi8(even, odd));
+        uint64_t second = (uint16_t)_mm_movemask_epi8(_mm_unpackhi_epi8(even, odd));
+        uint64_t bits = first | (second << 16);
+
+        // Two steps fill one bitmap word
+        if ((byte & 16) == 0) {
+            bitmap[byte / 32] = bits;
+        } else {
+            bitmap[byte / 32] |= bits << 32;
+        }
+    }
+}
+
+#ifndef MAP_NO_AVX2
+/**************** sweepAVX2 ****************/
+/* AVX2 dead-end kernel: as sweepSSE2, 32 bytes (64 cells, one bitmap word) per step. The 256-bit
+ * unpacks interleave within each 128-bit lane, so the two movemasks each hold 16 cells per lane.
+ */
+__attribute__((target("avx2")))
+static void sweepAVX2(const uint8_t *masks, size_t maskBytes, uint64_t *bitmap)
+{
+    const __m256i m55 = _mm256_set1_epi8(0x55);
+    const __m256i m33 = _mm256_set1_epi8(0x33);
+    const __m256i lowNibble = _mm256_set1_epi8(0x0F);
+    const __m256i highNibble = _mm256_set1_epi8((char)0xF0);
+    const __m256i zero = _mm256_setzero_si256();
+
+    for (size_t byte = 0; byte < maskBytes; byte += 32) {
+        __m256i v = _mm256_load_si256((const __m256i *)(masks + byte));
+
+        // Wall count of every nibble, then zero the nibbles which hold exactly 3
+        v = _mm256_sub_epi8(v, _mm256_and_si256(_mm256_srli_epi16(v, 1), m55));
+        v = _mm256_add_epi8(_mm256_and_si256(v, m33), _mm256_and_si256(_mm256_srli_epi16(v, 2), m33));
+        v = _mm256_xor_si256(v, m33);
+
+        // One flag byte per cell, interleaved into cell order within each lane
+        __m256i even = _mm256_cmpeq_epi8(_mm256_and_si256(v, lowNibble), zero);
+        __m256i odd = _mm256_cmpeq_epi8(_mm256_and_si256(v, highNibble), zero);
+        uint64_t lo = (uint32_t)_mm256_movemask_epi8(_mm256_unpacklo_epi8(even, odd));
+        uint64_t hi = (uint32_t)_mm256_movemask_epi8(_mm256_unpackhi_epi8(even, odd));
+
+        // lo holds cells 0-15 and 32-47, hi holds cells 16-31 and 48-63
+        bitmap[byte / 32] = (lo & 0xFFFF) | ((hi & 0xFFFF) << 16) | ((lo >> 16) << 32) | ((hi >> 16) << 48);
+    }
+}
+#endif
+#endif
+
+/**************** ufFind ****************/
+/* Returns the root of the component holding cell, halving the path on the way up
+ */
+static int ufFind(map_t *mp, int cell)
+{
+    while (mp->ufParent[cell] >= 0) {
+        int parent = mp->ufParent[cell];
+        if (mp->ufParent[parent] >= 0) {
+            mp->ufParent[cell] = mp->ufParent[parent];
+        }
+        cell = mp->ufParent[cell];
+    }
+    return cell;
+}
+
+/**************** ufUnite ****************/
+/* Joins the components of cells a and b, which an open edge has just connected. Before joining,
+ * walks the cells of the smaller component and walls off every unknown edge leading into the
+ * larger one, since opening it would close a cycle. No unknown edge is left inside a component,
+ * so these are the only edges that need checking.
+ */
+static void ufUnite(map_t *mp, int a, int b)
+{
+    int rootA = ufFind(mp, a);
+    int rootB = ufFind(mp, b);
+    if (rootA == rootB) {
+        return;
+    }
+
+    // Walk the smaller component (sizes are stored negated)
+    int small = (mp->ufParent[rootA] > mp->ufParent[rootB]) ? rootA : rootB;
+    int large = (small == rootA) ? rootB : rootA;
+    int cell = small;
+    do {
+        int x = cell % mp->mazeWidth;
+        int y = cell / mp->mazeWidth;
+        int mask = getMask(mp->wallMasks, cell);
+        for (int dir = 0; dir < M_NUM_DIRECTIONS; dir++) {
+            // Border sides are always in the mask, so an unwalled side has a neighbor on the map
+            if (mask & (1 << dir)) {
+                continue;
+            }
+            map_cell_t here = {x, y};
+            map_cell_t there = {x + DIR_DX[dir], y + DIR_DY[dir]};
+            int neighbor = there.y * mp->mazeWidth + there.x;
+            if (map_getEdge(mp, here, there) == MAP_UNKNOWN && ufFind(mp, neighbor) == large) {
+                writeEdge(mp, here, there, MAP_WALL);
+                mp->inferredEdges++;
+                pushCell(mp, cell);
+                pushCell(mp, neighbor);
+            }
+        }
+        cell = mp->ufNext[cell];
+    } while (cell != small);
+
+    ufLink(mp, small, large);
+}
+
+/**************** ufLink ****************/
+/* Links the root small under the root large, and splices the two cell lists into one
+ */
+static void ufLink(map_t *mp, int small, int large)
+{
+    mp->ufParent[large] += mp->ufParent[small];
+    mp->ufParent[small] = large;
+    int32_t next = mp->ufNext[small];
+    mp->ufNext[small] = mp->ufNext[large];
+    mp->ufNext[large] = next;
+}
+
+/**************** pushCell ****************/
+/* Puts cell on the inference worklist, unless it is already there
+ */
+static void pushCell(map_t *mp, int cell)
+{
+    if (!mp->queued[cell]) {
+        mp->queued[cell] = 1;
+        mp->worklist[mp->worklistSize++] = cell;
+    }
+}
+
+/**************** runInference ****************/
+/* Empties the inference worklist. A cell walled on exactly three sides whose fourth side is
+ * still unknown must be open on that side, or the cell could not be reached. Opening it joins
+ * two components, which may wall off further edges and push their cells in turn.
+ */
+static void runInference(map_t *mp)
+{
+    while (mp->worklistSize > 0) {
+        int cell = mp->worklist[--mp->worklistSize];
+        mp->queued[cell] = 0;
+
+        int mask = getMask(mp->wallMasks, cell);
+        if (__builtin_popcount(mask) != 3) {
+            continue;
+        }
+        int dir = __builtin_ctz(~mask & MAP_WALL_ALL);
+        map_cell_t here = {cell % mp->mazeWidth, cell / mp->mazeWidth};
+        map_cell_t there = {here.x + DIR_DX[dir], here.y + DIR_DY[dir]};
+        if (map_getEdge(mp, here, there) == MAP_UNKNOWN) {
+            writeEdge(mp, here, there, MAP_OPEN);
+            mp->inferredEdges++;
+            ufUnite(mp, cell, there.y * mp->mazeWidth + there.x);
+        }
+    }
+}
+
+/**************** neighborOf ****************/
+/* Returns the index of the neighbor of cell in direction dir. Only call this for a side which
+ * is not walled in the cell's mask: the border is always walled, so that neighbor is on the map.
+ */
+static inline int neighborOf(map_t *mp, int cell, int dir)
+{
+    return cell + DIR_DY[dir] * mp->mazeWidth + DIR_DX[dir];
+}
+
+/**************** inferenceAlloc ****************/
+/* Gives the map its inference arrays, unless it has them already: the union-find, with every cell
+ * its own component, and an empty worklist, in one cache-line aligned block headed by ufParent.
+ * Returns false if they could not be allocated.
+ */
+static bool inferenceAlloc(map_t *mp)
+{
+    if (mp->ufParent != NULL) {
+        return true;
+    }
+    size_t cells = (size_t)mp->mazeWidth * mp->mazeHeight;
+    size_t nextOffset = alignUp(cells * sizeof(int32_t));
+    size_t worklistOffset = nextOffset + alignUp(cells * sizeof(int32_t));
+    size_t queuedOffset = worklistOffset + alignUp(cells * sizeof(int32_t));
+    uint8_t *block = aligned_alloc(MAP_ALIGN, queuedOffset + alignUp(cells));
+    if (block == NULL) {
+        fprintf(stderr, "map_setInference failed to allocate memory.\n");
+        return false;
+    }
+    mp->ufParent = (int32_t *)block;
+    mp->ufNext = (int32_t *)(block + nextOffset);
+    mp->worklist = (int32_t *)(block + worklistOffset);
+    mp->queued = block + queuedOffset;
+    memset(mp->queued, 0, cells);
+    mp->worklistSize = 0;
+    ufReset(mp);
+    return true;
+}
+
+/**************** ufReset ****************/
+/* Makes every cell a component of size 1 on its own
+ */
+static void ufReset(map_t *mp)
+{
+    int cells = mp->mazeWidth * mp->mazeHeight;
+    for (int cell = 0; cell < cells; cell++) {
+        mp->ufParent[cell] = -1;
+        mp->ufNext[cell] = cell;
+    }
+}
+
+/**************** distanceAlloc ****************/
+/* Gives the map its distance field, unless it has it already: the distances, every cell
+ * unreachable, the repair FIFO and the affected flags, in one cache-line aligned block headed by
+ * distance. The heap is left to heapPush. Returns false if they could not be allocated.
+ */
+static bool distanceAlloc(map_t *mp)
+{
+    if (mp->distance != NULL) {
+        return true;
+    }
+    size_t cells = (size_t)mp->mazeWidth * mp->mazeHeight;
+    size_t repairOffset = alignUp(cells * sizeof(int32_t));
+    size_t affectedOffset = repairOffset + alignUp(cells * sizeof(int32_t));
+    uint8_t *block = aligned_alloc(MAP_ALIGN, affectedOffset + alignUp(cells));
+    if (block == NULL) {
+        fprintf(stderr, "map_setTargetXY failed to allocate memory.\n");
+        return false;
+    }
+    mp->distance = (int32_t *)block;
+    mp->repair = (int32_t *)(block + repairOffset);
+    mp->affected = block + affectedOffset;
+    memset(mp->affected, 0, cells);
+    for (size_t cell = 0; cell < cells; cell++) {
+        mp->distance[cell] = MAP_UNREACHABLE;
+    }
+    return true;
+}
+
+/**************** distanceFree ****************/
+/* Frees the map's distance field, if it has one. The heap is kept.
+ */
+static void distanceFree(map_t *mp)
+{
+    free(mp->distance);
+    mp->distance = NULL;
+    mp->repair = NULL;
+    mp->affected = NULL;
+}
+
+/**************** distanceRebuild ****************/
+/* Recomputes the whole distance field with a BFS out from the target
+ */
+static void distanceRebuild(map_t *mp)
+{
+    if (mp->distance == NULL) {
+        return;
+    }
+    mp->heapSize = 0;
+    mp->heapOverflow = false;
+    int cells = mp->mazeWidth * mp->mazeHeight;
+    for (int cell = 0; cell < cells; cell++) {
+        mp->distance[cell] = MAP_UNREACHABLE;
+    }
+    if (!map_validXY(mp, mp->targetX, mp->targetY)) {
+        return;
+    }
+
+    int target = mp->targetY * mp->mazeWidth + mp->targetX;
+    mp->distance[target] = 0;
+    mp->repair[0] = target;
+    int head = 0;
+    int tail = 1;
+    while (head < tail) {
+        int cell = mp->repair[head++];
+        int mask = getMask(mp->wallMasks, cell);
+        for (int dir = 0; dir < M_NUM_DIRECTIONS; dir++) {
+            if (mask & (1 << dir)) {
+                continue;
+            }
+            int neighbor = neighborOf(mp, cell, dir);
+            if (mp->distance[neighbor] == MAP_UNREACHABLE) {
+                mp->distance[neighbor] = mp->distance[cell] + 1;
+                mp->repair[tail++] = neighbor;
+            }
+        }
+    }
+}
+
+/**************** distanceRaise ****************/
+/* Repairs the distance field after the edge between cells a and b became a wall. Only the
+ * farther of the two cells can have used the edge, so the repair starts there.
+ */
+static void distanceRaise(map_t *mp, int a, int b)
+{
+    if (mp->distance[a] == mp->distance[b]) {
+        return;
+    }
+    distanceUnsupport(mp, (mp->distance[a] > mp->distance[b]) ? a : b);
+}
+
+/**************** distanceRetarget ****************/
+/* Moves the distance field from the target cell from to the target cell to. The new target is
+ * first added as a second source, which lowers every cell nearer to it; then the old one is
+ * dropped, which raises every cell that only it supported.
+ */
+static void distanceRetarget(map_t *mp, int from, int to)
+{
+    mp->distance[to] = 0;
+    heapPush(mp, 0, to);
+    distanceSpread(mp);
+    distanceUnsupport(mp, from);
+}
+
+/**************** distanceUnsupport ****************/
+/* Repairs the distance field after cell start may have lost the support of its distance.
+ * 1. Starting at start, find every cell left with no neighbor one step closer to the target
+ *    that is not itself affected. Cells are visited in BFS order, so every possible support
+ *    of a cell is decided before the cell is.
+ * 2. Re-seed each affected cell from its unaffected neighbors, and spread the new distances
+ *    through the affected cells in order of distance.
+ */
+static void distanceUnsupport(map_t *mp, int start)
+{
+    // 1. Find the affected cells
+    mp->repair[0] = start;
+    mp->affected[start] = AFFECTED_QUEUED;
+    int head = 0;
+    int tail = 1;
+    while (head < tail) {
+        int cell = mp->repair[head++];
+        int mask = getMask(mp->wallMasks, cell);
+
+        // A cell which still has an unaffected neighbor one step closer keeps its distance
+        bool supported = false;
+        for (int dir = 0; dir < M_NUM_DIRECTIONS && !supported; dir++) {
+            if (mask & (1 << dir)) {
+                continue;
+            }
+            int neighbor = neighborOf(mp, cell, dir);
+            supported = (mp->distance[neighbor] == mp->distance[cell] - 1 &&
+                         !(mp->affected[neighbor] & AFFECTED_RAISED));
+        }
+        if (supported) {
+            continue;
+        }
+
+        // Otherwise it is affected, and so may be every neighbor which counted on it
+        mp->affected[cell] |= AFFECTED_RAISED;
+        for (int dir = 0; dir < M_NUM_DIRECTIONS; dir++) {
+            if (mask & (1 << dir)) {
+                continue;
+            }
+            int neighbor = neighborOf(mp, cell, dir);
+            if (mp->distance[neighbor] == mp->distance[cell] + 1 && !mp->affected[neighbor]) {
+                mp->affected[neighbor] = AFFECTED_QUEUED;
+                mp->repair[tail++] = neighbor;
+            }
+        }
+    }
+
+    // 2. Forget the distances of the affected cells, then re-seed them from their unaffected neighbors
+    for (int i = 0; i < tail; i++) {
+        if (mp->affected[mp->repair[i]] & AFFECTED_RAISED) {
+            mp->distance[mp->repair[i]] = MAP_UNREACHABLE;
+        }
+    }
+    for (int i = 0; i < tail; i++) {
+        int cell = mp->repair[i];
+        if (mp->affected[cell] & AFFECTED_RAISED) {
+            int mask = getMask(mp->wallMasks, cell);
+            int32_t best = MAP_UNREACHABLE;
+            for (int dir = 0; dir < M_NUM_DIRECTIONS; dir++) {
+                if (!(mask & (1 << dir)) && mp->distance[neighborOf(mp, cell, dir)] < best) {
+                    best = mp->distance[neighborOf(mp, cell, dir)];
+                }
+            }
+            if (best != MAP_UNREACHABLE) {
+                mp->distance[cell] = best + 1;
+                heapPush(mp, best + 1, cell);
+            }
+        }
+        mp->affected[cell] = 0;
+    }
+    distanceSpread(mp);
+}
+
+/**************** distanceLower ****************/
+/* Repairs the distance field after the edge between cells a and b stopped being a wall: the
+ * nearer cell may now give the other a shorter path, which spreads outwards from there
+ */
+static void distanceLower(map_t *mp, int a, int b)
+{
+    int near = (mp->distance[a] < mp->distance[b]) ? a : b;
+    int other = (near == a) ? b : a;
+    if (mp->distance[near] != MAP_UNREACHABLE && mp->distance[near] + 1 < mp->distance[other]) {
+        mp->distance[other] = mp->distance[near] + 1;
+        heapPush(mp, mp->distance[other], other);
+        distanceSpread(mp);
+    }
+}
+
+/**************** distanceSpread ****************/
+/* Empties the repair heap, Dijkstra style: pops cells in order of distance and lowers the
+ * distance of every neighbor it can give a shorter path. Stale entries are skipped.
+ */
+static void distanceSpread(map_t *mp)
+{
+    while (mp->heapSize > 0) {
+        uint64_t top = heapPop(mp);
+        int32_t distance = (int32_t)(top >> 32);
+        int cell = (int)(top & 0xFFFFFFFFu);
+        if (distance != mp->distance[cell]) {
+            continue;
+        }
+        int mask = getMask(mp->wallMasks, cell);
+        for (int dir = 0; dir < M_NUM_DIRECTIONS; dir++) {
+            if (mask & (1 << dir)) {
+                continue;
+            }
+            int neighbor = neighborOf(mp, cell, dir);
+            if (mp->distance[neighbor] > distance + 1) {
+                mp->distance[neighbor] = distance + 1;
+                heapPush(mp, distance + 1, neighbor);
+            }
+        }
+    }
+}
+
+/**************** heapPush ****************/
+/* Adds (distance, cell) to the repair heap, doubling the heap if it is full. A cell is pushed
+ * once as a seed and otherwise only when a neighbor lowers its distance, at most once per
+ * neighbor, so one repair pushes at most (M_NUM_DIRECTIONS + 1) entries per cell, but most
+ * repairs touch a handful of cells. If the heap cannot grow the entry is dropped, and
+ * heapOverflow set, for the caller to rebuild the field once the repair is over.
+ */
+static void heapPush(map_t *mp, int32_t distance, int cell)
+{
+    if (mp->heapSize == mp->heapCapacity) {
+        int capacity = (mp->heapCapacity > 0) ? 2 * mp->heapCapacity : HEAP_INITIAL;
+        uint64_t *heap = realloc(mp->heap, (size_t)capacity * sizeof(uint64_t));
+        if (heap == NULL) {
+            mp->heapOverflow = true;
+            return;
+        }
+        mp->heap = heap;
+        mp->heapCapacity = capacity;
+    }
+    uint64_t key = ((uint64_t)distance << 32) | (uint32_t)cell;
+    int i = mp->heapSize++;
+    while (i > 0 && mp->heap[(i - 1) / 2] > key) {
+        mp->heap[i] = mp->heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    mp->heap[i] = key;
+}
+
+/**************** heapPop ****************/
+/* Removes and returns the smallest (distance << 32 | cell) key of the repair heap
+ */
+static uint64_t heapPop(map_t *mp)
+{
+    uint64_t top = mp->heap[0];
+    uint64_t last = mp->heap[--mp->heapSize];
+    int i = 0;
+    while (2 * i + 1 < mp->heapSize) {
+        int child = 2 * i + 1;
+        if (child + 1 < mp->heapSize && mp->heap[child + 1] < mp->heap[child]) {
+            child++;
+        }
+        if (mp->heap[child] >= last) {
+            break;
+        }
+        mp->heap[i] = mp->heap[child];
+        i = child;
+    }
+    mp->heap[i] = last;
+    return top;
+}
+
+/**************** alignUp ****************/
+/* Rounds bytes up to the next multiple of MAP_ALIGN
+ */
+static size_t alignUp(size_t bytes)
+{
+    return (bytes + MAP_ALIGN - 1) / MAP_ALIGN * MAP_ALIGN;
+}
+
+/**************** planeBytes ****************/
+/* Returns the number of bytes needed to pack edgeCount 2-bit edges. Always at least one,
+ * so that a 1-wide or 1-high maze still gets a valid (if unused) allocation.
+ */
+static size_t planeBytes(int edgeCount)
+{
+    if (edgeCount <= 0) {
+        return 1;
+    }
+    return (size_t)(edgeCount + 3) / 4;
+}
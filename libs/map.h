@@ -21,21 +21,81 @@
  *                  position structs are provided for each function, enabling flexibility for
  *                  the caller to use the version which best matches their usage pattern.
  *
+ *                  map_getEdge and map_setEdge take value-typed map_cell_t coordinates and
+ *                  never allocate; every other getter and setter is routed through them.
+ *
+ *                  map_wallMask returns which of a cell's four sides are walls in a single
+ *                  load, so that a full neighborhood does not need four map_isWallXY calls.
+ *
+ *                  map_fillDeadEnds seals blind corridors as soon as they are known, so that
+ *                  avatars do not re-enter them. It never seals the meeting point set with
+ *                  map_setTargetXY, nor any cell holding an avatar, which it looks up in the
+ *                  occupancy kept alongside the avatar array (see AMlib_avatar.h).
+ *
+ *                  map_sweepDeadEnds does the same for every dead end on the map at once,
+ *                  using a vectorized pass over the wall masks; use it after a burst of
+ *                  discovery rather than calling map_fillDeadEnds cell by cell.
+ *
+ *                  map_setInference turns on inference of edges from the fact that the maze is
+ *                  a tree: unknown edges which would close a cycle are walls, and the last
+ *                  unknown side of a cell walled on three sides is open.
+ *
+ *                  The map keeps every cell's distance to the target set with map_setTargetXY,
+ *                  over edges not known to be walls, and repairs it locally as walls are learned.
+ *                  map_nextStepXY reads the next move towards the target off it in O(1).
+ *
+ *                  map_pack writes the map's edges, and nothing else, into map_packedSize
+ *                  bytes; map_unpack sets a map of the same size to them, and rebuilds
+ *                  everything the map derives from its edges.
+ *
  */
 /* ========================================================================== */
+#ifndef __MAP_H
+#define __MAP_H
+
 #include <stdio.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include "AMlib_avatar.h"
 
 /**************** global types ****************/
 typedef struct map map_t;
 
+// A cell of the maze, passed by value
+typedef struct map_cell {
+    int x;
+    int y;
+} map_cell_t;
+
+// Possible states of the relationship between two cells
+typedef enum map_state {
+    MAP_INVALID = -1,   // The cells are off the map or not cardinal neighbors
+    MAP_UNKNOWN = 0,
+    MAP_OPEN = 1,
+    MAP_WALL = 2
+} map_state_t;
+
+// Bits of the per-cell wall mask returned by map_wallMask, one per direction from amazing.h
+#define MAP_WALL_WEST   (1 << M_WEST)
+#define MAP_WALL_NORTH  (1 << M_NORTH)
+#define MAP_WALL_SOUTH  (1 << M_SOUTH)
+#define MAP_WALL_EAST   (1 << M_EAST)
+#define MAP_WALL_ALL    (MAP_WALL_WEST | MAP_WALL_NORTH | MAP_WALL_SOUTH | MAP_WALL_EAST)
+
 /**************** functions ****************/
 
-// Map create and map delete
+// Map create, map delete, and copy of everything known about one map into another of the same size,
+// or of just its edges, wall masks and target, for a copy which is only drawn or saved
 map_t *map_new(int mazeWidth, int mazeHeight);
 bool map_delete(map_t *map);
+bool map_copy(map_t *dst, map_t *src);
+bool map_copyEdges(map_t *dst, map_t *src);
+
+// The map's edges packed into bytes, and a map rebuilt from them
+size_t map_packedSize(map_t *mp);
+void map_pack(map_t *mp, uint8_t *buf);
+void map_unpack(map_t *mp, const uint8_t *buf);
 
 // // Check if a position is a valid map location (makes it easy to check if you are trying to enter a cell out of bounds);
 // bool map_validPos(map_t *map, position_t *pos);
@@ -44,11 +104,41 @@ bool map_validXY(map_t *mp, int x, int y);
 // Check if a pair of positions are cardinal-neighbors and are both valid (i.e. on the map)
 bool map_neighborAndValidXY(map_t *mp, int x1, int y1, int x2, int y2);
 
+// Allocation-free get and set of the relationship between two cells
+map_state_t map_getEdge(map_t *mp, map_cell_t c1, map_cell_t c2);
+bool map_setEdge(map_t *mp, map_cell_t c1, map_cell_t c2, map_state_t state);
+
+// Which sides of a cell are walls (border included), as a mask and as a count
+int map_wallMask(map_t *mp, int x, int y);
+int map_wallCount(map_t *mp, int x, int y);
+
+// Meeting point (also the origin of the distance field; false if the field could not be allocated), and cascading fill of known dead ends (returns the number of cells sealed)
+bool map_setTargetXY(map_t *mp, int x, int y);
+int map_getTargetX(map_t *mp);
+int map_getTargetY(map_t *mp);
+int map_fillDeadEnds(map_t *mp, int x, int y, occupancy_t *occ);
+
+// Whole-map dead-end pass: find every dead end (bitmap, one bit per cell), or find and seal them all
+int map_findDeadEnds(map_t *mp, const uint64_t **bitmap);
+int map_sweepDeadEnds(map_t *mp, occupancy_t *occ);
+
+// Inference of unprobed edges (off by default; false if its arrays could not be allocated), the number of edges inferred so far, and whether known-open edges join two cells
+bool map_setInference(map_t *mp, bool enabled);
+int map_getInferredCount(map_t *mp);
+bool map_isConnectedXY(map_t *mp, int x1, int y1, int x2, int y2);
+
+// How many times an edge became, or stopped being, a wall: what depends on the walls alone holds while it is unchanged
+int map_getWallChanges(map_t *mp);
+
+// Distance field towards the target: steps from a cell (-1 if cut off), and the direction of the next step
+int map_distanceXY(map_t *mp, int x, int y);
+int map_nextStepXY(map_t *mp, int x, int y);
+
 // // Bools to get the status of a relationship between cells:
 bool map_isUnknown(map_t *mp, position_t *pos1, position_t *pos2);
 bool map_isOpen(map_t *mp, position_t *pos1, position_t *pos2);
 bool map_isWall(map_t *mp, position_t *pos1, position_t *pos2);
-bool map_isUnknownXY(map_t *mp, position_t *pos1, position_t *pos2);
+bool map_isUnknownXY(map_t *mp, int x1, int y1, int x2, int y2);
 bool map_isOpenXY(map_t *mp, int x1, int y1, int x2, int y2);
 bool map_isWallXY(map_t *mp, int x1, int y1, int x2, int y2);
 
@@ -62,8 +152,6 @@ bool map_setWallXY(map_t *mp, int x1, int y1, int x2, int y2);
 
 // Getters for map and maze info 
 int map_getMazeWidth(map_t* mp);
+int map_getMazeHeight(map_t* mp);
 
-
-
-
-
+#endif // __MAP_H
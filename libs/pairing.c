@@ -0,0 +1,212 @@
+/* ========================================================================== */
+/* File: pairing.c
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Andrw Yang, Maria Roodnitsky, Siddharth Agrawal, Alexander Hirsch
+ * Component name:  pairing
+ *
+ * Date Created:    March 11, 2020
+ *
+ * Description:     This file implements the pairing module, which walks avatars the known
+ *                  map connects towards each other (see pairing.h).
+ *
+ *                  The bidirectional search grows whichever side has fewer cells waiting,
+ *                  one cell at a time. Known-open edges never form a cycle in a perfect
+ *                  maze, so the first edge joining the two sides lies on the one path
+ *                  between the avatars, and the search can stop there.
+ *
+ */
+/* ========================================================================== */
+
+// Import C Standard libraries
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Import project-specific libraries
+#include "amazing.h"
+#include "AMlib_avatar.h"
+#include "map.h"
+#include "convoy.h"
+#include "pairing.h"
+
+/**************** pairing struct ****************/
+typedef struct pairing {
+    int mazeWidth;
+    int mazeHeight;
+    int *parent;        // Search scratch: the cell each cell was reached from, towards its side's start
+    int *depth;         // Search scratch: the number of edges from its side's start
+    int *queue[2];      // Search scratch: the cells reached by each side, in order
+    uint8_t *side;      // Search scratch: the side (0 or 1) which reached each cell
+    uint32_t *seen;     // Search scratch: the search in which each cell was reached
+    uint32_t search;    // The number of the current search
+} pairing_t;
+
+/**************** local functions ****************/
+static uint32_t direction_of(int from, int to);
+
+/**************** pairing_new ****************/
+/* Allocates a pairing and the search scratch for a mazeWidth x mazeHeight map
+ * Memory: caller is responsible for calling pairing_delete
+ */
+pairing_t *pairing_new(int mazeWidth, int mazeHeight)
+{
+    pairing_t *pr = malloc(sizeof(pairing_t));
+    if (pr == NULL) {
+        return NULL;
+    }
+    int num_cells = mazeWidth * mazeHeight;
+    pr->mazeWidth = mazeWidth;
+    pr->mazeHeight = mazeHeight;
+    pr->parent = malloc(num_cells * sizeof(int));
+    pr->depth = malloc(num_cells * sizeof(int));
+    pr->queue[0] = malloc(num_cells * sizeof(int));
+    pr->queue[1] = malloc(num_cells * sizeof(int));
+    pr->side = malloc(num_cells * sizeof(uint8_t));
+    pr->seen = calloc(num_cells, sizeof(uint32_t));
+    pr->search = 0;
+    if (pr->parent == NULL || pr->depth == NULL || pr->queue[0] == NULL || pr->queue[1] == NULL ||
+        pr->side == NULL || pr->seen == NULL) {
+        pairing_delete(pr);
+        return NULL;
+    }
+    return pr;
+}
+
+/**************** pairing_delete ****************/
+/* Frees the pairing and its search scratch
+ */
+void pairing_delete(pairing_t *pr)
+{
+    if (pr == NULL) {
+        return;
+    }
+    free(pr->parent);
+    free(pr->depth);
+    free(pr->queue[0]);
+    free(pr->queue[1]);
+    free(pr->side);
+    free(pr->seen);
+    free(pr);
+}
+
+/**************** pairing_pathXY ****************/
+/* Bidirectional search over known-open edges from (x1, y1) and (x2, y2) until the two sides meet
+ * Memory: does not allocate memory
+ */
+int pairing_pathXY(pairing_t *pr, map_t *mp, int x1, int y1, int x2, int y2, uint32_t *move)
+{
+    if (!map_isConnectedXY(mp, x1, y1, x2, y2)) {
+        return -1;
+    }
+    int width = pr->mazeWidth;
+    int start[2] = {y1 * width + x1, y2 * width + x2};
+    if (start[0] == start[1]) {
+        *move = M_NULL_MOVE;
+        return 0;
+    }
+
+    // Start a new search; on wraparound of the search number, forget every earlier search
+    if (++pr->search == 0) {
+        memset(pr->seen, 0, width * pr->mazeHeight * sizeof(uint32_t));
+        pr->search = 1;
+    }
+    int head[2] = {0, 0};
+    int tail[2] = {0, 0};
+    for (int s = 0; s < 2; s++) {
+        pr->queue[s][tail[s]++] = start[s];
+        pr->seen[start[s]] = pr->search;
+        pr->side[start[s]] = s;
+        pr->parent[start[s]] = -1;
+        pr->depth[start[s]] = 0;
+    }
+
+    while (head[0] < tail[0] && head[1] < tail[1]) {
+        // Grow the side with fewer cells waiting
+        int s = (tail[0] - head[0] <= tail[1] - head[1]) ? 0 : 1;
+        int cell = pr->queue[s][head[s]++];
+        int x = cell % width;
+        int y = cell / width;
+        int neighbors[M_NUM_DIRECTIONS][2] = {
+            [M_WEST] = {x - 1, y}, [M_NORTH] = {x, y - 1}, [M_SOUTH] = {x, y + 1}, [M_EAST] = {x + 1, y}};
+        for (int direction = 0; direction < M_NUM_DIRECTIONS; direction++) {
+            int nx = neighbors[direction][0];
+            int ny = neighbors[direction][1];
+            if (!map_isOpenXY(mp, x, y, nx, ny)) {
+                continue;
+            }
+            int next = ny * width + nx;
+            if (pr->seen[next] != pr->search) {
+                pr->seen[next] = pr->search;
+                pr->side[next] = s;
+                pr->parent[next] = cell;
+                pr->depth[next] = pr->depth[cell] + 1;
+                pr->queue[s][tail[s]++] = next;
+                continue;
+            }
+            if (pr->side[next] == s) {
+                continue;
+            }
+
+            // The sides meet across the edge from cell to next. Walk the first side back to its start
+            int near = (s == 0) ? cell : next;
+            int far = (s == 0) ? next : cell;
+            int length = pr->depth[near] + 1 + pr->depth[far];
+            int step = far;
+            while (near != start[0]) {
+                step = near;
+                near = pr->parent[near];
+            }
+            *move = direction_of(start[0], step);
+            return length;
+        }
+    }
+    return -1;
+}
+
+/**************** pairing_converge ****************/
+/* Checks every other avatar for a known path to this one, and heads for the nearest.
+ * Memory: does not allocate memory
+ */
+int pairing_converge(pairing_t *pr, map_t *mp, avatar_t **av_array, int num_av, convoy_t *convoy,
+                     int avatar_id, uint32_t *move)
+{
+    avatar_t *self = av_array[avatar_id];
+    int best = -1;
+    int best_length = 0;
+    for (int i = 0; i < num_av; i++) {
+        avatar_t *other = av_array[i];
+        if (i == avatar_id || other == NULL ||
+            (avatar_getX(other) == avatar_getX(self) && avatar_getY(other) == avatar_getY(self)) ||
+            (convoy != NULL && convoy_getGroup(convoy, i) == convoy_getGroup(convoy, avatar_id))) {
+            continue;
+        }
+        uint32_t step;
+        int length = pairing_pathXY(pr, mp, avatar_getX(self), avatar_getY(self),
+                                    avatar_getX(other), avatar_getY(other), &step);
+        if (length > 0 && (best == -1 || length < best_length)) {
+            best = i;
+            best_length = length;
+            *move = step;
+        }
+    }
+    return best;
+}
+
+/**************** direction_of ****************/
+/* Returns the direction of the step between neighboring cells from and to
+ */
+static uint32_t direction_of(int from, int to)
+{
+    if (to == from + 1) {
+        return M_EAST;
+    } else if (to == from - 1) {
+        return M_WEST;
+    } else if (to < from) {
+        return M_NORTH;
+    }
+    return M_SOUTH;
+}
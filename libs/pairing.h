@@ -0,0 +1,70 @@
+/* ========================================================================== */
+/* File: pairing.h
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Andrw Yang, Maria Roodnitsky, Siddharth Agrawal, Alexander Hirsch
+ * Component name:  pairing
+ *
+ * Date Created:    March 11, 2020
+ *
+ * Description:     This header file provides the interface with the pairing module. The
+ *                  pairing module finds avatars which the known map already connects, and
+ *                  walks them towards each other.
+ *
+ *                  The maze is perfect, so a path of known-open edges between two avatars
+ *                  is the only path between them: the distance along it is exact, unlike
+ *                  the optimistic distances the meeting point is elected by. Two avatars
+ *                  which both step along it meet in the middle, after half the moves it
+ *                  would take one of them to walk all of it. Once they have met they are
+ *                  one group of the convoy, and are not paired with each other again.
+ *
+ *                  The map tells in O(1) whether two cells are connected by open edges
+ *                  (map_isConnectedXY); the path itself is found with a bidirectional
+ *                  breadth-first search, growing from both avatars until the searches meet.
+ *
+ */
+/* ========================================================================== */
+#ifndef __PAIRING_H
+#define __PAIRING_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "AMlib_avatar.h"
+#include "map.h"
+#include "convoy.h"
+
+/**************** global types ****************/
+typedef struct pairing pairing_t;
+
+/**************** functions ****************/
+
+/**************** pairing_new ****************/
+/* Allocates a pairing, with the search scratch for a mazeWidth x mazeHeight map. Returns NULL
+ * if memory could not be allocated.
+ * Memory: caller is responsible for calling pairing_delete
+ */
+pairing_t *pairing_new(int mazeWidth, int mazeHeight);
+
+/**************** pairing_delete ****************/
+/* Frees the memory associated with the pairing
+ */
+void pairing_delete(pairing_t *pr);
+
+/**************** pairing_pathXY ****************/
+/* Searches the known-open edges for the path from (x1, y1) to (x2, y2). Returns its length, and
+ * sets *move to its first step from (x1, y1) (M_NULL_MOVE if the cells are the same). Returns -1,
+ * leaving *move alone, if no such path is known.
+ */
+int pairing_pathXY(pairing_t *pr, map_t *mp, int x1, int y1, int x2, int y2, uint32_t *move);
+
+/**************** pairing_converge ****************/
+/* Finds the nearest avatar that the known map connects to avatar avatar_id, and sets *move to the
+ * first step towards it. Avatars on the same cell are skipped, and so are avatars in the same
+ * group of the convoy, if convoy is not NULL. Returns the ID of the avatar found, or -1 if there
+ * is none, leaving *move alone.
+ */
+int pairing_converge(pairing_t *pr, map_t *mp, avatar_t **av_array, int num_av, convoy_t *convoy,
+                     int avatar_id, uint32_t *move);
+
+#endif // __PAIRING_H
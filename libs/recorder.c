@@ -0,0 +1,623 @@
+/* ========================================================================== */
+/* File: recorder.c
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Andrw Yang, Maria Roodnitsky, Siddharth Agrawal, Alexander Hirsch
+ * Component name:  recorder
+ *
+ * Date Created:    March 13, 2020
+ *
+ * Description:     This file implements the recorder module, which prints and logs the
+ *                  avatars' turns from a thread of its own (see recorder.h).
+ *
+ *                  Submitted records wait in a ring of fixed-size slots, which any number
+ *                  of avatars fill without a lock, and the recorder's thread alone empties.
+ *                  Each slot carries a sequence number, telling whose turn it is to use
+ *                  it: an avatar claims the next free slot by advancing the ring's write
+ *                  position with a compare-and-swap, copies its record in, and publishes
+ *                  it by advancing the slot's sequence. The thread logs every record which
+ *                  is ready, flushes the log once for the batch, hands the slots back, and
+ *                  hands each record with positions to the render thread. When the ring is
+ *                  empty the thread sleeps on a semaphore, which an avatar posts only if
+ *                  the thread has said it is asleep. The log is opened once, when the
+ *                  recorder starts, and kept open until it stops.
+ *
+ *                  Beside the log, the thread writes its index (see logindex.h): an entry
+ *                  for each record, with where it starts in the log, counted from the
+ *                  bytes written rather than asked of the file. Every
+ *                  LOGINDEX_CHECKPOINT_INTERVAL records it also checkpoints the shared
+ *                  map. Records are submitted with the shared lock held, so while the
+ *                  thread holds it the map is as of the last record submitted, which may
+ *                  not be logged yet.
+ *
+ *                  The render thread is woken through a semaphore, posted only when the
+ *                  handoff goes from drawn to pending, or for a request or to stop; the
+ *                  flags saying which are atomic, so a request can come from a signal
+ *                  handler. The positions handed over are guarded by a lock the two
+ *                  threads alone take, each only to copy them. Writes to the screen, the
+ *                  frames and the errors the recorder's thread shows, are made holding
+ *                  the screen lock, so they never interleave.
+ *
+ */
+/* ========================================================================== */
+
+// Import C Standard libraries
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+// Import project-specific libraries
+#include "amazing.h"
+#include "AMlib_avatar.h"
+#include "map.h"
+#include "render.h"
+#include "turnlog.h"
+#include "logindex.h"
+#include "recorder.h"
+
+/**************** file-local global variables ****************/
+#define RECORDER_RING_SIZE 4096                 // Slots in the ring; must be a power of two
+#define RECORDER_RING_MASK (RECORDER_RING_SIZE - 1)
+#define RECORDER_LOG_BUFFER (64 * 1024)         // Bytes of the log buffered between flushes
+#define NS_PER_S 1000000000L
+
+/**************** local types ****************/
+// A slot of the ring. It is free for the record at write position pos when sequence == pos, and
+// holds that record, ready to be logged, when sequence == pos + 1
+typedef struct record_slot {
+    atomic_size_t sequence;
+    turn_record_t record;
+} record_slot_t;
+
+/**************** recorder struct ****************/
+typedef struct recorder {
+    FILE *log;                          // The log, open for the life of the recorder
+    log_format_t format;                // The format it is written in
+    long log_offset;                    // Where the next record starts in the log
+    logindex_t *index;                  // The log's index and checkpoints
+    size_t next_checkpoint;             // The number of records logged when the next checkpoint is due
+    map_t *shared_map;                  // The map shared by the avatars, and the lock it is read with
+    pthread_mutex_t *shared_lock;
+    int mazeWidth;
+    int mazeHeight;
+    int num_avatars;
+    map_t *map;                         // The copy of the shared map checkpoints are taken of
+    pthread_t thread;
+    record_slot_t *ring;                // The records waiting, in the order they were submitted
+    atomic_size_t write_pos;            // The next slot to be claimed by an avatar
+    size_t read_pos;                    // The next slot to be logged; the thread's alone
+    atomic_bool sleeping;               // The thread found the ring empty, and waits on wakeup
+    atomic_bool stopping;
+    sem_t wakeup;                       // Posted to wake the thread
+    XYPos latest_positions[AM_MAX_AVATAR]; // The positions of the latest record logged which has them
+    char *dump_file_name;               // Where the map is dumped, and the file it is written to first
+    char *dump_temp_name;
+    atomic_bool dump_requested;         // A dump was asked for, with recorder_request_dump
+
+    // The render thread, drawing the maze at most fps times a second; none if headless
+    bool headless;
+    int fps;                            // The most frames drawn a second, or 0 to draw only on request
+    pthread_t render_thread;
+    pthread_mutex_t frame_lock;         // Guards frame_positions, between the two threads
+    XYPos frame_positions[AM_MAX_AVATAR]; // The positions of the latest record logged which has them
+    atomic_bool frame_pending;          // A record with positions was logged since the last frame began
+    atomic_bool frame_requested;        // A frame was asked for, with recorder_request_frame
+    atomic_bool render_stopping;
+    sem_t frame_wanted;                 // Posted when any of the three above is set
+    atomic_long frames;                 // Frames drawn
+    map_t *frame_map;                   // The copy of the shared map the maze is drawn from
+    avatar_t **av_array;                // The avatars at the positions of the frame drawn
+    pthread_mutex_t screen_lock;        // Held to write to the screen, by either thread
+    renderer_t *renderer;               // Draws the maze on the screen, redrawing only what changed; NULL if headless
+} recorder_t;
+
+/**************** local functions ****************/
+static void *recorder_thread(void *arg);
+static record_slot_t *ready_slot(recorder_t *rc);
+static void wake_thread(recorder_t *rc);
+static void log_record(recorder_t *rc, const turn_record_t *record);
+static void checkpoint(recorder_t *rc);
+static void dump_map(recorder_t *rc, const char *reason);
+static void publish_frame(recorder_t *rc, const turn_record_t *record);
+static void *render_thread(void *arg);
+static void draw_frame(recorder_t *rc, const XYPos *positions);
+static void stop_render_thread(recorder_t *rc);
+
+/**************** recorder_new ****************/
+/* Opens the log and its index, allocates the recorder, its ring and its copies of the map and avatars,
+ * and starts its render thread, unless headless, and then its thread
+ * Memory: caller is responsible for calling recorder_delete
+ */
+recorder_t *recorder_new(const char *log_file_name, log_format_t format, map_t *map, pthread_mutex_t *lock,
+                         int mazeWidth, int mazeHeight, int num_avatars, int fps)
+{
+    recorder_t *rc = calloc(1, sizeof(recorder_t));
+    if (rc == NULL) {
+        return NULL;
+    }
+    rc->format = format;
+    rc->shared_map = map;
+    rc->shared_lock = lock;
+    rc->mazeWidth = mazeWidth;
+    rc->mazeHeight = mazeHeight;
+    rc->num_avatars = num_avatars;
+    rc->headless = (fps == RECORDER_HEADLESS);
+    rc->fps = (fps > 0) ? fps : 0;
+    rc->map = map_new(mazeWidth, mazeHeight);
+    rc->frame_map = map_new(mazeWidth, mazeHeight);
+    rc->av_array = avatar_array_new(num_avatars);
+    rc->ring = malloc(RECORDER_RING_SIZE * sizeof(record_slot_t));
+    rc->log = fopen(log_file_name, "a");
+    rc->index = logindex_new(log_file_name, format, mazeWidth, mazeHeight, num_avatars);
+    rc->dump_file_name = malloc(strlen(log_file_name) + strlen(".map") + 1);
+    rc->dump_temp_name = malloc(strlen(log_file_name) + strlen(".map.tmp") + 1);
+    rc->renderer = rc->headless ? NULL : renderer_new(STDOUT_FILENO, mazeWidth, mazeHeight, isatty(STDOUT_FILENO));
+    if (rc->map == NULL || rc->frame_map == NULL || rc->av_array == NULL || rc->ring == NULL || rc->log == NULL
+        || rc->index == NULL || (!rc->headless && rc->renderer == NULL) || rc->dump_file_name == NULL || rc->dump_temp_name == NULL) {
+        if (rc->log == NULL) {
+            fprintf(stderr, "Error, could not open the log %s to append to it\n", log_file_name);
+        } else {
+            fclose(rc->log);
+        }
+        if (rc->index == NULL) {
+            fprintf(stderr, "Error, could not create the index of the log %s\n", log_file_name);
+        } else {
+            logindex_delete(rc->index);
+        }
+        if (rc->map != NULL) {
+            map_delete(rc->map);
+        }
+        if (rc->frame_map != NULL) {
+            map_delete(rc->frame_map);
+        }
+        renderer_delete(rc->renderer);
+        free(rc->dump_file_name);
+        free(rc->dump_temp_name);
+        free(rc->av_array);
+        free(rc->ring);
+        free(rc);
+        return NULL;
+    }
+    for (int i = 0; i < num_avatars; i++) {
+        avatar_array_add(rc->av_array, avatar_new(i));
+    }
+    sprintf(rc->dump_file_name, "%s.map", log_file_name);
+    sprintf(rc->dump_temp_name, "%s.map.tmp", log_file_name);
+
+    // Buffer the log, so a batch is written in as few writes as it will fit in
+    setvbuf(rc->log, NULL, _IOFBF, RECORDER_LOG_BUFFER);
+
+    // Records are appended after the header, and from here on their offsets are counted as they are written
+    fseek(rc->log, 0, SEEK_END);
+    rc->log_offset = ftell(rc->log);
+    rc->next_checkpoint = LOGINDEX_CHECKPOINT_INTERVAL;
+
+    // Every slot starts free for the first record to land in it
+    for (size_t i = 0; i < RECORDER_RING_SIZE; i++) {
+        atomic_init(&rc->ring[i].sequence, i);
+    }
+    atomic_init(&rc->write_pos, 0);
+    rc->read_pos = 0;
+    atomic_init(&rc->sleeping, false);
+    atomic_init(&rc->stopping, false);
+    atomic_init(&rc->dump_requested, false);
+    sem_init(&rc->wakeup, 0, 0);
+    pthread_mutex_init(&rc->frame_lock, NULL);
+    pthread_mutex_init(&rc->screen_lock, NULL);
+    atomic_init(&rc->frame_pending, false);
+    atomic_init(&rc->frame_requested, false);
+    atomic_init(&rc->render_stopping, false);
+    atomic_init(&rc->frames, 0);
+    sem_init(&rc->frame_wanted, 0, 0);
+
+    // The render thread first, so the recorder's thread always has it to hand frames to
+    bool rendering = !rc->headless && pthread_create(&rc->render_thread, NULL, render_thread, rc) == 0;
+    if ((!rc->headless && !rendering) || pthread_create(&rc->thread, NULL, recorder_thread, rc) != 0) {
+        if (rendering) {
+            stop_render_thread(rc);
+        }
+        sem_destroy(&rc->wakeup);
+        sem_destroy(&rc->frame_wanted);
+        pthread_mutex_destroy(&rc->frame_lock);
+        pthread_mutex_destroy(&rc->screen_lock);
+        fclose(rc->log);
+        logindex_delete(rc->index);
+        renderer_delete(rc->renderer);
+        avatar_array_delete(rc->av_array, num_avatars);
+        map_delete(rc->map);
+        map_delete(rc->frame_map);
+        free(rc->dump_file_name);
+        free(rc->dump_temp_name);
+        free(rc->ring);
+        free(rc);
+        return NULL;
+    }
+    return rc;
+}
+
+/**************** recorder_submit ****************/
+/* Claims the next slot of the ring, copies the record into it, publishes it, and wakes the
+ * recorder's thread if it is asleep. If the ring is full, yields until the thread frees a slot
+ */
+void recorder_submit(recorder_t *rc, const turn_record_t *record)
+{
+    // Claim a slot: the one at the write position, once it is free and no other avatar has taken it
+    size_t pos = atomic_load_explicit(&rc->write_pos, memory_order_relaxed);
+    record_slot_t *slot;
+    while (1) {
+        slot = &rc->ring[pos & RECORDER_RING_MASK];
+        intptr_t lap = (intptr_t)(atomic_load_explicit(&slot->sequence, memory_order_acquire) - pos);
+        if (lap == 0) {
+            if (atomic_compare_exchange_weak_explicit(&rc->write_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                break;
+            }
+        } else if (lap < 0) {
+            // The slot still holds the record from a lap ago: the ring is full
+            wake_thread(rc);
+            sched_yield();
+            pos = atomic_load_explicit(&rc->write_pos, memory_order_relaxed);
+        } else {
+            // Another avatar claimed this slot first
+            pos = atomic_load_explicit(&rc->write_pos, memory_order_relaxed);
+        }
+    }
+
+    // Fill it, and publish it to the thread
+    slot->record = *record;
+    atomic_store(&slot->sequence, pos + 1);
+    wake_thread(rc);
+}
+
+/**************** recorder_request_frame ****************/
+/* see recorder.h for description */
+void recorder_request_frame(recorder_t *rc)
+{
+    atomic_store(&rc->frame_requested, true);
+    sem_post(&rc->frame_wanted);
+}
+
+/**************** recorder_request_dump ****************/
+/* see recorder.h for description */
+void recorder_request_dump(recorder_t *rc)
+{
+    atomic_store(&rc->dump_requested, true);
+    wake_thread(rc);
+}
+
+/**************** recorder_set_view ****************/
+/* see recorder.h for description */
+void recorder_set_view(recorder_t *rc, int follow, int block)
+{
+    if (rc->renderer == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&rc->screen_lock);
+    if (follow != RENDER_FOLLOW_NONE) {
+        renderer_set_view(rc->renderer, RENDER_VIEW_FIT, RENDER_VIEW_FIT, follow);
+    }
+    renderer_set_overview(rc->renderer, block);
+    pthread_mutex_unlock(&rc->screen_lock);
+}
+
+/**************** recorder_get_dump_file_name ****************/
+/* see recorder.h for description */
+const char *recorder_get_dump_file_name(recorder_t *rc)
+{
+    return rc->dump_file_name;
+}
+
+/**************** recorder_get_frames ****************/
+/* see recorder.h for description */
+long recorder_get_frames(recorder_t *rc)
+{
+    return atomic_load(&rc->frames);
+}
+
+/**************** recorder_delete ****************/
+/* Stops the thread once it has emptied the queue, then the render thread once it has drawn the last
+ * frame, and frees the recorder
+ */
+void recorder_delete(recorder_t *rc)
+{
+    if (rc == NULL) {
+        return;
+    }
+    atomic_store(&rc->stopping, true);
+    wake_thread(rc);
+    pthread_join(rc->thread, NULL);
+    if (!rc->headless) {
+        stop_render_thread(rc);
+    }
+
+    sem_destroy(&rc->wakeup);
+    sem_destroy(&rc->frame_wanted);
+    pthread_mutex_destroy(&rc->frame_lock);
+    pthread_mutex_destroy(&rc->screen_lock);
+    fclose(rc->log);
+    logindex_delete(rc->index);
+    renderer_delete(rc->renderer);
+    avatar_array_delete(rc->av_array, rc->num_avatars);
+    map_delete(rc->map);
+    map_delete(rc->frame_map);
+    free(rc->dump_file_name);
+    free(rc->dump_temp_name);
+    free(rc->ring);
+    free(rc);
+}
+
+/**************** recorder_thread ****************/
+/* Until the recorder is stopping and the ring is empty: logs and indexes every record ready, handing
+ * the render thread each which has positions, then flushes the log and then the index, checkpoints the
+ * map if one is due, and if headless, dumps the map once the maze is solved; then dumps the map if it
+ * was asked to
+ */
+static void *recorder_thread(void *arg)
+{
+    recorder_t *rc = arg;
+    while (1) {
+
+        // Log every record ready, in order, handing each slot back once it is logged. The render thread
+        // is handed each record as it goes, as the ring may not empty for as long as avatars keep submitting
+        int logged = 0;
+        bool solved = false;
+        record_slot_t *slot;
+        while ((slot = ready_slot(rc)) != NULL) {
+            log_record(rc, &slot->record);
+            if (slot->record.kind != RECORD_ERROR) {
+                memcpy(rc->latest_positions, slot->record.positions, rc->num_avatars * sizeof(XYPos));
+                if (!rc->headless) {
+                    publish_frame(rc, &slot->record);
+                }
+            }
+            solved = solved || slot->record.kind == RECORD_SOLVED;
+            atomic_store_explicit(&slot->sequence, rc->read_pos + RECORDER_RING_SIZE, memory_order_release);
+            rc->read_pos++;
+            logged++;
+        }
+        if (logged > 0) {
+            fflush(rc->log);
+            logindex_flush(rc->index);
+            if (rc->read_pos >= rc->next_checkpoint) {
+                checkpoint(rc);
+            }
+            if (solved && rc->headless) {
+                dump_map(rc, "AM_MAZE_SOLVED");
+            }
+        }
+
+        // A dump asked for, once the records ready are logged
+        if (atomic_exchange(&rc->dump_requested, false)) {
+            dump_map(rc, "on request");
+        }
+        if (logged > 0) {
+            continue;
+        }
+
+        // The ring is empty. Every record is submitted before the recorder is stopped
+        if (atomic_load(&rc->stopping)) {
+            break;
+        }
+
+        // Say so before looking once more, so an avatar publishing a record now will wake the thread
+        atomic_store(&rc->sleeping, true);
+        if (ready_slot(rc) != NULL || atomic_load(&rc->stopping) || atomic_load(&rc->dump_requested)) {
+            atomic_store(&rc->sleeping, false);
+            continue;
+        }
+        sem_wait(&rc->wakeup);
+    }
+    return NULL;
+}
+
+/**************** ready_slot ****************/
+/* Returns the slot at the read position if it holds a record ready to be logged, or NULL
+ */
+static record_slot_t *ready_slot(recorder_t *rc)
+{
+    record_slot_t *slot = &rc->ring[rc->read_pos & RECORDER_RING_MASK];
+    if (atomic_load(&slot->sequence) == rc->read_pos + 1) {
+        return slot;
+    }
+    return NULL;
+}
+
+/**************** wake_thread ****************/
+/* Wakes the recorder's thread if it is asleep, and has not been woken already
+ */
+static void wake_thread(recorder_t *rc)
+{
+    if (atomic_exchange(&rc->sleeping, false)) {
+        sem_post(&rc->wakeup);
+    }
+}
+
+/**************** log_record ****************/
+/* Writes the record to the log in the recorder's format, and its entry to the index. An error is also
+ * shown on the screen, as text, after which the next frame is drawn whole
+ */
+static void log_record(recorder_t *rc, const turn_record_t *record)
+{
+    logindex_add_record(rc->index, rc->log_offset, record);
+    long written = turnlog_write_record(rc->log, rc->format, rc->num_avatars, record);
+    if (written > 0) {
+        rc->log_offset += written;
+    }
+    if (record->kind == RECORD_ERROR) {
+        pthread_mutex_lock(&rc->screen_lock);
+        turnlog_write_record(stdout, LOG_FORMAT_TEXT, rc->num_avatars, record);
+        fflush(stdout);
+        if (rc->renderer != NULL) {
+            renderer_invalidate(rc->renderer);
+        }
+        pthread_mutex_unlock(&rc->screen_lock);
+    }
+}
+
+/**************** checkpoint ****************/
+/* Checkpoints the shared map as of the last record submitted, copying it holding the shared lock
+ * only for the copy
+ */
+static void checkpoint(recorder_t *rc)
+{
+    pthread_mutex_lock(rc->shared_lock);
+    size_t submitted = atomic_load(&rc->write_pos);
+    map_copyEdges(rc->map, rc->shared_map);
+    pthread_mutex_unlock(rc->shared_lock);
+
+    logindex_add_checkpoint(rc->index, (long)submitted - 1, rc->map);
+    rc->next_checkpoint = submitted + LOGINDEX_CHECKPOINT_INTERVAL;
+}
+
+/**************** dump_map ****************/
+/* Writes a copy of the shared map, with the avatars at the latest positions logged, to the dump's
+ * temporary file, as print_map prints it under a line saying when and why, and then renames it to the
+ * dump file, so the dump file is always a whole dump
+ */
+static void dump_map(recorder_t *rc, const char *reason)
+{
+    // Copy the shared map, holding the shared lock only for the copy
+    pthread_mutex_lock(rc->shared_lock);
+    map_copyEdges(rc->map, rc->shared_map);
+    pthread_mutex_unlock(rc->shared_lock);
+
+    FILE *fp = fopen(rc->dump_temp_name, "w");
+    if (fp == NULL) {
+        fprintf(stderr, "Error, could not open %s to dump the map to\n", rc->dump_temp_name);
+        return;
+    }
+    fprintf(fp, "Map after %zu records logged, %s. Meeting point: X: %d Y: %d\n", rc->read_pos, reason,
+            map_getTargetX(rc->map), map_getTargetY(rc->map));
+    fflush(fp);
+
+    // The maze, from avatars of its own: the render thread's may be in use
+    bool written = false;
+    avatar_t **av_array = avatar_array_new(rc->num_avatars);
+    renderer_t *rd = renderer_new(fileno(fp), rc->mazeWidth, rc->mazeHeight, false);
+    if (av_array != NULL && rd != NULL) {
+        for (int i = 0; i < rc->num_avatars; i++) {
+            avatar_t *av = avatar_new(i);
+            position_setX(avatar_getPosition(av), rc->latest_positions[i].x);
+            position_setY(avatar_getPosition(av), rc->latest_positions[i].y);
+            avatar_array_add(av_array, av);
+        }
+        written = renderer_print(rd, rc->map, av_array, rc->num_avatars);
+    }
+    renderer_delete(rd);
+    if (av_array != NULL) {
+        avatar_array_delete(av_array, rc->num_avatars);
+    }
+    if (fclose(fp) != 0 || !written || rename(rc->dump_temp_name, rc->dump_file_name) != 0) {
+        fprintf(stderr, "Error, could not dump the map to %s\n", rc->dump_file_name);
+        remove(rc->dump_temp_name);
+    }
+}
+
+/**************** publish_frame ****************/
+/* Hands the render thread the positions in the record, for its next frame in place of any it was
+ * handed before, and wakes it if it has drawn every record handed to it before
+ */
+static void publish_frame(recorder_t *rc, const turn_record_t *record)
+{
+    pthread_mutex_lock(&rc->frame_lock);
+    memcpy(rc->frame_positions, record->positions, rc->num_avatars * sizeof(XYPos));
+    pthread_mutex_unlock(&rc->frame_lock);
+    if (!atomic_exchange(&rc->frame_pending, true)) {
+        sem_post(&rc->frame_wanted);
+    }
+}
+
+/**************** render_thread ****************/
+/* Until stopped: waits for a record logged since the last frame (unless drawing only on request) or a
+ * request, draws a frame of the latest, and then, to keep to the frame rate, sleeps out what is left of
+ * 1/fps seconds from when the frame began. Once stopped, draws the last frame if it is not drawn yet
+ */
+static void *render_thread(void *arg)
+{
+    recorder_t *rc = arg;
+    XYPos positions[AM_MAX_AVATAR];
+    while (1) {
+
+        // Wait for a frame to be wanted. Posts left over from frames already drawn are passed over
+        bool stopping;
+        while (!(stopping = atomic_load(&rc->render_stopping)) && !atomic_load(&rc->frame_requested)
+               && !(rc->fps > 0 && atomic_load(&rc->frame_pending))) {
+            sem_wait(&rc->frame_wanted);
+        }
+        bool requested = atomic_exchange(&rc->frame_requested, false);
+        bool pending = atomic_exchange(&rc->frame_pending, false);
+        if (!requested && !pending) {
+            break;
+        }
+
+        // Take the latest positions, and draw them
+        struct timespec began;
+        clock_gettime(CLOCK_MONOTONIC, &began);
+        pthread_mutex_lock(&rc->frame_lock);
+        memcpy(positions, rc->frame_positions, rc->num_avatars * sizeof(XYPos));
+        pthread_mutex_unlock(&rc->frame_lock);
+        draw_frame(rc, positions);
+        if (stopping) {
+            break;
+        }
+
+        // Keep to the frame rate: the next frame begins no sooner than 1/fps seconds after this one
+        if (rc->fps > 0) {
+            struct timespec next = began;
+            next.tv_nsec += NS_PER_S / rc->fps;
+            if (next.tv_nsec >= NS_PER_S) {
+                next.tv_sec += next.tv_nsec / NS_PER_S;
+                next.tv_nsec %= NS_PER_S;
+            }
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL) == EINTR) {
+                continue;                       // Interrupted by a signal: sleep out the rest
+            }
+        }
+    }
+    return NULL;
+}
+
+/**************** draw_frame ****************/
+/* Draws the maze, from a copy of the shared map and the positions given. Only the cells which changed
+ * since the last are redrawn, unless the output is not a terminal
+ */
+static void draw_frame(recorder_t *rc, const XYPos *positions)
+{
+    // Copy the shared map, holding the shared lock only for the copy
+    pthread_mutex_lock(rc->shared_lock);
+    map_copyEdges(rc->frame_map, rc->shared_map);
+    pthread_mutex_unlock(rc->shared_lock);
+
+    // Place the avatars where the record has them
+    for (int i = 0; i < rc->num_avatars; i++) {
+        position_setX(avatar_getPosition(rc->av_array[i]), positions[i].x);
+        position_setY(avatar_getPosition(rc->av_array[i]), positions[i].y);
+    }
+
+    // Draw the maze after anything printed to the screen through stdout, as the renderer writes to it directly
+    pthread_mutex_lock(&rc->screen_lock);
+    fflush(stdout);
+    renderer_draw(rc->renderer, rc->frame_map, rc->av_array, rc->num_avatars);
+    pthread_mutex_unlock(&rc->screen_lock);
+    atomic_fetch_add(&rc->frames, 1);
+}
+
+/**************** stop_render_thread ****************/
+/* Stops the render thread, once it has drawn the last frame if it was not drawn yet, and waits for it
+ */
+static void stop_render_thread(recorder_t *rc)
+{
+    atomic_store(&rc->render_stopping, true);
+    sem_post(&rc->frame_wanted);
+    pthread_join(rc->render_thread, NULL);
+}
@@ -0,0 +1,131 @@
+/* ========================================================================== */
+/* File: recorder.h
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Andrw Yang, Maria Roodnitsky, Siddharth Agrawal, Alexander Hirsch
+ * Component name:  recorder
+ *
+ * Date Created:    March 13, 2020
+ *
+ * Description:     This header file provides the interface with the recorder module. The
+ *                  recorder prints the maze to the screen and writes the log, in a thread
+ *                  of its own, after the avatars' moves have been sent.
+ *
+ *                  On its turn, an avatar sends its move to the server first, and then
+ *                  hands the recorder a turn record: a fixed-size copy of everything the
+ *                  log says about the turn (the positions, the outcome of the move before
+ *                  it, and the move requested). Records are never changed once submitted,
+ *                  so the recorder needs no lock to read them, and the avatars never wait
+ *                  on the terminal or the disk. Submitting takes no lock either: records
+ *                  go into a fixed ring of slots, and an avatar waits only if the ring
+ *                  is full.
+ *
+ *                  The recorder logs every record, in the order they were submitted, in
+ *                  the same text format the avatars used to write themselves, or in the
+ *                  binary format (see turnlog.h), keeping the
+ *                  log open for as long as it runs and flushing it after each batch of
+ *                  records it finds waiting. It prints
+ *                  the maze for the latest record only: if the screen falls behind, the
+ *                  turns in between are logged but not drawn.
+ *
+ *                  The maze is drawn by a render thread of the recorder's own, so the
+ *                  logging never waits on the terminal either. The recorder's thread hands
+ *                  it the positions of each record as it is logged, and the render
+ *                  thread draws at most fps frames a second, each of the latest positions
+ *                  it was handed when the frame began: records logged faster than that
+ *                  are not drawn. With fps 0, it draws a frame only when one is asked
+ *                  for with recorder_request_frame, and the last once the recorder is
+ *                  deleted. For a frame, it copies the shared map, holding the shared
+ *                  lock only for the copy, and draws it with a renderer (see render.h),
+ *                  which on a terminal redraws only the cells which changed since the
+ *                  last frame. A frame can show just a view of a maze too large for the
+ *                  terminal, following an avatar or the meeting point, or an overview.
+ *
+ *                  A headless recorder has no render thread, and draws nothing. Instead,
+ *                  it dumps the map, as print_map prints it, to the log's name ending in
+ *                  .map once the maze is solved. Any recorder dumps the map when asked
+ *                  to with recorder_request_dump. Dumps are made by the recorder's
+ *                  thread, from a copy of the shared map with the avatars at the latest
+ *                  positions logged, and each replaces the last whole.
+ *
+ *                  Beside the log, the recorder writes its index and checkpoints of the
+ *                  shared map (see logindex.h), so tools can go to any turn of the log.
+ *
+ */
+/* ========================================================================== */
+#ifndef __RECORDER_H
+#define __RECORDER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "amazing.h"
+#include "map.h"
+#include "turnlog.h"
+
+/**************** global constants ****************/
+#define RECORDER_DEFAULT_FPS 30         // The frames drawn a second, at most, unless told otherwise
+#define RECORDER_HEADLESS -1            // The frame rate of a recorder which draws nothing
+
+/**************** global types ****************/
+typedef struct recorder recorder_t;
+
+/**************** functions ****************/
+
+/**************** recorder_new ****************/
+/* Starts a recorder which appends to the log at log_file_name, in format, writes its index, and draws
+ * the maze, at most fps frames a second (or only on request if fps is 0, or never, dumping the map once
+ * solved, if fps is RECORDER_HEADLESS), from copies of map, a mazeWidth x mazeHeight map shared by
+ * num_avatars avatars, taken with lock held. Returns NULL if the
+ * log could not be opened or its index created, memory could not be allocated or the threads could not
+ * be started.
+ * Memory: caller is responsible for calling recorder_delete
+ */
+recorder_t *recorder_new(const char *log_file_name, log_format_t format, map_t *map, pthread_mutex_t *lock,
+                         int mazeWidth, int mazeHeight, int num_avatars, int fps);
+
+/**************** recorder_submit ****************/
+/* Hands a copy of record to the recorder, to be logged (and printed) after every record submitted
+ * before it. Safe to call from any number of threads at once, without a lock; returns without waiting
+ * for the record to be written, unless every slot of the recorder's ring is waiting to be logged.
+ */
+void recorder_submit(recorder_t *rc, const turn_record_t *record);
+
+/**************** recorder_request_frame ****************/
+/* Asks the render thread for a frame of the latest record logged, drawn as soon as the frame rate allows
+ * (at once if it draws only on request). Takes no lock, and is safe to call from a signal handler
+ */
+void recorder_request_frame(recorder_t *rc);
+
+/**************** recorder_request_dump ****************/
+/* Asks the recorder's thread to dump the map to the file named by recorder_get_dump_file_name, as soon
+ * as it has logged the records ready. Takes no lock, and is safe to call from a signal handler
+ */
+void recorder_request_dump(recorder_t *rc);
+
+/**************** recorder_set_view ****************/
+/* Makes the frames drawn show a view as large as fits on the terminal, following follow (an avatar's ID or
+ * RENDER_FOLLOW_TARGET; RENDER_FOLLOW_NONE leaves the whole maze), as an overview of block x block blocks
+ * of cells if block is more than 1 (see render.h). Dumps of the map are whole. A headless recorder draws
+ * no frames, and ignores it
+ */
+void recorder_set_view(recorder_t *rc, int follow, int block);
+
+/**************** recorder_get_dump_file_name ****************/
+/* Returns the name of the file the map is dumped to: the log's name, ending in .map
+ */
+const char *recorder_get_dump_file_name(recorder_t *rc);
+
+/**************** recorder_get_frames ****************/
+/* Returns the number of frames drawn so far
+ */
+long recorder_get_frames(recorder_t *rc);
+
+/**************** recorder_delete ****************/
+/* Waits until every record submitted has been logged, and the last of them drawn if it was not, stops
+ * the recorder's threads, and frees the memory associated with the recorder
+ */
+void recorder_delete(recorder_t *rc);
+
+#endif // __RECORDER_H
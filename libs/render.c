@@ -0,0 +1,628 @@
+/* ========================================================================== */
+/* File: render.c
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Andrw Yang, Maria Roodnitsky, Siddharth Agrawal, Alexander Hirsch
+ * Component name:  render
+ *
+ * Date Created:    March 16, 2020
+ *
+ * Description:     This file implements the render module, which draws the maze on a
+ *                  terminal redrawing only the cells which changed (see render.h).
+ *
+ *                  The screen is laid out as print_map prints it. Row 0 is the column
+ *                  header and row 1 the top border; cell (x, y) is drawn on row 2 + 2y,
+ *                  its three characters at column 4 + 4x followed by its east wall, and
+ *                  its south wall is the three characters below them, on row 3 + 2y,
+ *                  followed by a '+'. So the four characters of each cell on a row follow
+ *                  those of the cell before it, and a run of cells is redrawn after one
+ *                  cursor move.
+ *
+ *                  In a view, x and y count from the view's top left cell, and the labels
+ *                  give the cells' coordinates in the maze. The top border and the wall
+ *                  left of each row are the north and west walls of the view's edge cells,
+ *                  which are the border only where the view reaches that of the maze.
+ *
+ *                  An overview is laid out as a line saying what it shows, then a frame
+ *                  around one character for each block: block (x, y) at row 2 + y and
+ *                  column 1 + x, counting from the view's top left block.
+ *
+ */
+/* ========================================================================== */
+
+// Import C Standard libraries
+#include <stdio.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+
+// Import project-specific libraries
+#include "map.h"
+#include "AMlib_avatar.h"
+#include "render.h"
+
+/**************** file-local global variables ****************/
+// Bits of a cell's state, as drawn: its east and south walls, the avatar on it (its ID + 1, or 0), and
+// for the cells on the view's west and north edges, their west and north walls. An overview block's
+// state is the character drawn for it
+#define CELL_EAST       0x01
+#define CELL_SOUTH      0x02
+#define CELL_AVATAR_SHIFT 2
+#define CELL_TOP        (CELL_EAST | (0x0F << CELL_AVATAR_SHIFT))   // The bits drawn on the cell's own row
+#define CELL_WEST       0x40
+#define CELL_NORTH      0x80
+#define CELL_UNDRAWN    0xFF                                        // A state no cell has
+
+#define RUN_GAP 2                       // Unchanged cells redrawn, rather than moving the cursor past them
+#define OVERVIEW_RUN_GAP 8              // The same for an overview's characters
+#define CURSOR_MOVE_MAX 16              // Bytes of the longest cursor move, "\033[RRRRR;CCCCCH"
+#define OVERVIEW_TITLE_MAX 96           // Bytes of the line saying what an overview shows
+#define VIEW_WHOLE INT_MAX              // The size of a view of the whole maze
+#define CHANGES_OVERFLOW SIZE_MAX       // What compose_changes returns when the changes outgrow the buffer
+
+static const char clear_screen[] = "\033[H\033[2J";
+
+/**************** renderer struct ****************/
+typedef struct renderer {
+    int fd;
+    int mazeWidth;
+    int mazeHeight;
+    bool diff;                          // Whether frames may be drawn as the changes to the last
+    bool drawn;                         // Whether the screen shows the last frame, as drawn
+    int rows;                           // The terminal's size when the last frame was drawn, or 0
+    int cols;
+    int block;                          // The cells across and down each character of an overview, or 1
+    int follow;                         // What the view follows: an avatar's ID, or RENDER_FOLLOW_*
+    int askedWidth;                     // The view's size as set, or RENDER_VIEW_FIT, or VIEW_WHOLE
+    int askedHeight;
+    int viewX;                          // The view: its top left cell (or block), and its size
+    int viewY;
+    int viewWidth;
+    int viewHeight;
+    uint8_t *drawn_state;               // Each cell's (or block's) state in view, as on the screen
+    uint8_t *state;                     // Each cell's (or block's) state in view, in the frame being drawn
+    char *buf;                          // The frame's bytes, as composed
+    size_t capacity;
+} renderer_t;
+
+/**************** local functions ****************/
+static bool place_view(renderer_t *rd, map_t *map, avatar_t **av_array, int num_av, int rows, int cols);
+static int follow_axis(int origin, int size, int at);
+static int screen_rows(renderer_t *rd, int height);
+static int screen_cols(renderer_t *rd, int width);
+static void frame_states(renderer_t *rd, map_t *map, avatar_t **av_array, int num_av);
+static void overview_states(renderer_t *rd, map_t *map, avatar_t **av_array, int num_av);
+static size_t compose_whole(renderer_t *rd, bool clear);
+static char *compose_overview(renderer_t *rd, char *out);
+static size_t compose_changes(renderer_t *rd);
+static char *put_unit(renderer_t *rd, char *out, int i, int line, uint8_t state);
+static char *put_cell_top(renderer_t *rd, char *out, int x, uint8_t state);
+static char *put_wall(char *out, bool wall);
+static char *put_cursor(char *out, int row, int col);
+static bool terminal_size(int fd, int *rows, int *cols);
+static bool write_all(int fd, const char *buf, size_t size);
+
+/**************** renderer_new ****************/
+/* see render.h for description */
+renderer_t *renderer_new(int fd, int mazeWidth, int mazeHeight, bool diff)
+{
+    renderer_t *rd = calloc(1, sizeof(renderer_t));
+    if (rd == NULL) {
+        return NULL;
+    }
+    rd->fd = fd;
+    rd->mazeWidth = mazeWidth;
+    rd->mazeHeight = mazeHeight;
+    rd->diff = diff;
+    rd->block = 1;
+    rd->follow = RENDER_FOLLOW_NONE;
+    rd->askedWidth = VIEW_WHOLE;
+    rd->askedHeight = VIEW_WHOLE;
+    rd->viewWidth = mazeWidth;
+    rd->viewHeight = mazeHeight;
+    size_t cells = (size_t)mazeWidth * mazeHeight;
+    rd->drawn_state = malloc(cells);
+    rd->state = malloc(cells);
+
+    // Room for the whole maze after the clear; an overview takes no more. Changes which would take more
+    // than that are drawn as a whole frame instead, which sends fewer bytes anyway
+    size_t line = 4 + 4 * (size_t)mazeWidth + 1;
+    size_t whole = sizeof(clear_screen) + OVERVIEW_TITLE_MAX + (2 * (size_t)mazeHeight + 2) * line;
+    rd->capacity = whole + 1;       // and the terminator sprintf adds
+    rd->buf = malloc(rd->capacity);
+    if (rd->drawn_state == NULL || rd->state == NULL || rd->buf == NULL) {
+        renderer_delete(rd);
+        return NULL;
+    }
+    return rd;
+}
+
+/**************** renderer_draw ****************/
+/* see render.h for description */
+bool renderer_draw(renderer_t *rd, map_t *map, avatar_t **av_array, int num_av)
+{
+    // Move the view to what it follows, and size it to the terminal if it is to fit
+    int rows = 0, cols = 0;
+    bool sized = terminal_size(rd->fd, &rows, &cols);
+    bool resized = sized && (rows != rd->rows || cols != rd->cols);
+    rd->rows = rows;
+    rd->cols = cols;
+    if (place_view(rd, map, av_array, num_av, rows, cols)) {
+        rd->drawn = false;
+    }
+    frame_states(rd, map, av_array, num_av);
+
+    // Only the changes, if the screen shows the last frame and the terminal is the same size, fitting the
+    // view (as it is taken to if its size cannot be had)
+    bool fits = rd->diff && !resized && (!sized || (rows >= screen_rows(rd, rd->viewHeight)
+                                                   && cols >= screen_cols(rd, rd->viewWidth)));
+    size_t size = (fits && rd->drawn) ? compose_changes(rd) : CHANGES_OVERFLOW;
+    if (size == CHANGES_OVERFLOW) {
+        size = compose_whole(rd, true);
+    }
+
+    // What is drawn is now on the screen
+    uint8_t *swap = rd->drawn_state;
+    rd->drawn_state = rd->state;
+    rd->state = swap;
+    rd->drawn = true;
+    return size == 0 || write_all(rd->fd, rd->buf, size);
+}
+
+/**************** renderer_print ****************/
+/* see render.h for description */
+bool renderer_print(renderer_t *rd, map_t *map, avatar_t **av_array, int num_av)
+{
+    place_view(rd, map, av_array, num_av, 0, 0);
+    frame_states(rd, map, av_array, num_av);
+    size_t size = compose_whole(rd, false);
+    rd->drawn = false;
+    return write_all(rd->fd, rd->buf, size);
+}
+
+/**************** renderer_set_view ****************/
+/* see render.h for description */
+void renderer_set_view(renderer_t *rd, int viewWidth, int viewHeight, int follow)
+{
+    rd->askedWidth = (viewWidth > 0) ? viewWidth : RENDER_VIEW_FIT;
+    rd->askedHeight = (viewHeight > 0) ? viewHeight : RENDER_VIEW_FIT;
+    rd->follow = follow;
+}
+
+/**************** renderer_scroll ****************/
+/* see render.h for description */
+void renderer_scroll(renderer_t *rd, int dx, int dy)
+{
+    // The view is kept on the maze when it is next placed
+    rd->viewX += dx;
+    rd->viewY += dy;
+    rd->follow = RENDER_FOLLOW_NONE;
+}
+
+/**************** renderer_set_overview ****************/
+/* see render.h for description */
+void renderer_set_overview(renderer_t *rd, int block)
+{
+    block = (block > 1) ? block : 1;
+    if (block != rd->block) {
+
+        // Keep the view over the same part of the maze
+        rd->viewX = rd->viewX * rd->block / block;
+        rd->viewY = rd->viewY * rd->block / block;
+        rd->block = block;
+        rd->drawn = false;
+    }
+}
+
+/**************** renderer_invalidate ****************/
+/* see render.h for description */
+void renderer_invalidate(renderer_t *rd)
+{
+    rd->drawn = false;
+}
+
+/**************** renderer_delete ****************/
+/* see render.h for description */
+void renderer_delete(renderer_t *rd)
+{
+    if (rd == NULL) {
+        return;
+    }
+    free(rd->drawn_state);
+    free(rd->state);
+    free(rd->buf);
+    free(rd);
+}
+
+/**************** place_view ****************/
+/* Sizes the view as set, fitting it to a rows x cols terminal if it is to fit (or to the whole maze if rows
+ * is 0), and moves it to keep what it follows in it, and on the maze. Returns true if it moved or changed size
+ */
+static bool place_view(renderer_t *rd, map_t *map, avatar_t **av_array, int num_av, int rows, int cols)
+{
+    // The cells, or blocks of the overview, across and down the maze
+    int unitsWide = (rd->mazeWidth + rd->block - 1) / rd->block;
+    int unitsHigh = (rd->mazeHeight + rd->block - 1) / rd->block;
+
+    // The view's size, as set, or as much as fits
+    int width = rd->askedWidth;
+    int height = rd->askedHeight;
+    if (width == RENDER_VIEW_FIT) {
+        width = (cols > 0) ? (cols - screen_cols(rd, 0)) / (screen_cols(rd, 1) - screen_cols(rd, 0)) : VIEW_WHOLE;
+    }
+    if (height == RENDER_VIEW_FIT) {
+        height = (rows > 0) ? (rows - screen_rows(rd, 0)) / (screen_rows(rd, 1) - screen_rows(rd, 0)) : VIEW_WHOLE;
+    }
+    width = (width < 1) ? 1 : (width > unitsWide) ? unitsWide : width;
+    height = (height < 1) ? 1 : (height > unitsHigh) ? unitsHigh : height;
+
+    // Where what the view follows is
+    int x = rd->viewX;
+    int y = rd->viewY;
+    int fx = -1, fy = -1;
+    if (rd->follow == RENDER_FOLLOW_TARGET) {
+        fx = map_getTargetX(map);
+        fy = map_getTargetY(map);
+    } else if (rd->follow >= 0 && rd->follow < num_av && av_array[rd->follow] != NULL) {
+        fx = avatar_getX(av_array[rd->follow]);
+        fy = avatar_getY(av_array[rd->follow]);
+    }
+    if (fx >= 0 && fx < rd->mazeWidth && fy >= 0 && fy < rd->mazeHeight) {
+        x = follow_axis(x, width, fx / rd->block);
+        y = follow_axis(y, height, fy / rd->block);
+    }
+
+    // Kept on the maze
+    x = (x > unitsWide - width) ? unitsWide - width : x;
+    y = (y > unitsHigh - height) ? unitsHigh - height : y;
+    x = (x < 0) ? 0 : x;
+    y = (y < 0) ? 0 : y;
+
+    bool moved = (x != rd->viewX || y != rd->viewY || width != rd->viewWidth || height != rd->viewHeight);
+    rd->viewX = x;
+    rd->viewY = y;
+    rd->viewWidth = width;
+    rd->viewHeight = height;
+    return moved;
+}
+
+/**************** follow_axis ****************/
+/* Returns where a view starting at origin, size long, starts next along one axis to keep at in it: where it
+ * is, unless at is within a quarter of the view of its edge or out of it, and then centred on at
+ */
+static int follow_axis(int origin, int size, int at)
+{
+    int margin = size / 4;
+    if (at < origin + margin || at >= origin + size - margin) {
+        return at - size / 2;
+    }
+    return origin;
+}
+
+/**************** screen_rows ****************/
+/* Returns the rows of the screen a frame height cells (or blocks) high takes, with the line the cursor is
+ * left on below it
+ */
+static int screen_rows(renderer_t *rd, int height)
+{
+    return (rd->block > 1) ? height + 4 : 2 * height + 3;
+}
+
+/**************** screen_cols ****************/
+/* Returns the columns of the screen a frame width cells (or blocks) wide takes
+ */
+static int screen_cols(renderer_t *rd, int width)
+{
+    return (rd->block > 1) ? width + 2 : 4 * width + 4;
+}
+
+/**************** frame_states ****************/
+/* Sets the state of each cell in view from the map's wall masks, and then from the avatars, from the
+ * highest numbered down, so the lowest numbered avatar on a cell is the one it holds. Sets the state of
+ * each block of an overview instead, if drawing one
+ */
+static void frame_states(renderer_t *rd, map_t *map, avatar_t **av_array, int num_av)
+{
+    if (rd->block > 1) {
+        overview_states(rd, map, av_array, num_av);
+        return;
+    }
+    int width = rd->viewWidth;
+    for (int j = 0; j < rd->viewHeight; j++) {
+        for (int i = 0; i < width; i++) {
+            int mask = map_wallMask(map, rd->viewX + i, rd->viewY + j);
+            rd->state[j * width + i] = ((mask & MAP_WALL_EAST) ? CELL_EAST : 0) | ((mask & MAP_WALL_SOUTH) ? CELL_SOUTH : 0)
+                | ((i == 0 && (mask & MAP_WALL_WEST)) ? CELL_WEST : 0) | ((j == 0 && (mask & MAP_WALL_NORTH)) ? CELL_NORTH : 0);
+        }
+    }
+    for (int a = num_av - 1; a >= 0; a--) {
+        if (av_array[a] == NULL) {
+            continue;
+        }
+        int i = avatar_getX(av_array[a]) - rd->viewX;
+        int j = avatar_getY(av_array[a]) - rd->viewY;
+        int id = avatar_getAvatarID(av_array[a]);
+        if (i >= 0 && i < width && j >= 0 && j < rd->viewHeight && id >= 0 && id < 0x0F) {
+            uint8_t *cell = &rd->state[j * width + i];
+            *cell = (*cell & (uint8_t)~(0x0F << CELL_AVATAR_SHIFT)) | (uint8_t)((id + 1) << CELL_AVATAR_SHIFT);
+        }
+    }
+}
+
+/**************** overview_states ****************/
+/* Sets the state of each block in view of an overview: the character for how much of the edges of its
+ * cells to cells on the maze are known, then '@' if the meeting point is in it, and then the lowest
+ * numbered avatar in it
+ */
+static void overview_states(renderer_t *rd, map_t *map, avatar_t **av_array, int num_av)
+{
+    int block = rd->block;
+    int width = rd->viewWidth;
+    for (int j = 0; j < rd->viewHeight; j++) {
+        for (int i = 0; i < width; i++) {
+            int x0 = (rd->viewX + i) * block;
+            int y0 = (rd->viewY + j) * block;
+            int known = 0, edges = 0;
+            for (int y = y0; y < y0 + block && y < rd->mazeHeight; y++) {
+                for (int x = x0; x < x0 + block && x < rd->mazeWidth; x++) {
+                    map_cell_t cell = {x, y};
+                    for (int dir = 0; dir < M_NUM_DIRECTIONS; dir++) {
+                        map_cell_t next = {x + (dir == M_EAST) - (dir == M_WEST), y + (dir == M_SOUTH) - (dir == M_NORTH)};
+                        map_state_t edge = map_getEdge(map, cell, next);
+                        edges += (edge != MAP_INVALID);
+                        known += (edge == MAP_OPEN || edge == MAP_WALL);
+                    }
+                }
+            }
+            rd->state[j * width + i] = (known == 0) ? ' ' : (2 * known < edges) ? '.' : (known < edges) ? ':' : '#';
+        }
+    }
+    int i = map_getTargetX(map) / block - rd->viewX;
+    int j = map_getTargetY(map) / block - rd->viewY;
+    if (map_validXY(map, map_getTargetX(map), map_getTargetY(map)) && i >= 0 && i < width && j >= 0 && j < rd->viewHeight) {
+        rd->state[j * width + i] = '@';
+    }
+    for (int a = num_av - 1; a >= 0; a--) {
+        if (av_array[a] == NULL || avatar_getX(av_array[a]) < 0 || avatar_getY(av_array[a]) < 0) {
+            continue;
+        }
+        i = avatar_getX(av_array[a]) / block - rd->viewX;
+        j = avatar_getY(av_array[a]) / block - rd->viewY;
+        int id = avatar_getAvatarID(av_array[a]);
+        if (i >= 0 && i < width && j >= 0 && j < rd->viewHeight && id >= 0 && id < 10) {
+            rd->state[j * width + i] = (uint8_t)('0' + id);
+        }
+    }
+}
+
+/**************** compose_whole ****************/
+/* Composes the whole frame into the buffer, as print_map prints the maze (for the cells in view), after
+ * the clear if clear is true. Returns its size
+ */
+static size_t compose_whole(renderer_t *rd, bool clear)
+{
+    int width = rd->viewWidth;
+    char *out = rd->buf;
+    if (clear) {
+        memcpy(out, clear_screen, strlen(clear_screen));
+        out += strlen(clear_screen);
+    }
+    if (rd->block > 1) {
+        return compose_overview(rd, out) - rd->buf;
+    }
+
+    // The column header and the top border, or the north walls of the view's top row
+    out += sprintf(out, "   ");
+    for (int i = 0; i < width; i++) {
+        out += sprintf(out, "%3d ", (rd->viewX + i) % 1000);
+    }
+    *out++ = '\n';
+    memcpy(out, "   +", 4);
+    out += 4;
+    for (int i = 0; i < width; i++) {
+        out = put_wall(out, rd->state[i] & CELL_NORTH);
+    }
+    *out++ = '\n';
+
+    // Each row of cells, after the west wall of its first, and the south walls below it
+    for (int j = 0; j < rd->viewHeight; j++) {
+        const uint8_t *state = &rd->state[j * width];
+        out += sprintf(out, "%3d", (rd->viewY + j) % 1000);
+        *out++ = (state[0] & CELL_WEST) ? '|' : ' ';
+        for (int i = 0; i < width; i++) {
+            out = put_cell_top(rd, out, rd->viewX + i, state[i]);
+        }
+        *out++ = '\n';
+        memcpy(out, "   +", 4);
+        out += 4;
+        for (int i = 0; i < width; i++) {
+            out = put_wall(out, state[i] & CELL_SOUTH);
+        }
+        *out++ = '\n';
+    }
+    return out - rd->buf;
+}
+
+/**************** compose_overview ****************/
+/* Composes the whole overview at out: the line saying what it shows, and the blocks in view in a frame.
+ * Returns where the next characters go
+ */
+static char *compose_overview(renderer_t *rd, char *out)
+{
+    int width = rd->viewWidth;
+    out += snprintf(out, OVERVIEW_TITLE_MAX, "Overview, %d x %d cells a character, from cell (%d, %d)\n",
+                    rd->block, rd->block, rd->viewX * rd->block, rd->viewY * rd->block);
+    for (int line = 0; line < 2; line++) {
+        *out++ = '+';
+        memset(out, '-', width);
+        out += width;
+        memcpy(out, "+\n", 2);
+        out += 2;
+
+        // The blocks, between the top border and the bottom one
+        for (int j = 0; line == 0 && j < rd->viewHeight; j++) {
+            *out++ = '|';
+            memcpy(out, &rd->state[j * width], width);
+            out += width;
+            memcpy(out, "|\n", 2);
+            out += 2;
+        }
+    }
+    return out;
+}
+
+/**************** compose_changes ****************/
+/* Composes into the buffer the cells (or blocks) whose state changed since they were drawn, each run of
+ * them on a line after a cursor move, and then a move to below the frame. Returns its size, 0 if none changed,
+ * or CHANGES_OVERFLOW if they do not fit in the buffer
+ */
+static size_t compose_changes(renderer_t *rd)
+{
+    bool overview = rd->block > 1;
+    int width = rd->viewWidth;
+    int gap = overview ? OVERVIEW_RUN_GAP : RUN_GAP;
+    char *out = rd->buf;
+
+    // Past limit, there may be no room for a cursor move and a unit (CURSOR_MOVE_MAX + 4) and the move below the frame
+    const char *limit = rd->buf + rd->capacity - 1 - CURSOR_MOVE_MAX - (CURSOR_MOVE_MAX + 4);
+    for (int j = 0; j < rd->viewHeight; j++) {
+        const uint8_t *state = &rd->state[j * width];
+        const uint8_t *drawn = &rd->drawn_state[j * width];
+
+        // The west wall of the row's first cell, left of it
+        if (!overview && ((state[0] ^ drawn[0]) & CELL_WEST) != 0) {
+            if (out > limit) {
+                return CHANGES_OVERFLOW;
+            }
+            out = put_cursor(out, 2 + 2 * j, 3);
+            *out++ = (state[0] & CELL_WEST) ? '|' : ' ';
+        }
+
+        // The lines of the row: for cells, the north walls above the top row (line -1), the cells' own
+        // line (0) and the south walls below it (1); for an overview, the blocks' characters
+        for (int line = (!overview && j == 0) ? -1 : 0; line <= (overview ? 0 : 1); line++) {
+            uint8_t bits = overview ? 0xFF : (line < 0) ? CELL_NORTH : (line == 0) ? CELL_TOP : CELL_SOUTH;
+            int i = 0;
+            while (i < width) {
+                if (((state[i] ^ drawn[i]) & bits) == 0) {
+                    i++;
+                    continue;
+                }
+
+                // A run: from this unit to the last changed one with no more than gap unchanged between
+                int end = i + 1;
+                for (int next = i + 1; next < width && next <= end + gap; next++) {
+                    if (((state[next] ^ drawn[next]) & bits) != 0) {
+                        end = next + 1;
+                    }
+                }
+                if (out > limit) {
+                    return CHANGES_OVERFLOW;
+                }
+                out = overview ? put_cursor(out, 2 + j, 1 + i) : put_cursor(out, 2 + 2 * j + line, 4 + 4 * i);
+                for (; i < end; i++) {
+                    if (out > limit) {
+                        return CHANGES_OVERFLOW;
+                    }
+                    out = put_unit(rd, out, i, line, state[i]);
+                }
+            }
+        }
+    }
+    if (out == rd->buf) {
+        return 0;
+    }
+    out = put_cursor(out, screen_rows(rd, rd->viewHeight) - 1, 0);
+    return out - rd->buf;
+}
+
+/**************** put_unit ****************/
+/* Writes what line line of the frame shows of the unit i of a row in view in state: a block's character,
+ * or the cell's north walls, its own four characters, or its south walls. Returns where the next characters go
+ */
+static char *put_unit(renderer_t *rd, char *out, int i, int line, uint8_t state)
+{
+    if (rd->block > 1) {
+        *out++ = (char)state;
+        return out;
+    }
+    if (line == 0) {
+        return put_cell_top(rd, out, rd->viewX + i, state);
+    }
+    return put_wall(out, state & ((line < 0) ? CELL_NORTH : CELL_SOUTH));
+}
+
+/**************** put_cell_top ****************/
+/* Writes the four characters of cell x on its own row, in state: the avatar on it or blanks, and its
+ * east wall (always a wall on the last column). Returns where the next characters go
+ */
+static char *put_cell_top(renderer_t *rd, char *out, int x, uint8_t state)
+{
+    int avatar = (state >> CELL_AVATAR_SHIFT) & 0x0F;
+    out[0] = ' ';
+    out[1] = (avatar > 0) ? (char)('0' + avatar - 1) : ' ';
+    out[2] = ' ';
+    out[3] = ((state & CELL_EAST) || x == rd->mazeWidth - 1) ? '|' : ' ';
+    return out + 4;
+}
+
+/**************** put_wall ****************/
+/* Writes the four characters of a cell's wall on the line above or below it: the wall or blanks, and a
+ * corner
+ */
+static char *put_wall(char *out, bool wall)
+{
+    memcpy(out, wall ? "---+" : "   +", 4);
+    return out + 4;
+}
+
+/**************** put_cursor ****************/
+/* Writes the escape moving the cursor to row and col, counted from 0. Returns where the next
+ * characters go
+ */
+static char *put_cursor(char *out, int row, int col)
+{
+    return out + sprintf(out, "\033[%d;%dH", row + 1, col + 1);
+}
+
+/**************** terminal_size ****************/
+/* Sets *rows and *cols to the size of the terminal fd is, and returns true; or sets them to 0, and returns
+ * false, if the size cannot be had
+ */
+static bool terminal_size(int fd, int *rows, int *cols)
+{
+    struct winsize size;
+    if (ioctl(fd, TIOCGWINSZ, &size) != 0 || size.ws_row == 0 || size.ws_col == 0) {
+        *rows = 0;
+        *cols = 0;
+        return false;
+    }
+    *rows = size.ws_row;
+    *cols = size.ws_col;
+    return true;
+}
+
+/**************** write_all ****************/
+/* Writes size bytes of buf to fd, in one write() unless it takes fewer. Returns false on an error
+ */
+static bool write_all(int fd, const char *buf, size_t size)
+{
+    while (size > 0) {
+        ssize_t written = write(fd, buf, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        buf += written;
+        size -= written;
+    }
+    return true;
+}
@@ -0,0 +1,118 @@
+/* ========================================================================== */
+/* File: render.h
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Andrw Yang, Maria Roodnitsky, Siddharth Agrawal, Alexander Hirsch
+ * Component name:  render
+ *
+ * Date Created:    March 16, 2020
+ *
+ * Description:     This header file provides the interface with the render module, which
+ *                  draws the maze on a terminal frame after frame, looking as print_map
+ *                  prints it.
+ *
+ *                  The renderer keeps the state of every cell as last drawn: its walls to
+ *                  the east and south, and the avatar on it. To draw a frame it works out
+ *                  the state of each cell from the map and the avatars, and for the cells
+ *                  whose state changed only, composes the characters to redraw, each run
+ *                  of them after an ANSI escape moving the cursor to it, in a buffer
+ *                  allocated once. It sends the buffer with a single write(), and nothing
+ *                  if no cell changed. So the bytes sent, and the time the terminal takes
+ *                  with them, go with the number of cells that changed rather than with
+ *                  the size of the maze.
+ *
+ *                  The whole frame is drawn, after an escape clearing the screen, for the
+ *                  first frame, after renderer_invalidate (when something else has
+ *                  written to the terminal), when the terminal changes size or the view
+ *                  moves, and for every frame when the view does not fit on the terminal,
+ *                  or the renderer was made to draw whole frames only (when the output is
+ *                  not a terminal).
+ *
+ *                  A maze much wider than 50 cells does not fit on a terminal, so a frame
+ *                  can show just a view of it: a window of the cells, labelled with their
+ *                  coordinates, which follows an avatar or the meeting point, moving by
+ *                  half a window once what it follows nears its edge, or stays where it
+ *                  was scrolled to. Instead of the cells, a frame can show an overview, in
+ *                  which each character stands for a block of cells: the lowest numbered
+ *                  avatar in the block, '@' for the meeting point, or else how much of the
+ *                  block's edges are known: ' ' none, '.' less than half, ':' at least
+ *                  half and '#' all. A view can be had of an overview as of the cells.
+ *                  Working out a frame of the cells takes time in the cells in view, and
+ *                  its bytes go with them, however large the maze.
+ *
+ */
+/* ========================================================================== */
+#ifndef __RENDER_H
+#define __RENDER_H
+
+#include <stdbool.h>
+#include "map.h"
+#include "AMlib_avatar.h"
+
+/**************** global constants ****************/
+#define RENDER_FOLLOW_NONE -1           // The view stays where it was scrolled to
+#define RENDER_FOLLOW_TARGET -2         // The view follows the meeting point
+#define RENDER_VIEW_FIT 0               // A view as wide, or as high, as fits on the terminal
+
+/**************** global types ****************/
+typedef struct renderer renderer_t;
+
+/**************** functions ****************/
+
+/**************** renderer_new ****************/
+/* Creates a renderer drawing a mazeWidth x mazeHeight maze to the file descriptor fd. If diff is false,
+ * every frame is drawn whole. Returns NULL if memory could not be allocated.
+ * Memory: caller is responsible for calling renderer_delete
+ */
+renderer_t *renderer_new(int fd, int mazeWidth, int mazeHeight, bool diff);
+
+/**************** renderer_draw ****************/
+/* Draws the maze, as map has it, with the num_av avatars of av_array where they are: the lowest
+ * numbered avatar on a cell is the one shown. Only the view is drawn, moved first to keep what it
+ * follows in it, and as an overview if the renderer was set to draw one. Anything written to the same terminal through stdio
+ * must be flushed first. Returns false if the frame could not be written
+ */
+bool renderer_draw(renderer_t *rd, map_t *map, avatar_t **av_array, int num_av);
+
+/**************** renderer_print ****************/
+/* Writes the whole maze, as map has it, with the num_av avatars of av_array where they are, as print_map
+ * prints it and with no escapes, for a file rather than a terminal; or the view, or overview, if the
+ * renderer was set to draw one (as it is not a terminal, a view fitting it is the whole maze). The next
+ * frame drawn is drawn whole.
+ * Returns false if it could not be written
+ */
+bool renderer_print(renderer_t *rd, map_t *map, avatar_t **av_array, int num_av);
+
+/**************** renderer_set_view ****************/
+/* Makes the frames show a view of viewWidth x viewHeight cells (or blocks, in an overview), each of them
+ * RENDER_VIEW_FIT for as many as fit on the terminal, or the whole maze if the terminal's size cannot be
+ * had. The view follows follow: an avatar's ID, RENDER_FOLLOW_TARGET, or RENDER_FOLLOW_NONE to stay where
+ * it is scrolled to. A view is never larger than the maze; a new renderer shows the whole maze
+ */
+void renderer_set_view(renderer_t *rd, int viewWidth, int viewHeight, int follow);
+
+/**************** renderer_scroll ****************/
+/* Moves the view dx cells (or blocks) right and dy down, as far as the maze goes, and stops it following
+ * anything
+ */
+void renderer_scroll(renderer_t *rd, int dx, int dy);
+
+/**************** renderer_set_overview ****************/
+/* Makes the frames show an overview of the maze, each character for a block x block block of cells, or
+ * the cells again if block is 1 or less
+ */
+void renderer_set_overview(renderer_t *rd, int block);
+
+/**************** renderer_invalidate ****************/
+/* Makes the next frame be drawn whole, as something other than the renderer has written to the
+ * terminal since the last
+ */
+void renderer_invalidate(renderer_t *rd);
+
+/**************** renderer_delete ****************/
+/* Frees the memory associated with the renderer
+ */
+void renderer_delete(renderer_t *rd);
+
+#endif // __RENDER_H
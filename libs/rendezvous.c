@@ -0,0 +1,310 @@
+/* ========================================================================== */
+/* File: rendezvous.c
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Andrw Yang, Maria Roodnitsky, Siddharth Agrawal, Alexander Hirsch
+ * Component name:  rendezvous
+ *
+ * Date Created:    March 11, 2020
+ *
+ * Description:     This file implements the rendezvous module, which elects the meeting
+ *                  point of the avatars (see rendezvous.h).
+ *
+ *                  The server takes turns round-robin and counts every turn as a move,
+ *                  even the null move of an avatar waiting at the meeting point. So the
+ *                  moves left are about the number of avatars times the distance of the
+ *                  avatar farthest from the meeting point, and that is what an election
+ *                  minimizes: the winner is the center of the avatars rather than their
+ *                  median. An election runs one breadth-first search per avatar over the
+ *                  edges not known to be walls, and keeps, for each cell, the distance of
+ *                  the farthest avatar and the summed distance of all of them. The winner
+ *                  is the cell every avatar can reach with the smallest farthest distance,
+ *                  ties going to the smallest sum. It replaces the current meeting point
+ *                  only if its farthest distance is shorter by at least RENDEZVOUS_MIN_GAIN
+ *                  moves and by 1/RENDEZVOUS_GAIN_FRACTION of the current one, or if walls
+ *                  have cut some avatar off from the current one.
+ *
+ *                  A poll (the searches and the pick) costs time in the number of avatars
+ *                  times the cells of the maze, so it is not run every turn. A turn on
+ *                  which no avatar moved, no wall changed and the target is where the last
+ *                  poll left it would pick the same cell again, and polls nothing. Otherwise
+ *                  a poll runs only once enough turns have gone by since the last to keep
+ *                  the cells searched under RENDEZVOUS_TURN_BUDGET a turn, on average, or
+ *                  at once if the map has no target. Walls learned cannot cut an avatar
+ *                  off from the target of a perfect maze, so that need not poll at once;
+ *                  only dead-end filling walls off cells, and it spares the target. So on
+ *                  a 100 x 100 maze with 10 avatars a poll searches 100000 cells, and runs
+ *                  at most every 7th turn.
+ *                  When the avatars times the cells are within the budget, a poll runs on
+ *                  every turn that changed something, and picks what it always did.
+ *
+ */
+/* ========================================================================== */
+
+// Import C Standard libraries
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+// Import project-specific libraries
+#include "amazing.h"
+#include "AMlib_avatar.h"
+#include "map.h"
+#include "rendezvous.h"
+
+// Smallest saving, in moves of the farthest avatar, for which the meeting point moves
+static const int RENDEZVOUS_MIN_GAIN = 2;
+
+// The saving must also be at least this fraction (1/n) of the farthest avatar's current distance
+static const int RENDEZVOUS_GAIN_FRACTION = 8;
+
+// Cells a turn may spend searching on polls, summed over the avatars and averaged over the turns between polls
+static const int RENDEZVOUS_TURN_BUDGET = 16384;
+
+/**************** rendezvous struct ****************/
+typedef struct rendezvous {
+    int mazeWidth;
+    int mazeHeight;
+    int *queue;         // Search scratch: cells in the order they were reached
+    int *distance;      // Search scratch: distance of each cell from the avatar searched from, or -1
+    int *total;         // Summed distance of each cell from the avatars that reach it
+    int *farthest;      // Distance of each cell from the farthest avatar that reaches it
+    int *reached;       // Number of avatars that reach each cell
+    int elections;      // Number of times the meeting point has moved
+    int polls;          // Number of times the searches were run
+    int turns;          // Updates since the last poll
+    int wallChanges;    // The map's wall changes at the last poll, or -1 before the first
+    int target;         // The target cell the last poll left, as y * mazeWidth + x
+    int x[AM_MAX_AVATAR];   // The positions the last poll was run for, -100 for avatars not placed
+    int y[AM_MAX_AVATAR];
+} rendezvous_t;
+
+/**************** local functions ****************/
+static bool poll_due(rendezvous_t *rv, map_t *mp, avatar_t **av_array, int num_av);
+static void search_from(rendezvous_t *rv, map_t *mp, int start);
+
+/**************** rendezvous_new ****************/
+/* Allocates a rendezvous and the search scratch for a mazeWidth x mazeHeight map
+ * Memory: caller is responsible for calling rendezvous_delete
+ */
+rendezvous_t *rendezvous_new(int mazeWidth, int mazeHeight)
+{
+    rendezvous_t *rv = malloc(sizeof(rendezvous_t));
+    if (rv == NULL) {
+        return NULL;
+    }
+    int num_cells = mazeWidth * mazeHeight;
+    rv->mazeWidth = mazeWidth;
+    rv->mazeHeight = mazeHeight;
+    rv->queue = malloc(num_cells * sizeof(int));
+    rv->distance = malloc(num_cells * sizeof(int));
+    rv->total = malloc(num_cells * sizeof(int));
+    rv->farthest = malloc(num_cells * sizeof(int));
+    rv->reached = malloc(num_cells * sizeof(int));
+    rv->elections = 0;
+    rv->polls = 0;
+    rv->turns = 0;
+    rv->wallChanges = -1;
+    rv->target = -1;
+    for (int i = 0; i < AM_MAX_AVATAR; i++) {
+        rv->x[i] = -100;
+        rv->y[i] = -100;
+    }
+    if (rv->queue == NULL || rv->distance == NULL || rv->total == NULL || rv->farthest == NULL || rv->reached == NULL) {
+        rendezvous_delete(rv);
+        return NULL;
+    }
+    return rv;
+}
+
+/**************** rendezvous_delete ****************/
+/* Frees the rendezvous and its search scratch
+ */
+void rendezvous_delete(rendezvous_t *rv)
+{
+    if (rv == NULL) {
+        return;
+    }
+    free(rv->queue);
+    free(rv->distance);
+    free(rv->total);
+    free(rv->farthest);
+    free(rv->reached);
+    free(rv);
+}
+
+/**************** rendezvous_copy ****************/
+/* Copies what src knows of its last poll, and its counts, into dst. The search scratch is not copied
+ */
+void rendezvous_copy(rendezvous_t *dst, rendezvous_t *src)
+{
+    dst->elections = src->elections;
+    dst->polls = src->polls;
+    dst->turns = src->turns;
+    dst->wallChanges = src->wallChanges;
+    dst->target = src->target;
+    memcpy(dst->x, src->x, sizeof(dst->x));
+    memcpy(dst->y, src->y, sizeof(dst->y));
+}
+
+/**************** rendezvous_update ****************/
+/* Elects the best meeting point for the avatars' current positions, if a poll is due, and moves the
+ * map's target there if it clears the hysteresis margin (see top of file). Avatars not yet placed in
+ * av_array are ignored. Returns true if the target moved.
+ * Memory: does not allocate memory
+ */
+bool rendezvous_update(rendezvous_t *rv, map_t *mp, avatar_t **av_array, int num_av)
+{
+    if (!poll_due(rv, mp, av_array, num_av)) {
+        return false;
+    }
+    int width = rv->mazeWidth;
+    int num_cells = width * rv->mazeHeight;
+    memset(rv->total, 0, num_cells * sizeof(int));
+    memset(rv->farthest, 0, num_cells * sizeof(int));
+    memset(rv->reached, 0, num_cells * sizeof(int));
+
+    // Sum every cell's distance from each avatar
+    int num_searched = 0;
+    for (int i = 0; i < num_av; i++) {
+        if (av_array[i] == NULL || !map_validXY(mp, avatar_getX(av_array[i]), avatar_getY(av_array[i]))) {
+            continue;
+        }
+        search_from(rv, mp, avatar_getY(av_array[i]) * width + avatar_getX(av_array[i]));
+        for (int cell = 0; cell < num_cells; cell++) {
+            int d = rv->distance[cell];
+            if (d >= 0) {
+                rv->total[cell] += d;
+                rv->reached[cell]++;
+                if (d > rv->farthest[cell]) {
+                    rv->farthest[cell] = d;
+                }
+            }
+        }
+        num_searched++;
+    }
+    if (num_searched == 0) {
+        return false;
+    }
+
+    // Find the best cell which every avatar reaches
+    int best = -1;
+    for (int cell = 0; cell < num_cells; cell++) {
+        if (rv->reached[cell] == num_searched && (best == -1 || rv->farthest[cell] < rv->farthest[best] ||
+            (rv->farthest[cell] == rv->farthest[best] && rv->total[cell] < rv->total[best]))) {
+            best = cell;
+        }
+    }
+    if (best == -1) {
+        return false;   // Walls split the avatars: no consistent map of a perfect maze does this
+    }
+
+    // Keep the current meeting point unless the best one saves a clear margin over it
+    int target_x = map_getTargetX(mp);
+    int target_y = map_getTargetY(mp);
+    if (map_validXY(mp, target_x, target_y)) {
+        int current = target_y * width + target_x;
+        if (current == best) {
+            return false;
+        }
+        if (rv->reached[current] == num_searched) {
+            int gain = rv->farthest[current] - rv->farthest[best];
+            if (gain < RENDEZVOUS_MIN_GAIN || gain < rv->farthest[current] / RENDEZVOUS_GAIN_FRACTION) {
+                return false;
+            }
+        }
+    }
+
+    map_setTargetXY(mp, best % width, best / width);
+    rv->target = best;
+    rv->elections++;
+    return true;
+}
+
+/**************** rendezvous_getElections ****************/
+int rendezvous_getElections(rendezvous_t *rv)
+{
+    return rv->elections;
+}
+
+/**************** rendezvous_getPolls ****************/
+int rendezvous_getPolls(rendezvous_t *rv)
+{
+    return rv->polls;
+}
+
+/**************** poll_due ****************/
+/* Counts the update, and returns true if a poll is to run now (see top of file). If so, notes the
+ * positions, walls and target it runs for, and starts the count of updates again
+ */
+static bool poll_due(rendezvous_t *rv, map_t *mp, avatar_t **av_array, int num_av)
+{
+    rv->turns++;
+
+    // Nothing the last poll was run for has changed: it would pick the same cell again
+    int target = map_validXY(mp, map_getTargetX(mp), map_getTargetY(mp)) ?
+        map_getTargetY(mp) * rv->mazeWidth + map_getTargetX(mp) : -1;
+    bool changed = rv->wallChanges != map_getWallChanges(mp) || rv->target != target;
+    for (int i = 0; i < num_av && i < AM_MAX_AVATAR; i++) {
+        int x = (av_array[i] != NULL) ? avatar_getX(av_array[i]) : -100;
+        int y = (av_array[i] != NULL) ? avatar_getY(av_array[i]) : -100;
+        changed = changed || x != rv->x[i] || y != rv->y[i];
+    }
+    if (!changed) {
+        return false;
+    }
+
+    // Otherwise poll once the cells searched, spread over the turns since the last poll, fit the budget
+    int interval = (num_av * rv->mazeWidth * rv->mazeHeight + RENDEZVOUS_TURN_BUDGET - 1) / RENDEZVOUS_TURN_BUDGET;
+    if (target != -1 && rv->polls > 0 && rv->turns < interval) {
+        return false;
+    }
+    for (int i = 0; i < num_av && i < AM_MAX_AVATAR; i++) {
+        rv->x[i] = (av_array[i] != NULL) ? avatar_getX(av_array[i]) : -100;
+        rv->y[i] = (av_array[i] != NULL) ? avatar_getY(av_array[i]) : -100;
+    }
+    rv->wallChanges = map_getWallChanges(mp);
+    rv->target = target;
+    rv->turns = 0;
+    rv->polls++;
+    return true;
+}
+
+/**************** search_from ****************/
+/* Breadth-first search from cell start over the edges not known to be walls. Leaves each cell's
+ * distance from start in rv->distance, or -1 for cells walls cut off from it.
+ */
+static void search_from(rendezvous_t *rv, map_t *mp, int start)
+{
+    int width = rv->mazeWidth;
+    memset(rv->distance, -1, width * rv->mazeHeight * sizeof(int));
+    int head = 0;
+    int tail = 0;
+    rv->queue[tail++] = start;
+    rv->distance[start] = 0;
+    while (head < tail) {
+        int cell = rv->queue[head++];
+        int next_distance = rv->distance[cell] + 1;
+        int mask = map_wallMask(mp, cell % width, cell / width);
+
+        // Border sides are walls in the mask, so every open side leads to a cell on the map
+        if (!(mask & MAP_WALL_WEST) && rv->distance[cell - 1] < 0) {
+            rv->distance[cell - 1] = next_distance;
+            rv->queue[tail++] = cell - 1;
+        }
+        if (!(mask & MAP_WALL_NORTH) && rv->distance[cell - width] < 0) {
+            rv->distance[cell - width] = next_distance;
+            rv->queue[tail++] = cell - width;
+        }
+        if (!(mask & MAP_WALL_SOUTH) && rv->distance[cell + width] < 0) {
+            rv->distance[cell + width] = next_distance;
+            rv->queue[tail++] = cell + width;
+        }
+        if (!(mask & MAP_WALL_EAST) && rv->distance[cell + 1] < 0) {
+            rv->distance[cell + 1] = next_distance;
+            rv->queue[tail++] = cell + 1;
+        }
+    }
+}
@@ -0,0 +1,81 @@
+/* ========================================================================== */
+/* File: rendezvous.h
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Andrw Yang, Maria Roodnitsky, Siddharth Agrawal, Alexander Hirsch
+ * Component name:  rendezvous
+ *
+ * Date Created:    March 11, 2020
+ *
+ * Description:     This header file provides the interface with the rendezvous module.
+ *                  The rendezvous module elects the meeting point of the avatars: the
+ *                  cell which the farthest avatar can reach soonest, over edges not known
+ *                  to be walls (the center of the avatars, which is what the server's
+ *                  move count depends on; see rendezvous.c). The elected cell is set as
+ *                  the map's target, so that the distance field, dead-end filling and the
+ *                  move strategies all follow it.
+ *
+ *                  rendezvous_update re-elects from the current map and positions. It
+ *                  only moves the meeting point when the new cell saves a clear margin of
+ *                  moves (see rendezvous.c), so that it does not jump back and forth
+ *                  between cells of nearly equal cost as walls are learned. The searches
+ *                  behind an election take time in the cells of the maze, so they are run
+ *                  only when the positions, the walls or the target changed, and on a large
+ *                  maze only every few turns (see rendezvous.c). What a rendezvous knows of
+ *                  its last election is copied with rendezvous_copy, so that the copies a
+ *                  speculation decides on carry it, and hand it back with their moves.
+ *
+ *                  One rendezvous is shared by all avatars, and, like the map, is only
+ *                  used with the shared structures locked.
+ *
+ */
+/* ========================================================================== */
+#ifndef __RENDEZVOUS_H
+#define __RENDEZVOUS_H
+
+#include <stdbool.h>
+#include "AMlib_avatar.h"
+#include "map.h"
+
+/**************** global types ****************/
+typedef struct rendezvous rendezvous_t;
+
+/**************** functions ****************/
+
+/**************** rendezvous_new ****************/
+/* Allocates a rendezvous for a mazeWidth x mazeHeight map, with the search scratch it needs
+ * for elections. Returns NULL if memory could not be allocated.
+ * Memory: caller is responsible for calling rendezvous_delete
+ */
+rendezvous_t *rendezvous_new(int mazeWidth, int mazeHeight);
+
+/**************** rendezvous_delete ****************/
+/* Frees the memory associated with the rendezvous. Does not touch the map.
+ */
+void rendezvous_delete(rendezvous_t *rv);
+
+/**************** rendezvous_copy ****************/
+/* Copies what src knows of its last election, and its counts, into dst, a rendezvous for a map of
+ * the same size
+ */
+void rendezvous_copy(rendezvous_t *dst, rendezvous_t *src);
+
+/**************** rendezvous_update ****************/
+/* Re-elects the meeting point for the avatars in av_array from what the map knows, if anything it
+ * depends on changed and one is due, and sets it as the map's target if it changed. Returns true if
+ * the target moved.
+ */
+bool rendezvous_update(rendezvous_t *rv, map_t *mp, avatar_t **av_array, int num_av);
+
+/**************** rendezvous_getElections ****************/
+/* Returns the number of times the meeting point has moved
+ */
+int rendezvous_getElections(rendezvous_t *rv);
+
+/**************** rendezvous_getPolls ****************/
+/* Returns the number of times the searches behind an election were run
+ */
+int rendezvous_getPolls(rendezvous_t *rv);
+
+#endif // __RENDEZVOUS_H
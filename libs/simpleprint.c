@@ -48,6 +48,10 @@ static void print_map_border(int WIDTH);
 void print_map(int HEIGHT, int WIDTH, avatar_t **av_array, int num_av, map_t *map)
 {
   
+  // Index the avatars by cell once, so each cell takes one lookup rather than a scan of the avatars
+  occupancy_t *occupancy = occupancy_new(WIDTH, HEIGHT, num_av);
+  occupancy_sync(occupancy, av_array);
+
   // Print the column header and the top map border
   print_column_header(WIDTH);
   print_map_border(WIDTH);
@@ -65,7 +69,7 @@ void print_map(int HEIGHT, int WIDTH, avatar_t **av_array, int num_av, map_t *ma
       int avatarID;
 
       // If found, print the lowest numbered-avatar into the cell
-      if((avatarID = avatar_array_find_avatar(av_array, num_av, i, j)) >= 0){
+      if((avatarID = occupancy_find_avatar(occupancy, i, j)) >= 0){
         printf(" %d ", avatarID); 
       } else {
         // If no avatar is present, print blank space
@@ -107,6 +111,8 @@ void print_map(int HEIGHT, int WIDTH, avatar_t **av_array, int num_av, map_t *ma
   
   // Print the bottom border of the map
   print_map_border(WIDTH);
+
+  occupancy_delete(occupancy);
 }
 
 /**************** static print_column_header ****************/
@@ -0,0 +1,237 @@
+/* ========================================================================== */
+/* File: speculate.c
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Andrw Yang, Maria Roodnitsky, Siddharth Agrawal, Alexander Hirsch
+ * Component name:  speculate
+ *
+ * Date Created:    March 12, 2020
+ *
+ * Description:     This file implements the speculate module, which holds the moves an
+ *                  avatar decided ahead of its turn (see speculate.h).
+ *
+ *                  Each outcome has its own map, avatar array and convoy, allocated once
+ *                  for the whole game; loading and taking an outcome are plain copies,
+ *                  so no memory is allocated per turn.
+ *
+ */
+/* ========================================================================== */
+
+// Import C Standard libraries
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Import project-specific libraries
+#include "amazing.h"
+#include "AMlib_avatar.h"
+#include "map.h"
+#include "convoy.h"
+#include "rendezvous.h"
+#include "speculate.h"
+
+/**************** speculation struct ****************/
+typedef struct speculation {
+    int num_avatars;
+    speculate_key_t key;                                // What the current speculation assumes
+    bool active;                                        // Whether a speculation is begun and not yet taken
+    map_t *map[SPECULATE_NUM_OUTCOMES];                 // Copies of the shared structures, one per outcome
+    avatar_t **av_array[SPECULATE_NUM_OUTCOMES];
+    occupancy_t *occupancy[SPECULATE_NUM_OUTCOMES];     // Where the avatars of each copy of the avatar array are
+    convoy_t *convoy[SPECULATE_NUM_OUTCOMES];
+    rendezvous_t *rendezvous[SPECULATE_NUM_OUTCOMES];   // What each copy knows of the last election, and its scratch
+    bool decided[SPECULATE_NUM_OUTCOMES];               // Whether a move was decided for each outcome
+    uint32_t move[SPECULATE_NUM_OUTCOMES];
+    int move_code[SPECULATE_NUM_OUTCOMES];
+    int begun;                                          // Number of speculations begun
+    int taken;                                          // Number of speculations taken
+} speculation_t;
+
+/**************** local functions ****************/
+static bool same_key(speculate_key_t a, speculate_key_t b);
+static void copy_positions(avatar_t **dst, avatar_t **src, int num_avatars);
+
+/**************** speculation_new ****************/
+/* Allocates a speculation and the copies of the shared structures for every outcome
+ * Memory: caller is responsible for calling speculation_delete
+ */
+speculation_t *speculation_new(int num_avatars, int mazeWidth, int mazeHeight)
+{
+    speculation_t *sp = calloc(1, sizeof(speculation_t));
+    if (sp == NULL) {
+        return NULL;
+    }
+    sp->num_avatars = num_avatars;
+    bool allocated = true;
+    for (int outcome = 0; outcome < SPECULATE_NUM_OUTCOMES; outcome++) {
+        sp->map[outcome] = map_new(mazeWidth, mazeHeight);
+        sp->av_array[outcome] = avatar_array_new(num_avatars);
+        sp->occupancy[outcome] = occupancy_new(mazeWidth, mazeHeight, num_avatars);
+        sp->convoy[outcome] = convoy_new(num_avatars, mazeWidth, mazeHeight);
+        sp->rendezvous[outcome] = rendezvous_new(mazeWidth, mazeHeight);
+        if (sp->map[outcome] == NULL || sp->av_array[outcome] == NULL || sp->convoy[outcome] == NULL
+            || sp->rendezvous[outcome] == NULL) {
+            allocated = false;
+            continue;
+        }
+        for (int i = 0; i < num_avatars; i++) {
+            avatar_array_add(sp->av_array[outcome], avatar_new(i));
+        }
+    }
+    if (!allocated) {
+        speculation_delete(sp);
+        return NULL;
+    }
+    return sp;
+}
+
+/**************** speculation_delete ****************/
+/* Frees the speculation and its copies
+ */
+void speculation_delete(speculation_t *sp)
+{
+    if (sp == NULL) {
+        return;
+    }
+    for (int outcome = 0; outcome < SPECULATE_NUM_OUTCOMES; outcome++) {
+        if (sp->map[outcome] != NULL) {
+            map_delete(sp->map[outcome]);
+        }
+        if (sp->av_array[outcome] != NULL) {
+            avatar_array_delete(sp->av_array[outcome], sp->num_avatars);
+        }
+        if (sp->occupancy[outcome] != NULL) {
+            occupancy_delete(sp->occupancy[outcome]);
+        }
+        convoy_delete(sp->convoy[outcome]);
+        rendezvous_delete(sp->rendezvous[outcome]);
+    }
+    free(sp);
+}
+
+/**************** speculation_begin ****************/
+/* Records the key, and forgets the moves decided for the last one
+ */
+void speculation_begin(speculation_t *sp, speculate_key_t key)
+{
+    sp->key = key;
+    sp->active = true;
+    for (int outcome = 0; outcome < SPECULATE_NUM_OUTCOMES; outcome++) {
+        sp->decided[outcome] = false;
+    }
+    sp->begun++;
+}
+
+/**************** speculation_load ****************/
+/* Copies the shared structures into the copies for one outcome
+ * Memory: the first load of each outcome allocates its map's inference arrays, see map_copy
+ */
+bool speculation_load(speculation_t *sp, speculate_outcome_t outcome, map_t *mp, avatar_t **av_array, convoy_t *cv,
+                      rendezvous_t *rv)
+{
+    if (!map_copy(sp->map[outcome], mp)) {
+        return false;
+    }
+    copy_positions(sp->av_array[outcome], av_array, sp->num_avatars);
+    occupancy_sync(sp->occupancy[outcome], sp->av_array[outcome]);
+    convoy_copy(sp->convoy[outcome], cv);
+    rendezvous_copy(sp->rendezvous[outcome], rv);
+    return true;
+}
+
+/**************** speculation getters ****************/
+map_t *speculation_getMap(speculation_t *sp, speculate_outcome_t outcome)
+{
+    return sp->map[outcome];
+}
+
+avatar_t **speculation_getAvatars(speculation_t *sp, speculate_outcome_t outcome)
+{
+    return sp->av_array[outcome];
+}
+
+occupancy_t *speculation_getOccupancy(speculation_t *sp, speculate_outcome_t outcome)
+{
+    return sp->occupancy[outcome];
+}
+
+convoy_t *speculation_getConvoy(speculation_t *sp, speculate_outcome_t outcome)
+{
+    return sp->convoy[outcome];
+}
+
+rendezvous_t *speculation_getRendezvous(speculation_t *sp, speculate_outcome_t outcome)
+{
+    return sp->rendezvous[outcome];
+}
+
+/**************** speculation_setMove ****************/
+void speculation_setMove(speculation_t *sp, speculate_outcome_t outcome, uint32_t move, int move_code)
+{
+    sp->move[outcome] = move;
+    sp->move_code[outcome] = move_code;
+    sp->decided[outcome] = true;
+}
+
+/**************** speculation_take ****************/
+/* Checks the speculation against the turn, and on a match hands over the decided outcome
+ * Memory: does not allocate memory
+ */
+bool speculation_take(speculation_t *sp, speculate_key_t key, speculate_outcome_t outcome,
+                      map_t *mp, avatar_t **av_array, occupancy_t *occ, convoy_t *cv, rendezvous_t *rv,
+                      uint32_t *move, int *move_code)
+{
+    if (!sp->active || !same_key(sp->key, key) || !sp->decided[outcome]) {
+        return false;
+    }
+    if (!map_copy(mp, sp->map[outcome])) {
+        return false;
+    }
+    copy_positions(av_array, sp->av_array[outcome], sp->num_avatars);
+    occupancy_sync(occ, av_array);
+    convoy_copy(cv, sp->convoy[outcome]);
+    rendezvous_copy(rv, sp->rendezvous[outcome]);
+    *move = sp->move[outcome];
+    *move_code = sp->move_code[outcome];
+    sp->active = false;
+    sp->taken++;
+    return true;
+}
+
+/**************** speculation counters ****************/
+int speculation_getTaken(speculation_t *sp)
+{
+    return sp->taken;
+}
+
+int speculation_getBegun(speculation_t *sp)
+{
+    return sp->begun;
+}
+
+/**************** same_key ****************/
+/* Returns true if two keys assume the same turn and the same move in flight
+ */
+static bool same_key(speculate_key_t a, speculate_key_t b)
+{
+    return a.avatar_id == b.avatar_id && a.mover_id == b.mover_id &&
+           a.initial_x == b.initial_x && a.initial_y == b.initial_y &&
+           a.attempted_x == b.attempted_x && a.attempted_y == b.attempted_y;
+}
+
+/**************** copy_positions ****************/
+/* Copies the position of every avatar placed in src onto the avatar with the same ID in dst
+ */
+static void copy_positions(avatar_t **dst, avatar_t **src, int num_avatars)
+{
+    for (int i = 0; i < num_avatars; i++) {
+        if (src[i] == NULL || dst[i] == NULL) {
+            continue;
+        }
+        position_setX(avatar_getPosition(dst[i]), avatar_getX(src[i]));
+        position_setY(avatar_getPosition(dst[i]), avatar_getY(src[i]));
+    }
+}
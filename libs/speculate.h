@@ -0,0 +1,118 @@
+/* ========================================================================== */
+/* File: speculate.h
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Andrw Yang, Maria Roodnitsky, Siddharth Agrawal, Alexander Hirsch
+ * Component name:  speculate
+ *
+ * Date Created:    March 12, 2020
+ *
+ * Description:     This header file provides the interface with the speculate module. The
+ *                  speculate module lets an avatar decide its next move before its turn.
+ *
+ *                  Turns go round the avatars in order, so while one avatar's move is in
+ *                  flight, the avatar after it is only waiting. The in-flight move has
+ *                  just two outcomes: the avatar gets there, or it hits a wall (the null
+ *                  move has one, and trap-filling follows from the outcome). The waiting
+ *                  avatar applies each outcome to a private copy of the shared map, avatar
+ *                  array (and its occupancy), convoy and rendezvous, and decides its move on that copy. On its turn it only
+ *                  looks up the outcome the server reports, copies that outcome's state
+ *                  into the shared structures, and sends the move it already has.
+ *
+ *                  A speculation is keyed by the avatar it was made for and the in-flight
+ *                  move it assumed; any other turn finds no speculation, and is decided
+ *                  as usual. One speculation is shared by all avatars, and, like the map,
+ *                  is only used with the shared structures locked.
+ *
+ */
+/* ========================================================================== */
+#ifndef __SPECULATE_H
+#define __SPECULATE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "AMlib_avatar.h"
+#include "map.h"
+#include "convoy.h"
+#include "rendezvous.h"
+
+/**************** global types ****************/
+typedef struct speculation speculation_t;
+
+// The outcomes of the in-flight move
+typedef enum speculate_outcome {
+    SPECULATE_MOVED = 0,    // The avatar reached the cell it asked for (or asked to stay, and did)
+    SPECULATE_BLOCKED = 1,  // The avatar hit a wall, and stayed where it was
+    SPECULATE_NUM_OUTCOMES = 2
+} speculate_outcome_t;
+
+// What a speculation assumes: whose turn it is for, and the move in flight before it
+typedef struct speculate_key {
+    int avatar_id;      // The avatar the moves are decided for
+    int mover_id;       // The avatar whose move is in flight
+    int initial_x;      // Where the mover was when it asked to move
+    int initial_y;
+    int attempted_x;    // The cell it asked to move into
+    int attempted_y;
+} speculate_key_t;
+
+/**************** functions ****************/
+
+/**************** speculation_new ****************/
+/* Allocates a speculation for num_avatars avatars on a mazeWidth x mazeHeight map, with a copy of
+ * the shared structures for each outcome. Returns NULL if memory could not be allocated.
+ * Memory: caller is responsible for calling speculation_delete
+ */
+speculation_t *speculation_new(int num_avatars, int mazeWidth, int mazeHeight);
+
+/**************** speculation_delete ****************/
+/* Frees the memory associated with the speculation
+ */
+void speculation_delete(speculation_t *sp);
+
+/**************** speculation_begin ****************/
+/* Starts a speculation for key, dropping the moves of any earlier one
+ */
+void speculation_begin(speculation_t *sp, speculate_key_t key);
+
+/**************** speculation_load ****************/
+/* Copies the shared map, the positions in av_array, the convoy and what the rendezvous rv knows of
+ * its last election into the copies for outcome. The caller then applies the outcome to them,
+ * decides on them, and records the move with speculation_setMove.
+ * Returns false, loading nothing, if the map copy could not be given the shared map's inference.
+ */
+bool speculation_load(speculation_t *sp, speculate_outcome_t outcome, map_t *mp, avatar_t **av_array, convoy_t *cv,
+                      rendezvous_t *rv);
+
+/**************** speculation getters ****************/
+/* The copies for an outcome, and the rendezvous to elect the meeting point on them with
+ */
+map_t *speculation_getMap(speculation_t *sp, speculate_outcome_t outcome);
+avatar_t **speculation_getAvatars(speculation_t *sp, speculate_outcome_t outcome);
+occupancy_t *speculation_getOccupancy(speculation_t *sp, speculate_outcome_t outcome);
+convoy_t *speculation_getConvoy(speculation_t *sp, speculate_outcome_t outcome);
+rendezvous_t *speculation_getRendezvous(speculation_t *sp, speculate_outcome_t outcome);
+
+/**************** speculation_setMove ****************/
+/* Records the move decided for outcome, and the code describing the outcome for the log
+ */
+void speculation_setMove(speculation_t *sp, speculate_outcome_t outcome, uint32_t move, int move_code);
+
+/**************** speculation_take ****************/
+/* If the speculation was made for key, and decided a move for outcome, copies that outcome's map,
+ * positions, convoy and rendezvous into mp, av_array, cv and rv, places the avatars in occ, the occupancy kept
+ * alongside av_array, where they now are, sets *move and *move_code, and returns true.
+ * Otherwise returns false, changing nothing. A speculation is taken at most once.
+ */
+bool speculation_take(speculation_t *sp, speculate_key_t key, speculate_outcome_t outcome,
+                      map_t *mp, avatar_t **av_array, occupancy_t *occ, convoy_t *cv, rendezvous_t *rv,
+                      uint32_t *move, int *move_code);
+
+/**************** speculation counters ****************/
+/* Return the number of turns decided ahead and taken, and the number of speculations begun
+ */
+int speculation_getTaken(speculation_t *sp);
+int speculation_getBegun(speculation_t *sp);
+
+#endif // __SPECULATE_H
@@ -0,0 +1,471 @@
+/* ========================================================================== */
+/* File: strategy.c
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Andrw Yang, Maria Roodnitsky, Siddharth Agrawal, Alexander Hirsch
+ * Component name:  strategy
+ *
+ * Date Created:    March 11, 2020
+ *
+ * Description:     This file implements the strategy module: the move strategies
+ *                  available to the avatars, and the table they are looked up in.
+ *
+ *                  rhr:      the right hand rule. Each avatar follows the wall on its
+ *                            right, turning by its heading (the direction of its last
+ *                            successful move) and the walls around it.
+ *                  distance: each avatar steps along the map's distance field, the
+ *                            shortest path to the meeting point over edges not known
+ *                            to be walls. Falls back to the right hand rule if the map
+ *                            has no path.
+ *
+ *                  frontier: each avatar heads, along open edges only, for the unknown
+ *                            edge which gives it the shortest optimistic path to the
+ *                            meeting point, passing over edges a teammate is already
+ *                            headed for, so that the avatars explore different branches.
+ *
+ *                  rhr and distance keep only a heading per avatar, and move avatars which
+ *                  have met as a convoy. frontier also keeps the frontier_claims table
+ *                  below, shared by all of its avatars; it spreads avatars which have met
+ *                  over nearby edges on purpose, so it does not use the convoy.
+ *
+ *                  rhr and frontier let the pairing module walk avatars with a known path
+ *                  between them together. distance does not: the meeting point it heads for
+ *                  is already elected from every avatar's position, and pulling a pair
+ *                  back along the corridors it came by costs more than it saves.
+ *
+ *                  rhr and distance decide from the map and the heading alone, so their
+ *                  moves may be decided ahead of the turn. frontier records a claim each
+ *                  time it decides, so it always decides on its turn.
+ *
+ */
+/* ========================================================================== */
+
+// Import C Standard libraries
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <limits.h>
+
+// Import project-specific libraries
+#include "amazing.h"
+#include "AMlib_avatar.h"
+#include "map.h"
+#include "AMClient.h"
+#include "strategy.h"
+
+/**************** local types ****************/
+
+// Per-avatar state of the rhr and distance strategies
+typedef struct heading_state {
+    int heading;        // Direction of the avatar's last successful move, as defined in amazing.h
+} heading_state_t;
+
+// Per-avatar state of the frontier strategy
+typedef struct frontier_state {
+    heading_state_t heading;    // For the right hand rule, when there is nothing to plan for
+    int avatar_id;
+    int width;                  // Maze dimensions, for cell numbering (cell = y * width + x)
+    int height;
+    int *parent;                // Search scratch: the cell each cell was reached from
+    int *depth;                 // Search scratch: the number of open edges from the avatar
+    int *queue;                 // Search scratch: cells in the order they were reached
+    uint32_t *seen;             // Search scratch: the search in which each cell was reached
+    uint32_t search;            // The number of the current search
+} frontier_state_t;
+
+// An unknown edge an avatar of the frontier strategy is headed for, by the cell on its west
+// or north side and the direction out of that cell (M_EAST or M_SOUTH); cell is -1 if none
+typedef struct frontier_claim {
+    int cell;
+    int direction;
+} frontier_claim_t;
+
+/**************** local functions ****************/
+static void *heading_init(map_t *map, int avatar_id, int num_avatars);
+static void heading_on_observation(void *state, map_t *map, strategy_observation_t observation);
+static void heading_teardown(void *state);
+static uint32_t rhr_choose_move(void *state, map_t *map, avatar_t **av_array, int num_avatars, int avatar_id, int x, int y);
+static uint32_t distance_choose_move(void *state, map_t *map, avatar_t **av_array, int num_avatars, int avatar_id, int x, int y);
+static void *frontier_init(map_t *map, int avatar_id, int num_avatars);
+static void frontier_on_observation(void *state, map_t *map, strategy_observation_t observation);
+static uint32_t frontier_choose_move(void *state, map_t *map, avatar_t **av_array, int num_avatars, int avatar_id, int x, int y);
+static void frontier_teardown(void *state);
+static void frontier_claim(int avatar_id, int width, int cell, int direction);
+static bool frontier_claimed(int avatar_id, int num_avatars, int width, int cell, int direction);
+
+/**************** strategies ****************/
+static const strategy_t strategies[] = {
+    {"distance", "step along the shortest known path to the meeting point (default)", true, false, true,
+     heading_init, heading_on_observation, distance_choose_move, heading_teardown},
+    {"rhr", "follow the wall on the right hand", true, true, true,
+     heading_init, heading_on_observation, rhr_choose_move, heading_teardown},
+    {"frontier", "explore the unknown edges nearest the meeting point, spread over the avatars", false, true, false,
+     frontier_init, frontier_on_observation, frontier_choose_move, frontier_teardown},
+};
+static const int num_strategies = sizeof(strategies) / sizeof(strategies[0]);
+
+/**************** rhr_table ****************/
+/* Right-hand-rule decisions, indexed by [direction of last successful move][wall mask of the
+ * current cell]. For each heading, the preference order is: turn right, go ahead, turn left,
+ * and otherwise turn back. Each entry is the first preferred direction whose bit is not set
+ * in the wall mask (bits are MAP_WALL_WEST, MAP_WALL_NORTH, MAP_WALL_SOUTH, MAP_WALL_EAST).
+ */
+static const uint32_t rhr_table[M_NUM_DIRECTIONS][16] = {
+    // Last move west: north, west, south, else east
+    [M_WEST]  = {M_NORTH, M_NORTH, M_WEST, M_SOUTH, M_NORTH, M_NORTH, M_WEST, M_EAST,
+                 M_NORTH, M_NORTH, M_WEST, M_SOUTH, M_NORTH, M_NORTH, M_WEST, M_EAST},
+    // Last move north: east, north, west, else south
+    [M_NORTH] = {M_EAST, M_EAST, M_EAST, M_EAST, M_EAST, M_EAST, M_EAST, M_EAST,
+                 M_NORTH, M_NORTH, M_WEST, M_SOUTH, M_NORTH, M_NORTH, M_WEST, M_SOUTH},
+    // Last move south: west, south, east, else north
+    [M_SOUTH] = {M_WEST, M_SOUTH, M_WEST, M_SOUTH, M_WEST, M_EAST, M_WEST, M_EAST,
+                 M_WEST, M_SOUTH, M_WEST, M_SOUTH, M_WEST, M_NORTH, M_WEST, M_NORTH},
+    // Last move east: south, east, north, else west
+    [M_EAST]  = {M_SOUTH, M_SOUTH, M_SOUTH, M_SOUTH, M_EAST, M_EAST, M_EAST, M_EAST,
+                 M_SOUTH, M_SOUTH, M_SOUTH, M_SOUTH, M_NORTH, M_NORTH, M_WEST, M_WEST},
+};
+
+// Cell offsets of the directions, as defined in amazing.h
+static const int direction_dx[M_NUM_DIRECTIONS] = {[M_WEST] = -1, [M_NORTH] = 0, [M_SOUTH] = 0, [M_EAST] = 1};
+static const int direction_dy[M_NUM_DIRECTIONS] = {[M_WEST] = 0, [M_NORTH] = -1, [M_SOUTH] = 1, [M_EAST] = 0};
+
+// Moves added to the score of an edge a teammate is headed for. Large enough that an avatar
+// takes a different edge when one is nearly as good, small enough that it does not walk away
+// from the only promising edge: skipping claimed edges outright cost more moves than it saved.
+static const int FRONTIER_CLAIM_PENALTY = 4;
+
+/**************** frontier_claims ****************/
+/* The edge each avatar of the frontier strategy is headed for, indexed by avatar ID. Shared by
+ * all the avatars of the strategy, and only read or written with the shared structures locked
+ * (see strategy.h). An avatar replaces its claim on every turn, so a claim never outlives the
+ * plan that made it.
+ */
+static frontier_claim_t frontier_claims[AM_MAX_AVATAR];
+
+/**************** strategy_find ****************/
+/* Returns the strategy with the given name, or NULL if there is none
+ */
+const strategy_t *strategy_find(const char *name)
+{
+    for (int i = 0; i < num_strategies; i++) {
+        if (strcmp(strategies[i].name, name) == 0) {
+            return &strategies[i];
+        }
+    }
+    return NULL;
+}
+
+/**************** strategy_default ****************/
+/* Returns the strategy used when none is selected: the first one in the table
+ */
+const strategy_t *strategy_default(void)
+{
+    return &strategies[0];
+}
+
+/**************** strategy_print_all ****************/
+/* Prints the name and description of every strategy to fp, one per line
+ */
+void strategy_print_all(FILE *fp, const char *prefix)
+{
+    for (int i = 0; i < num_strategies; i++) {
+        fprintf(fp, "%s%-10s %s\n", prefix, strategies[i].name, strategies[i].description);
+    }
+}
+
+/**************** heading_init ****************/
+/* Allocates the heading of one avatar. Avatars start out facing east.
+ * Memory: the state is freed by heading_teardown
+ */
+static void *heading_init(map_t *map, int avatar_id, int num_avatars)
+{
+    heading_state_t *state = malloc(sizeof(heading_state_t));
+    if (state == NULL) {
+        fprintf(stderr, "heading_init failed to allocate memory.\n");
+        return NULL;
+    }
+    state->heading = M_EAST;
+    return state;
+}
+
+/**************** heading_on_observation ****************/
+/* If the avatar's last move succeeded, it now faces the direction it moved in
+ */
+static void heading_on_observation(void *state, map_t *map, strategy_observation_t observation)
+{
+    heading_state_t *hs = state;
+    if (!observation.moved) {
+        return;
+    }
+    if (observation.to_x > observation.from_x) {
+        hs->heading = M_EAST;
+    } else if (observation.to_x < observation.from_x) {
+        hs->heading = M_WEST;
+    } else if (observation.to_y < observation.from_y) {
+        hs->heading = M_NORTH;
+    } else if (observation.to_y > observation.from_y) {
+        hs->heading = M_SOUTH;
+    }
+}
+
+/**************** heading_teardown ****************/
+/* Frees the heading of one avatar
+ */
+static void heading_teardown(void *state)
+{
+    free(state);
+}
+
+/**************** rhr_choose_move ****************/
+/* Suggests next movement using right-hand method
+ * The decision itself is a lookup in rhr_table on the avatar's heading and the wall mask of
+ * the current cell. An avatar at the meeting point stays there with the null move.
+ */
+static uint32_t rhr_choose_move(void *state, map_t *map, avatar_t **av_array, int num_avatars, int avatar_id, int x, int y)
+{
+    heading_state_t *hs = state;
+
+    // Check if avatar is at meeting point
+    if (avatar_at_point(map, x, y)) {
+        return M_NULL_MOVE; // stays at the meeting point
+    }
+
+    // Look up the right hand rule's choice for this heading and the walls around the current cell
+    return rhr_table[hs->heading][map_wallMask(map, x, y)];
+}
+
+/**************** distance_choose_move ****************/
+/* Suggests next movement along the shortest known path to the meeting point
+ * The map keeps every cell's distance to the meeting point, treating unknown edges as open, so
+ * the move is a constant-time read of the step which lowers that distance. Walls found on the
+ * way are repaired into the distances by the map, and the next turn's step goes around them.
+ * If the map has no path (which a consistent map of a perfect maze never lacks), falls back to
+ * the right hand rule.
+ */
+static uint32_t distance_choose_move(void *state, map_t *map, avatar_t **av_array, int num_avatars, int avatar_id, int x, int y)
+{
+    // Check if avatar is at meeting point
+    if (avatar_at_point(map, x, y)) {
+        return M_NULL_MOVE; // stays at the meeting point
+    }
+
+    int step = map_nextStepXY(map, x, y);
+    if (step == M_NULL_MOVE) {
+        return rhr_choose_move(state, map, av_array, num_avatars, avatar_id, x, y);
+    }
+    return (uint32_t)step;
+}
+
+/**************** frontier_init ****************/
+/* Allocates the state of one avatar of the frontier strategy, with search scratch sized for the
+ * map, and clears its claim.
+ * Memory: the state is freed by frontier_teardown
+ */
+static void *frontier_init(map_t *map, int avatar_id, int num_avatars)
+{
+    frontier_state_t *state = malloc(sizeof(frontier_state_t));
+    if (state == NULL) {
+        fprintf(stderr, "frontier_init failed to allocate memory.\n");
+        return NULL;
+    }
+    state->heading.heading = M_EAST;
+    state->avatar_id = avatar_id;
+    state->width = map_getMazeWidth(map);
+    state->height = map_getMazeHeight(map);
+    int num_cells = state->width * state->height;
+    state->parent = malloc(num_cells * sizeof(int));
+    state->depth = malloc(num_cells * sizeof(int));
+    state->queue = malloc(num_cells * sizeof(int));
+    state->seen = calloc(num_cells, sizeof(uint32_t));
+    state->search = 0;
+    if (state->parent == NULL || state->depth == NULL || state->queue == NULL || state->seen == NULL) {
+        fprintf(stderr, "frontier_init failed to allocate memory.\n");
+        frontier_teardown(state);
+        return NULL;
+    }
+    frontier_claims[avatar_id].cell = -1;
+    return state;
+}
+
+/**************** frontier_on_observation ****************/
+/* Keeps the avatar's heading, for the right hand rule
+ */
+static void frontier_on_observation(void *state, map_t *map, strategy_observation_t observation)
+{
+    frontier_state_t *fs = state;
+    heading_on_observation(&fs->heading, map, observation);
+}
+
+/**************** frontier_choose_move ****************/
+/* Suggests next movement towards the most promising unexplored edge no teammate is headed for
+ * A breadth-first search from the avatar over open edges reaches every cell it is known to be
+ * able to walk to, and the number of moves to get there. Each unknown edge out of those cells
+ * is scored by the moves to reach it, plus one to cross it, plus the map's distance from its
+ * far side to the meeting point; the lowest score wins, ties going to the nearest edge. If the
+ * meeting point itself is reached over open edges, its score is just the moves to reach it.
+ * Edges claimed by teammates score FRONTIER_CLAIM_PENALTY more, so that avatars spread over the
+ * edges that are nearly as good rather than follow each other down one corridor. The search
+ * stops once no cell left can beat the best score.
+ * The avatar claims the winning edge and takes the first step of the open path to it, or
+ * crosses it if it is at its side already. If there is no edge to head for, falls back to the
+ * distance strategy.
+ */
+static uint32_t frontier_choose_move(void *state, map_t *map, avatar_t **av_array, int num_avatars, int avatar_id, int x, int y)
+{
+    frontier_state_t *fs = state;
+    int width = fs->width;
+    int start = y * width + x;
+    frontier_claims[avatar_id].cell = -1;
+
+    // Check if avatar is at meeting point
+    if (avatar_at_point(map, x, y)) {
+        return M_NULL_MOVE; // stays at the meeting point
+    }
+
+    // Start a new search; on wraparound of the search number, forget every earlier search
+    if (++fs->search == 0) {
+        memset(fs->seen, 0, width * fs->height * sizeof(uint32_t));
+        fs->search = 1;
+    }
+    int head = 0;
+    int tail = 0;
+    fs->queue[tail++] = start;
+    fs->seen[start] = fs->search;
+    fs->parent[start] = -1;
+    fs->depth[start] = 0;
+
+    int best_score = INT_MAX;
+    int best_cell = -1;
+    int best_direction = M_NULL_MOVE;   // M_NULL_MOVE if the best target is the meeting point
+    while (head < tail) {
+        int cell = fs->queue[head++];
+        int depth = fs->depth[cell];
+        if (depth >= best_score) {
+            break;  // Every score from here on is at least depth
+        }
+        int cx = cell % width;
+        int cy = cell / width;
+        if (map_distanceXY(map, cx, cy) == 0) {
+            best_score = depth;
+            best_cell = cell;
+            best_direction = M_NULL_MOVE;
+            break;
+        }
+
+        // Score the unknown edges out of this cell, and queue the cells behind its open ones
+        for (int direction = 0; direction < M_NUM_DIRECTIONS; direction++) {
+            int nx = cx + direction_dx[direction];
+            int ny = cy + direction_dy[direction];
+            if (!map_validXY(map, nx, ny)) {
+                continue;
+            }
+            int next = ny * width + nx;
+            if (map_isOpenXY(map, cx, cy, nx, ny)) {
+                if (fs->seen[next] != fs->search) {
+                    fs->seen[next] = fs->search;
+                    fs->parent[next] = cell;
+                    fs->depth[next] = depth + 1;
+                    fs->queue[tail++] = next;
+                }
+            } else if (map_isUnknownXY(map, cx, cy, nx, ny)) {
+                int remaining = map_distanceXY(map, nx, ny);
+                if (remaining < 0) {
+                    continue;   // Cut off from the meeting point
+                }
+                int score = depth + 1 + remaining;
+                if (frontier_claimed(avatar_id, num_avatars, width, cell, direction)) {
+                    score += FRONTIER_CLAIM_PENALTY;
+                }
+                if (score < best_score) {
+                    best_score = score;
+                    best_cell = cell;
+                    best_direction = direction;
+                }
+            }
+        }
+    }
+
+    // Nothing to head for: the map has no path
+    if (best_cell == -1) {
+        return distance_choose_move(&fs->heading, map, av_array, num_avatars, avatar_id, x, y);
+    }
+
+    // Claim the edge, and cross it if the avatar is next to it already
+    if (best_direction != M_NULL_MOVE) {
+        frontier_claim(avatar_id, width, best_cell, best_direction);
+        if (best_cell == start) {
+            return (uint32_t)best_direction;
+        }
+    }
+
+    // Otherwise walk back along the search to the first step out of the avatar's cell
+    int step = best_cell;
+    while (fs->parent[step] != start) {
+        step = fs->parent[step];
+    }
+    if (step == start + 1) {
+        return M_EAST;
+    } else if (step == start - 1) {
+        return M_WEST;
+    } else if (step < start) {
+        return M_NORTH;
+    }
+    return M_SOUTH;
+}
+
+/**************** frontier_teardown ****************/
+/* Frees the state of one avatar of the frontier strategy and drops its claim
+ */
+static void frontier_teardown(void *state)
+{
+    frontier_state_t *fs = state;
+    if (fs == NULL) {
+        return;
+    }
+    frontier_claims[fs->avatar_id].cell = -1;
+    free(fs->parent);
+    free(fs->depth);
+    free(fs->queue);
+    free(fs->seen);
+    free(fs);
+}
+
+/**************** frontier_claim ****************/
+/* Records that the avatar is headed for the edge out of cell in direction. The edge is stored
+ * from its west or north cell, so that both sides of it compare equal.
+ */
+static void frontier_claim(int avatar_id, int width, int cell, int direction)
+{
+    if (direction == M_WEST) {
+        cell -= 1;
+        direction = M_EAST;
+    } else if (direction == M_NORTH) {
+        cell -= width;
+        direction = M_SOUTH;
+    }
+    frontier_claims[avatar_id].cell = cell;
+    frontier_claims[avatar_id].direction = direction;
+}
+
+/**************** frontier_claimed ****************/
+/* Returns true if an avatar other than avatar_id is headed for the edge out of cell in direction
+ */
+static bool frontier_claimed(int avatar_id, int num_avatars, int width, int cell, int direction)
+{
+    if (direction == M_WEST) {
+        cell -= 1;
+        direction = M_EAST;
+    } else if (direction == M_NORTH) {
+        cell -= width;
+        direction = M_SOUTH;
+    }
+    for (int i = 0; i < num_avatars; i++) {
+        if (i != avatar_id && frontier_claims[i].cell == cell && frontier_claims[i].direction == direction) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,97 @@
+/* ========================================================================== */
+/* File: strategy.h
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Andrw Yang, Maria Roodnitsky, Siddharth Agrawal, Alexander Hirsch
+ * Component name:  strategy
+ *
+ * Date Created:    March 11, 2020
+ *
+ * Description:     This header file provides the interface with the strategy module.
+ *                  A strategy decides each avatar's next move. Every strategy is a
+ *                  table of four functions, which thread_avatar calls at fixed points
+ *                  of a turn:
+ *                    - init:           once per avatar, before its first turn; returns
+ *                                      the avatar's private state
+ *                    - on_observation: on each of the avatar's turns after its first,
+ *                                      with the outcome of its own previous move
+ *                    - choose_move:    on each of the avatar's turns, after the shared
+ *                                      map has been updated; returns the move to send
+ *                    - teardown:       once per avatar, when its thread exits
+ *                  All four are called with the shared data structures locked, so a
+ *                  strategy may read the map and the avatar array freely. Any state
+ *                  shared between the avatars of one strategy must be documented there.
+ *
+ *                  A strategy with convoy set only decides the moves of avatars leading
+ *                  a group; the convoy module moves the rest of the group after them.
+ *                  A strategy with pairing set does not decide the moves of avatars
+ *                  which the known map connects to another group; the pairing module
+ *                  walks them towards each other instead.
+ *                  A strategy with speculate set may have an avatar's move decided while
+ *                  the move before it is in flight, once for each outcome of that move,
+ *                  on copies of the shared structures (see speculate.h). Its choose_move
+ *                  must then only read the avatar's state, and its on_observation must
+ *                  leave the same state when repeated, without reading the map.
+ *
+ *                  Strategies are looked up by name with strategy_find, so AMStartup
+ *                  can select one on the command line.
+ *
+ */
+/* ========================================================================== */
+#ifndef __STRATEGY_H
+#define __STRATEGY_H
+
+// Import C Standard libraries
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Import project-specific libraries
+#include "amazing.h"
+#include "AMlib_avatar.h"
+#include "map.h"
+
+/**************** global types ****************/
+
+// The outcome of an avatar's own previous move, passed to on_observation
+typedef struct strategy_observation {
+    int from_x;         // Where the avatar was when it asked to move
+    int from_y;
+    int to_x;           // The cell it asked to move into
+    int to_y;
+    bool moved;         // Whether it got there
+} strategy_observation_t;
+
+// A move strategy: its name, and the functions thread_avatar calls (see above)
+typedef struct strategy {
+    const char *name;
+    const char *description;
+    bool convoy;        // Whether avatars which meet move on as a group (see convoy.h)
+    bool pairing;       // Whether avatars with a known path between them walk it to meet (see pairing.h)
+    bool speculate;     // Whether moves may be decided ahead of the turn (see speculate.h)
+    void *(*init)(map_t *map, int avatar_id, int num_avatars);
+    void (*on_observation)(void *state, map_t *map, strategy_observation_t observation);
+    uint32_t (*choose_move)(void *state, map_t *map, avatar_t **av_array, int num_avatars, int avatar_id, int x, int y);
+    void (*teardown)(void *state);
+} strategy_t;
+
+/**************** functions ****************/
+
+/**************** strategy_find ****************/
+/* Returns the strategy with the given name, or NULL if there is none
+ */
+const strategy_t *strategy_find(const char *name);
+
+/**************** strategy_default ****************/
+/* Returns the strategy used when none is selected
+ */
+const strategy_t *strategy_default(void);
+
+/**************** strategy_print_all ****************/
+/* Prints the name and description of every strategy to fp, one per line, each line
+ * starting with prefix
+ */
+void strategy_print_all(FILE *fp, const char *prefix);
+
+#endif // __STRATEGY_H
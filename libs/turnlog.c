@@ -0,0 +1,417 @@
+/* ========================================================================== */
+/* File: turnlog.c
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Andrw Yang, Maria Roodnitsky, Siddharth Agrawal, Alexander Hirsch
+ * Component name:  turnlog
+ *
+ * Date Created:    March 14, 2020
+ *
+ * Description:     This file implements the turnlog module, which writes the game's log
+ *                  in text or binary, and reads either back (see turnlog.h for both
+ *                  formats).
+ *
+ */
+/* ========================================================================== */
+
+// Import C Standard libraries
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <arpa/inet.h>
+
+// Import project-specific libraries
+#include "amazing.h"
+#include "turnlog.h"
+
+/**************** file-local global variables ****************/
+static const char binary_magic[4] = {'A', 'M', 'Z', 'B'};
+static const uint16_t binary_version = 1;
+
+#define RECORD_HEAD_SIZE 8                      // Bytes every binary record starts with
+#define HEADER_FIXED_SIZE 32                    // Bytes of the binary header before the user name
+
+/**************** local functions ****************/
+static long write_text_record(FILE *fp, const turn_record_t *record);
+static long write_binary_record(FILE *fp, int num_avatars, const turn_record_t *record);
+static bool read_text_record(FILE *fp, int num_avatars, turn_record_t *record, bool *truncated);
+static bool read_binary_record(FILE *fp, int num_avatars, turn_record_t *record, bool *truncated);
+static bool read_line(FILE *fp, char *line, int size);
+static void put16(uint8_t *buf, uint16_t value);
+static void put32(uint8_t *buf, uint32_t value);
+static uint16_t get16(const uint8_t *buf);
+static uint32_t get32(const uint8_t *buf);
+
+/**************** turnlog_write_header ****************/
+/* see turnlog.h for description */
+bool turnlog_write_header(FILE *fp, log_format_t format, const turnlog_header_t *header)
+{
+    if (format == LOG_FORMAT_TEXT) {
+        // The user name, maze port and time, the time on a line of its own from ctime
+        return fprintf(fp, "%s, %d, %s", header->username, header->mazePort, ctime(&header->start_time)) > 0;
+    }
+
+    size_t length = strlen(header->username);
+    if (length > UINT16_MAX) {
+        return false;
+    }
+    uint8_t buf[HEADER_FIXED_SIZE];
+    memcpy(buf, binary_magic, sizeof(binary_magic));
+    put16(buf + 4, binary_version);
+    put16(buf + 6, (uint16_t)header->num_avatars);
+    put16(buf + 8, (uint16_t)header->difficulty);
+    put16(buf + 10, (uint16_t)length);
+    put32(buf + 12, (uint32_t)header->mazePort);
+    put32(buf + 16, (uint32_t)header->mazeWidth);
+    put32(buf + 20, (uint32_t)header->mazeHeight);
+    uint64_t start_time = (uint64_t)(int64_t)header->start_time;
+    put32(buf + 24, (uint32_t)(start_time >> 32));
+    put32(buf + 28, (uint32_t)start_time);
+    return fwrite(buf, 1, sizeof(buf), fp) == sizeof(buf)
+        && fwrite(header->username, 1, length, fp) == length;
+}
+
+/**************** turnlog_write_record ****************/
+/* see turnlog.h for description */
+long turnlog_write_record(FILE *fp, log_format_t format, int num_avatars, const turn_record_t *record)
+{
+    if (format == LOG_FORMAT_TEXT) {
+        return write_text_record(fp, record);
+    }
+    return write_binary_record(fp, num_avatars, record);
+}
+
+/**************** turnlog_read_header ****************/
+/* see turnlog.h for description */
+bool turnlog_read_header(FILE *fp, turnlog_header_t *header, char *username, size_t size)
+{
+    uint8_t buf[HEADER_FIXED_SIZE];
+    if (fread(buf, 1, sizeof(buf), fp) != sizeof(buf)
+        || memcmp(buf, binary_magic, sizeof(binary_magic)) != 0
+        || get16(buf + 4) != binary_version) {
+        return false;
+    }
+    header->num_avatars = get16(buf + 6);
+    header->difficulty = get16(buf + 8);
+    size_t length = get16(buf + 10);
+    header->mazePort = (int)get32(buf + 12);
+    header->mazeWidth = (int)get32(buf + 16);
+    header->mazeHeight = (int)get32(buf + 20);
+    uint64_t start_time = ((uint64_t)get32(buf + 24) << 32) | get32(buf + 28);
+    header->start_time = (time_t)(int64_t)start_time;
+    if (header->num_avatars > AM_MAX_AVATAR || length >= size
+        || fread(username, 1, length, fp) != length) {
+        return false;
+    }
+    username[length] = '\0';
+    header->username = username;
+    return true;
+}
+
+/**************** turnlog_read_record ****************/
+/* see turnlog.h for description */
+bool turnlog_read_record(FILE *fp, log_format_t format, int num_avatars, turn_record_t *record, bool *truncated)
+{
+    if (format == LOG_FORMAT_TEXT) {
+        return read_text_record(fp, num_avatars, record, truncated);
+    }
+    return read_binary_record(fp, num_avatars, record, truncated);
+}
+
+/**************** read_binary_record ****************/
+/* Reads the next record from fp in the binary format
+ */
+static bool read_binary_record(FILE *fp, int num_avatars, turn_record_t *record, bool *truncated)
+{
+    *truncated = false;
+    uint8_t buf[RECORD_HEAD_SIZE + 4 * AM_MAX_AVATAR];
+    size_t got = fread(buf, 1, RECORD_HEAD_SIZE, fp);
+    if (got == 0) {
+        return false;
+    }
+    if (got != RECORD_HEAD_SIZE) {
+        *truncated = true;
+        return false;
+    }
+
+    // The head every record starts with
+    memset(record, 0, sizeof(turn_record_t));
+    record->kind = buf[0];
+    record->avatar_id = buf[1];
+    record->outcome = (buf[2] == UINT8_MAX) ? RECORD_OUTCOME_NONE : buf[2];
+    record->move = buf[3];
+    uint32_t value = get32(buf + 4);
+
+    // The rest, by kind
+    size_t rest;
+    if (record->kind == RECORD_TURN) {
+        rest = 4 * num_avatars;
+    } else if (record->kind == RECORD_SOLVED) {
+        rest = 12;
+    } else if (record->kind == RECORD_ERROR) {
+        rest = 0;
+    } else {
+        *truncated = true;
+        return false;
+    }
+    if (fread(buf + RECORD_HEAD_SIZE, 1, rest, fp) != rest) {
+        *truncated = true;
+        return false;
+    }
+
+    if (record->kind == RECORD_TURN) {
+        record->iteration = (int)value;
+        record->num_avatars = num_avatars;
+        for (int i = 0; i < num_avatars; i++) {
+            record->positions[i].x = get16(buf + RECORD_HEAD_SIZE + 4 * i);
+            record->positions[i].y = get16(buf + RECORD_HEAD_SIZE + 4 * i + 2);
+        }
+    } else if (record->kind == RECORD_SOLVED) {
+        record->solved_hash = (int)value;
+        record->num_avatars = num_avatars;
+        record->solved_avatars = (int)get32(buf + RECORD_HEAD_SIZE);
+        record->solved_difficulty = (int)get32(buf + RECORD_HEAD_SIZE + 4);
+        record->solved_moves = (int)get32(buf + RECORD_HEAD_SIZE + 8);
+    } else {
+        record->message_type = value;
+    }
+    return true;
+}
+
+/**************** write_text_record ****************/
+/* Writes the record to fp in the format the avatars have always logged in. Returns the number of bytes
+ * written, or -1 if it could not be written
+ */
+static long write_text_record(FILE *fp, const turn_record_t *record)
+{
+    long written = 0;
+    if (record->kind == RECORD_ERROR) {
+        written += fprintf(fp, "\tThread #%d: Received error. Message type: %d \n", record->avatar_id, (int)record->message_type);
+        if (record->message_type == AM_SERVER_OUT_OF_MEM) {
+            written += fprintf(fp, "\tThread #%d: The error message type is AM_SERVER_OUT_OF_MEM \n", record->avatar_id);
+        }
+        if (record->message_type == AM_SERVER_TIMEOUT) {
+            written += fprintf(fp, "\tThread #%d: The error message type is AM_SERVER_TIMEOUT \n", record->avatar_id);
+        }
+        if (record->message_type == AM_TOO_MANY_MOVES) {
+            written += fprintf(fp, "\tThread #%d: The error message type is AM_TOO_MANY_MOVES \n", record->avatar_id);
+        }
+        if (record->message_type == AM_SERVER_DISK_QUOTA) {
+            written += fprintf(fp, "\tThread #%d: The error message type is AM_SERVER_DISK_QUOTA \n", record->avatar_id);
+        }
+        return ferror(fp) ? -1 : written;
+    }
+
+    if (record->kind == RECORD_SOLVED) {
+        written += fprintf(fp, "\n*** Received AM_MAZE_SOLVED ***\n");
+        written += fprintf(fp, "Message contents: Num avatars: %d; Difficulty level: %d; Num moves: %d; Hash: %d\n",
+                record->solved_avatars, record->solved_difficulty, record->solved_moves, record->solved_hash);
+        return ferror(fp) ? -1 : written;
+    }
+
+    // Log the iteration number and turn ID:
+    written += fprintf(fp, "\n\nIteration: %d. It is avatar #%d's turn. Current positions by avatar: \n", record->iteration, record->avatar_id);
+
+    // Log the current position of each avatar:
+    for (int avatar_idx = 0; avatar_idx < record->num_avatars; avatar_idx++) {
+        written += fprintf(fp, "\tAvatar ID: %d X: %d Y: %d \n", avatar_idx, (int)record->positions[avatar_idx].x, (int)record->positions[avatar_idx].y);
+    }
+
+    // If it is not the first turn, then log the results of the prior turn
+    if (record->iteration != 0) {
+        written += fprintf(fp, "\tThe result of the previous turn is: ");
+        if (record->outcome == RECORD_OUTCOME_WALL) {
+            written += fprintf(fp, "Wall found.");
+        } else if (record->outcome == RECORD_OUTCOME_PATH) {
+            written += fprintf(fp, "Move successful.");
+        } else if (record->outcome == RECORD_OUTCOME_PATH_FILL) {
+            written += fprintf(fp, "Move successful and wall filled behind.");
+        } else if (record->outcome == RECORD_OUTCOME_STAY) {
+            written += fprintf(fp, "Stayed at the meeting point.");
+        }
+    } else {
+        written += fprintf(fp, "\tFirst move, so no prior move to report.");
+    }
+
+    // Log the requested move
+    written += fprintf(fp, "\n\tAvatar #%d is now requesting to move ", record->avatar_id);
+    if (record->move == M_EAST) {
+        written += fprintf(fp, "east.\n");
+    } else if (record->move == M_SOUTH) {
+        written += fprintf(fp, "south.\n");
+    } else if (record->move == M_WEST) {
+        written += fprintf(fp, "west.\n");
+    } else if (record->move == M_NORTH) {
+        written += fprintf(fp, "north.\n");
+    } else {
+        written += fprintf(fp, "nowhere, staying at the meeting point.\n");
+    }
+    return ferror(fp) ? -1 : written;
+}
+
+/**************** write_binary_record ****************/
+/* Writes the record to fp in the binary format: the head, and what follows it for its kind. Returns the
+ * number of bytes written, or -1 if it could not be written
+ */
+static long write_binary_record(FILE *fp, int num_avatars, const turn_record_t *record)
+{
+    uint8_t buf[RECORD_HEAD_SIZE + 4 * AM_MAX_AVATAR];
+    buf[0] = (uint8_t)record->kind;
+    buf[1] = (uint8_t)record->avatar_id;
+    buf[2] = (record->outcome == RECORD_OUTCOME_NONE) ? UINT8_MAX : (uint8_t)record->outcome;
+    buf[3] = (uint8_t)record->move;
+
+    size_t size = RECORD_HEAD_SIZE;
+    if (record->kind == RECORD_TURN) {
+        put32(buf + 4, (uint32_t)record->iteration);
+        for (int i = 0; i < num_avatars; i++) {
+            put16(buf + size, (uint16_t)record->positions[i].x);
+            put16(buf + size + 2, (uint16_t)record->positions[i].y);
+            size += 4;
+        }
+    } else if (record->kind == RECORD_SOLVED) {
+        put32(buf + 4, (uint32_t)record->solved_hash);
+        put32(buf + size, (uint32_t)record->solved_avatars);
+        put32(buf + size + 4, (uint32_t)record->solved_difficulty);
+        put32(buf + size + 8, (uint32_t)record->solved_moves);
+        size += 12;
+    } else {
+        put32(buf + 4, record->message_type);
+    }
+    return (fwrite(buf, 1, size, fp) == size) ? (long)size : -1;
+}
+
+/**************** read_text_record ****************/
+/* Reads the next record from fp in the text format, the lines write_text_record writes: the blank lines
+ * before it, then its first line, which tells its kind, and the lines that kind has after it
+ */
+static bool read_text_record(FILE *fp, int num_avatars, turn_record_t *record, bool *truncated)
+{
+    *truncated = false;
+    memset(record, 0, sizeof(turn_record_t));
+    char line[200];
+    do {
+        if (!read_line(fp, line, sizeof(line))) {
+            return false;
+        }
+    } while (line[0] == '\n');
+
+    // A turn: its positions, the outcome of the move before it, and its move
+    int id;
+    int value;
+    if (sscanf(line, "Iteration: %d. It is avatar #%d's turn.", &record->iteration, &record->avatar_id) == 2) {
+        record->kind = RECORD_TURN;
+        record->num_avatars = num_avatars;
+        for (int i = 0; i < num_avatars; i++) {
+            int x;
+            int y;
+            if (!read_line(fp, line, sizeof(line))
+                || sscanf(line, "\tAvatar ID: %d X: %d Y: %d", &id, &x, &y) != 3 || id != i) {
+                *truncated = true;
+                return false;
+            }
+            record->positions[i].x = x;
+            record->positions[i].y = y;
+        }
+        if (!read_line(fp, line, sizeof(line))) {
+            *truncated = true;
+            return false;
+        }
+        record->outcome = RECORD_OUTCOME_NONE;
+        if (strstr(line, "Wall found.") != NULL) {
+            record->outcome = RECORD_OUTCOME_WALL;
+        } else if (strstr(line, "Move successful and wall filled behind.") != NULL) {
+            record->outcome = RECORD_OUTCOME_PATH_FILL;
+        } else if (strstr(line, "Move successful.") != NULL) {
+            record->outcome = RECORD_OUTCOME_PATH;
+        } else if (strstr(line, "Stayed at the meeting point.") != NULL) {
+            record->outcome = RECORD_OUTCOME_STAY;
+        }
+        if (!read_line(fp, line, sizeof(line)) || strstr(line, "is now requesting to move ") == NULL) {
+            *truncated = true;
+            return false;
+        }
+        const char *move = strstr(line, "to move ") + strlen("to move ");
+        if (strncmp(move, "east.", 5) == 0) {
+            record->move = M_EAST;
+        } else if (strncmp(move, "south.", 6) == 0) {
+            record->move = M_SOUTH;
+        } else if (strncmp(move, "west.", 5) == 0) {
+            record->move = M_WEST;
+        } else if (strncmp(move, "north.", 6) == 0) {
+            record->move = M_NORTH;
+        } else {
+            record->move = M_NULL_MOVE;
+        }
+        return true;
+    }
+
+    // The solved message, and its contents on the next line
+    if (strncmp(line, "*** Received AM_MAZE_SOLVED ***", 31) == 0) {
+        record->kind = RECORD_SOLVED;
+        record->num_avatars = num_avatars;
+        if (!read_line(fp, line, sizeof(line))
+            || sscanf(line, "Message contents: Num avatars: %d; Difficulty level: %d; Num moves: %d; Hash: %d",
+                      &record->solved_avatars, &record->solved_difficulty, &record->solved_moves,
+                      &record->solved_hash) != 4) {
+            *truncated = true;
+            return false;
+        }
+        return true;
+    }
+
+    // An error, and the line naming it, if it is one the avatars know
+    if (sscanf(line, "\tThread #%d: Received error. Message type: %d", &record->avatar_id, &value) == 2) {
+        record->kind = RECORD_ERROR;
+        record->message_type = (uint32_t)value;
+        long after = ftell(fp);
+        if (read_line(fp, line, sizeof(line)) && strstr(line, ": The error message type is ") == NULL) {
+            fseek(fp, after, SEEK_SET);
+        }
+        return true;
+    }
+
+    *truncated = true;
+    return false;
+}
+
+/**************** read_line ****************/
+/* Reads a line of fp, newline included, into line, of size size. Returns false at the end of the file
+ */
+static bool read_line(FILE *fp, char *line, int size)
+{
+    return fgets(line, size, fp) != NULL;
+}
+
+/**************** put16, put32, get16, get32 ****************/
+/* Store and load integers in network byte order, at any alignment
+ */
+static void put16(uint8_t *buf, uint16_t value)
+{
+    value = htons(value);
+    memcpy(buf, &value, sizeof(value));
+}
+
+static void put32(uint8_t *buf, uint32_t value)
+{
+    value = htonl(value);
+    memcpy(buf, &value, sizeof(value));
+}
+
+static uint16_t get16(const uint8_t *buf)
+{
+    uint16_t value;
+    memcpy(&value, buf, sizeof(value));
+    return ntohs(value);
+}
+
+static uint32_t get32(const uint8_t *buf)
+{
+    uint32_t value;
+    memcpy(&value, buf, sizeof(value));
+    return ntohl(value);
+}
@@ -0,0 +1,140 @@
+/* ========================================================================== */
+/* File: turnlog.h
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Andrw Yang, Maria Roodnitsky, Siddharth Agrawal, Alexander Hirsch
+ * Component name:  turnlog
+ *
+ * Date Created:    March 14, 2020
+ *
+ * Description:     This header file provides the interface with the turnlog module, which
+ *                  writes and reads the game's log. A log is a header, naming the game,
+ *                  followed by one record per turn, error or solved message. It is written
+ *                  in one of two formats:
+ *
+ *                  - text, the Amazing_[USER]_[NUMBER OF AVATARS]_[DIFFICULTY].log file
+ *                    read by people, and
+ *                  - binary, the same file ending in .bin, with fixed-width fields instead
+ *                    of prose, about a tenth of the size. AMLogText turns a binary log
+ *                    back into the text log, byte for byte.
+ *
+ *                  The binary format. Every integer is unsigned and in network byte
+ *                  order, like the server's messages. The header is
+ *
+ *                      4 bytes     "AMZB"
+ *                      2 bytes     format version, 1
+ *                      2 bytes     number of avatars, N
+ *                      2 bytes     difficulty
+ *                      2 bytes     length of the user name, L
+ *                      4 bytes     maze port
+ *                      4 bytes     maze width
+ *                      4 bytes     maze height
+ *                      8 bytes     start time, in seconds since the Epoch
+ *                      L bytes     user name, not terminated
+ *
+ *                  Each record starts with 8 bytes
+ *
+ *                      1 byte      kind (a record_kind_t)
+ *                      1 byte      avatar ID
+ *                      1 byte      outcome of the move before (a record_outcome_t; 255 if none)
+ *                      1 byte      move requested (a direction from amazing.h)
+ *                      4 bytes     TURN: iteration; ERROR: message type; SOLVED: hash
+ *
+ *                  followed, for a TURN, by N pairs of 2-byte X and Y positions, and for
+ *                  SOLVED by the 4-byte number of avatars, difficulty and number of moves
+ *                  from the message. An ERROR has nothing more. So with N avatars every
+ *                  turn record is 8 + 4N bytes long.
+ *
+ */
+/* ========================================================================== */
+#ifndef __TURNLOG_H
+#define __TURNLOG_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include "amazing.h"
+
+/**************** global types ****************/
+
+// The format a log is written in
+typedef enum log_format {
+    LOG_FORMAT_TEXT = 0,
+    LOG_FORMAT_BINARY = 1
+} log_format_t;
+
+// What a record is of
+typedef enum record_kind {
+    RECORD_TURN = 0,        // An avatar's turn
+    RECORD_SOLVED = 1,      // The AM_MAZE_SOLVED message
+    RECORD_ERROR = 2        // An error message received by an avatar
+} record_kind_t;
+
+// The outcome of the move before a turn, as logged
+typedef enum record_outcome {
+    RECORD_OUTCOME_NONE = -1,       // Not known
+    RECORD_OUTCOME_WALL = 1,        // The move hit a wall
+    RECORD_OUTCOME_PATH = 2,        // The move succeeded
+    RECORD_OUTCOME_PATH_FILL = 3,   // The move succeeded, and a trap was filled behind it
+    RECORD_OUTCOME_STAY = 4         // The avatar stayed where it was (at the meeting point)
+} record_outcome_t;
+
+// Everything the log says about a turn or message. Positions are in host byte order
+typedef struct turn_record {
+    record_kind_t kind;
+    int avatar_id;                      // TURN: the avatar whose turn it was. ERROR: the avatar which received it
+    int iteration;                      // TURN: the number of messages that avatar had read before this one
+    int num_avatars;                    // TURN and SOLVED: the number of avatars
+    XYPos positions[AM_MAX_AVATAR];     // TURN and SOLVED: where each avatar was
+    int outcome;                        // TURN: the outcome of the move before this turn (a record_outcome_t)
+    uint32_t move;                      // TURN: the move requested
+    uint32_t message_type;              // ERROR: the type of the error message
+    int solved_avatars;                 // SOLVED: the contents of the message
+    int solved_difficulty;
+    int solved_moves;
+    int solved_hash;
+    XYPos target;                       // The meeting point once the record was played; indexed, not logged
+} turn_record_t;
+
+// What the log's header says about the game
+typedef struct turnlog_header {
+    const char *username;
+    int mazePort;
+    int mazeWidth;
+    int mazeHeight;
+    int num_avatars;
+    int difficulty;
+    time_t start_time;
+} turnlog_header_t;
+
+/**************** functions ****************/
+
+/**************** turnlog_write_header ****************/
+/* Writes header to fp, in format. The text header is the user name, maze port and start time
+ * (in the local time zone) on one line. Returns false if it could not be written
+ */
+bool turnlog_write_header(FILE *fp, log_format_t format, const turnlog_header_t *header);
+
+/**************** turnlog_write_record ****************/
+/* Writes record to fp, in format, for a game of num_avatars avatars. Returns the number of bytes
+ * written, or -1 if it could not be written
+ */
+long turnlog_write_record(FILE *fp, log_format_t format, int num_avatars, const turn_record_t *record);
+
+/**************** turnlog_read_header ****************/
+/* Reads a binary header from fp into header, the user name into username, of size size.
+ * Returns false if fp does not start with a binary header this version reads
+ */
+bool turnlog_read_header(FILE *fp, turnlog_header_t *header, char *username, size_t size);
+
+/**************** turnlog_read_record ****************/
+/* Reads the next record from fp, a log in format, into record, for a game of num_avatars avatars.
+ * Reading starts at the current position of fp, which must be the start of a record (or, in text,
+ * of the blank lines before one); the text header is not read. Returns false at the end of the log,
+ * and, also setting *truncated, if a record is cut short or not one this module writes
+ */
+bool turnlog_read_record(FILE *fp, log_format_t format, int num_avatars, turn_record_t *record, bool *truncated);
+
+#endif // __TURNLOG_H
@@ -0,0 +1,96 @@
+/* ========================================================================== */
+/* File: convoytest.c
+ * *** Category: Testing Only ***
+ * *** Not part of compilation path for user-facing executable
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Maria Roodnitsky, Andrw Yang, Siddharth Agrawal, Alexander Hirsch,
+ * Component name:  convoytest.c
+ *
+ * Date Created:    March 11th, 2020
+ *
+ * This file is a test driver for the convoy module.
+ *
+ * Compilation:     mygcc convoytest.c ../libs/convoy.c ../libs/map.c ../libs/AMlib_avatar.c -o convoytest
+ * Usage:           ./convoytest
+ *
+ */
+/* ========================================================================== */
+
+// Include C Standard libraries
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+// Include project-specific libraries
+#include "../libs/amazing.h"
+#include "../libs/map.h"
+#include "../libs/AMlib_avatar.h"
+#include "../libs/convoy.h"
+
+// Places avatar av at (x, y)
+static void place(avatar_t *av, int x, int y)
+{
+    position_setX(avatar_getPosition(av), x);
+    position_setY(avatar_getPosition(av), y);
+}
+
+// Runs unit testing for the convoy module
+int main(const int argc, const char *argv[])
+{
+    // Three avatars in a 4 x 1 corridor: two together at the west end, one at the east end
+    map_t *corridor = map_new(4, 1);
+    convoy_t *cv = convoy_new(3, 4, 1);
+    avatar_t **avatars = avatar_array_new(3);
+    for (int i = 0; i < 3; i++) {
+        avatar_array_add(avatars, avatar_new(i));
+    }
+    place(avatars[0], 0, 0);
+    place(avatars[1], 0, 0);
+    place(avatars[2], 3, 0);
+
+    // Test that avatars on the same cell merge, and no others
+    if (convoy_update(cv, avatars, 3) == 2 && convoy_getGroup(cv, 1) == 0 && convoy_getGroupSize(cv, 0) == 2 &&
+        convoy_getGroupSize(cv, 2) == 1) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that the member at the head leads, and the other follows it over the open edge it took
+    uint32_t move = M_NULL_MOVE;
+    bool follows = convoy_follow(cv, corridor, avatars, 0, &move);
+    map_setOpenXY(corridor, 0, 0, 1, 0);
+    place(avatars[0], 1, 0);
+    if (!follows && convoy_follow(cv, corridor, avatars, 1, &move) && move == M_EAST && convoy_getLeader(cv, 1) == 0) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that a follower never steps across an edge which is not known to be open
+    place(avatars[0], 2, 0);
+    move = M_NULL_MOVE;
+    if (!convoy_follow(cv, corridor, avatars, 1, &move) && move == M_NULL_MOVE) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that groups merge when their members meet, keeping the leader on the meeting cell
+    place(avatars[0], 3, 0);
+    place(avatars[1], 2, 0);
+    if (convoy_update(cv, avatars, 3) == 1 && convoy_getGroupSize(cv, 2) == 3 && convoy_getLeader(cv, 1) == 0) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Clean up
+    avatar_array_delete(avatars, 3);
+    convoy_delete(cv);
+    map_delete(corridor);
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+/* ========================================================================== */
+/* File: deadendbench.c
+ * *** Category: Testing Only ***
+ * *** Not part of compilation path for user-facing executable
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Maria Roodnitsky, Andrw Yang, Siddharth Agrawal, Alexander Hirsch,
+ * Component name:  deadendbench.c
+ *
+ * Date Created:    March 11th, 2020
+ *
+ * This file benchmarks finding every dead end (cell walled on exactly three sides)
+ * of a map. It compares:
+ *  - 4x isWallXY: the four-call neighborhood check the wall-filler in thread_avatar
+ *                 used to make, run for every cell
+ *  - wallCount:   map_wallCount for every cell
+ *  - sweep:       map_findDeadEnds, the vectorized whole-map pass
+ * and checks that all three find the same cells.
+ *
+ * map_findDeadEnds picks the widest kernel the CPU supports. To time the narrower
+ * kernels, add -DMAP_NO_AVX2 (SSE2) or -DMAP_NO_SIMD (portable 64-bit) to the
+ * compilation line.
+ *
+ * Compilation:     mygcc -O2 deadendbench.c ../libs/map.c ../libs/AMlib_avatar.c -o deadendbench
+ * Usage:           ./deadendbench
+ *
+ */
+/* ========================================================================== */
+
+// Include C Standard libraries
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+// Include project-specific libraries
+#include "../libs/map.h"
+#include "../libs/AMlib_avatar.h"
+
+// Maze sizes timed, square; the server's largest maze is 100 x 100
+static const int SIZES[] = {10, 25, 50, 100, 250};
+
+// Returns the current monotonic time in nanoseconds
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Runs the dead-end search benchmark
+int main(const int argc, const char *argv[])
+{
+    printf("%-10s %12s %12s %12s %8s\n", "size", "4x isWallXY", "wallCount", "sweep", "found");
+    long checksum = 0;
+    srand(7);
+
+    for (int s = 0; s < (int)(sizeof(SIZES) / sizeof(SIZES[0])); s++) {
+        int W = SIZES[s];
+        int H = SIZES[s];
+        int scans = 20000000 / (W * H) + 1;
+
+        // Wall off about half of the edges, which leaves many cells with exactly three walls
+        map_t *mp = map_new(W, H);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                if (rand() % 2) {
+                    map_setWallXY(mp, x, y, x + 1, y);
+                }
+                if (rand() % 2) {
+                    map_setWallXY(mp, x, y, x, y + 1);
+                }
+            }
+        }
+
+        // The four-call check, for every cell
+        int found_calls = 0;
+        double start = now_ns();
+        for (int n = 0; n < scans; n++) {
+            found_calls = 0;
+            for (int y = 0; y < H; y++) {
+                for (int x = 0; x < W; x++) {
+                    int wall_count = 0;
+                    if (map_isWallXY(mp, x + 1, y, x, y)) {wall_count++;}
+                    if (map_isWallXY(mp, x, y + 1, x, y)) {wall_count++;}
+                    if (map_isWallXY(mp, x - 1, y, x, y)) {wall_count++;}
+                    if (map_isWallXY(mp, x, y - 1, x, y)) {wall_count++;}
+                    found_calls += (wall_count == 3);
+                }
+            }
+        }
+        double calls = (now_ns() - start) / scans / (W * H);
+
+        // map_wallCount, for every cell
+        int found_count = 0;
+        start = now_ns();
+        for (int n = 0; n < scans; n++) {
+            found_count = 0;
+            for (int y = 0; y < H; y++) {
+                for (int x = 0; x < W; x++) {
+                    found_count += (map_wallCount(mp, x, y) == 3);
+                }
+            }
+        }
+        double counted = (now_ns() - start) / scans / (W * H);
+
+        // The whole-map sweep
+        int found_sweep = 0;
+        const uint64_t *bitmap = NULL;
+        start = now_ns();
+        for (int n = 0; n < scans; n++) {
+            found_sweep = map_findDeadEnds(mp, &bitmap);
+            checksum += bitmap[0] & 1;
+        }
+        double swept = (now_ns() - start) / scans / (W * H);
+
+        // Check that the sweep marked exactly the cells the four-call check finds
+        bool same = (found_calls == found_count && found_calls == found_sweep);
+        for (int y = 0; y < H && same; y++) {
+            for (int x = 0; x < W; x++) {
+                int cell = y * W + x;
+                bool marked = (bitmap[cell / 64] >> (cell % 64)) & 1;
+                if (marked != (map_wallCount(mp, x, y) == 3)) {
+                    same = false;
+                }
+            }
+        }
+
+        char size[32];
+        snprintf(size, sizeof(size), "%dx%d", W, H);
+        printf("%-10s %9.3f ns %9.3f ns %9.3f ns %8d%s  (per cell)\n", size, calls, counted, swept, found_sweep,
+               same ? "" : "  MISMATCH");
+        checksum += found_calls + found_count;
+        map_delete(mp);
+    }
+
+    // Print the checksum so the compiler cannot discard the scans
+    printf("(checksum %ld)\n", checksum);
+    return 0;
+}
@@ -0,0 +1,163 @@
+/* ========================================================================== */
+/* File: logindextest.c
+ * *** Category: Testing Only ***
+ * *** Not part of compilation path for user-facing executable
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Maria Roodnitsky, Andrw Yang, Siddharth Agrawal, Alexander Hirsch,
+ * Component name:  logindextest.c
+ *
+ * Date Created:    March 15th, 2020
+ *
+ * This file is a test driver for the logindex module. It writes logindextest.log, with its
+ * index and checkpoints, and removes them once done.
+ *
+ * Compilation:     mygcc logindextest.c ../libs/logindex.c ../libs/turnlog.c ../libs/map.c ../libs/AMlib_avatar.c -o logindextest
+ * Usage:           ./logindextest
+ *
+ */
+/* ========================================================================== */
+
+// Include C Standard libraries
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Include project-specific libraries
+#include "../libs/amazing.h"
+#include "../libs/map.h"
+#include "../libs/turnlog.h"
+#include "../libs/logindex.h"
+
+#define NUM_RECORDS 6
+
+// Fills records with a game of two avatars: two turns, an error, two more turns and the solved message
+static void make_records(turn_record_t records[NUM_RECORDS])
+{
+    memset(records, 0, NUM_RECORDS * sizeof(turn_record_t));
+    for (int i = 0; i < NUM_RECORDS; i++) {
+        records[i].kind = RECORD_TURN;
+        records[i].num_avatars = 2;
+        records[i].avatar_id = i % 2;
+        records[i].iteration = (i < 2) ? i : i - 1;
+        records[i].outcome = RECORD_OUTCOME_PATH;
+        records[i].move = M_EAST;
+        records[i].positions[1].x = i;
+        records[i].target.x = 3;
+        records[i].target.y = i;
+    }
+    records[2].kind = RECORD_ERROR;
+    records[2].message_type = AM_SERVER_TIMEOUT;
+    records[5].kind = RECORD_SOLVED;
+    records[5].solved_moves = 4;
+}
+
+// Runs unit testing for the logindex module
+int main(const int argc, const char *argv[])
+{
+    const char *log_file_name = "logindextest.log";
+    turn_record_t records[NUM_RECORDS];
+    make_records(records);
+
+    // A map to checkpoint, once record 3 is submitted but before it is logged
+    map_t *map = map_new(4, 3);
+    map_setTargetXY(map, 3, 2);
+    map_setInference(map, true);
+    map_setWallXY(map, 0, 0, 1, 0);
+    map_setOpenXY(map, 1, 1, 1, 2);
+
+    // Write the log and its index, as the recorder does
+    FILE *log = fopen(log_file_name, "w");
+    logindex_t *ix = logindex_new(log_file_name, LOG_FORMAT_TEXT, 4, 3, 2);
+    long offset = fprintf(log, "header line\n");
+    for (int i = 0; i < NUM_RECORDS; i++) {
+        logindex_add_record(ix, offset, &records[i]);
+        offset += turnlog_write_record(log, LOG_FORMAT_TEXT, 2, &records[i]);
+        if (i == 1) {
+            logindex_add_checkpoint(ix, 3, map);
+        }
+    }
+    fclose(log);
+    logindex_delete(ix);
+
+    // Test that the index reads back with an entry per record, and its header
+    ix = logindex_open(log_file_name);
+    if (ix != NULL && logindex_count(ix) == NUM_RECORDS && logindex_checkpoint_count(ix) == 1
+        && logindex_get_format(ix) == LOG_FORMAT_TEXT && logindex_get_MazeWidth(ix) == 4
+        && logindex_get_MazeHeight(ix) == 3 && logindex_get_num_avatars(ix) == 2) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+        return 1;
+    }
+
+    // Test that turns are found by iteration, past the error sharing an iteration with the turn before
+    if (logindex_find(ix, 0) == 0 && logindex_find(ix, 1) == 1 && logindex_find(ix, 2) == 3
+        && logindex_find(ix, 3) == 4 && logindex_find(ix, 4) == -1 && logindex_find(ix, -1) == -1) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that a record read through the index is the record written, with its meeting point
+    turn_record_t record;
+    if (logindex_read(ix, 3, &record) && record.kind == RECORD_TURN && record.iteration == 2
+        && record.avatar_id == 1 && record.positions[1].x == 3 && record.target.y == 3
+        && logindex_read(ix, 2, &record) && record.kind == RECORD_ERROR
+        && logindex_read(ix, 5, &record) && record.kind == RECORD_SOLVED && record.solved_moves == 4
+        && !logindex_read(ix, NUM_RECORDS, &record)) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that the checkpoint is named by the records from its own on, and none before
+    logindex_entry_t entry;
+    bool named = true;
+    for (int i = 0; i < NUM_RECORDS; i++) {
+        named = named && logindex_entry(ix, i, &entry) && entry.checkpoint == ((i < 3) ? -1 : 0);
+    }
+    if (named) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that the checkpoint loads back as the map it was taken of
+    map_t *loaded = map_new(4, 3);
+    map_setInference(loaded, true);
+    long record_number;
+    bool same = logindex_load_checkpoint(ix, 0, loaded, &record_number) && record_number == 3
+        && map_getTargetX(loaded) == 3 && map_getTargetY(loaded) == 2
+        && !logindex_load_checkpoint(ix, 1, loaded, &record_number);
+    for (int x = 0; x < 4; x++) {
+        for (int y = 0; y < 3; y++) {
+            same = same && map_wallMask(loaded, x, y) == map_wallMask(map, x, y)
+                && map_distanceXY(loaded, x, y) == map_distanceXY(map, x, y);
+        }
+    }
+    if (same) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+    map_delete(loaded);
+    logindex_delete(ix);
+
+    // Test that a log without an index is refused
+    remove("logindextest.log.idx");
+    if (logindex_open(log_file_name) == NULL) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Clean up
+    map_delete(map);
+    remove(log_file_name);
+    remove("logindextest.log.ckp");
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+/* ========================================================================== */
+/* File: mapbench.c
+ * *** Category: Testing Only ***
+ * *** Not part of compilation path for user-facing executable
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Maria Roodnitsky, Andrw Yang, Siddharth Agrawal, Alexander Hirsch,
+ * Component name:  mapbench.c
+ *
+ * Date Created:    March 10th, 2020
+ *
+ * This file is a microbenchmark for the map module's query and update path.
+ * It reports the average cost in nanoseconds of a single call for each of the
+ * entry points used on every turn by AMClient and simpleprint, and of a wall
+ * update once the distance field towards the target has to be repaired.
+ *
+ * Compilation:     mygcc -O2 mapbench.c ../libs/map.c ../libs/AMlib_avatar.c -o mapbench
+ * Usage:           ./mapbench [mazeWidth] [mazeHeight]
+ *
+ */
+/* ========================================================================== */
+
+// Include C Standard libraries
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+
+// Include project-specific libraries
+#include "../libs/map.h"
+#include "../libs/AMlib_avatar.h"
+
+// Number of queries timed per entry point
+static const int NUM_QUERIES = 4000000;
+
+// Returns the current monotonic time in nanoseconds
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Runs the map query and update microbenchmark
+int main(const int argc, const char *argv[])
+{
+    int mazeWidth = (argc > 1) ? atoi(argv[1]) : 100;
+    int mazeHeight = (argc > 2) ? atoi(argv[2]) : 100;
+    map_t *mp = map_new(mazeWidth, mazeHeight);
+
+    // Precompute random neighbor pairs, so that random number generation is not timed
+    int *qx = malloc(NUM_QUERIES * sizeof(int));
+    int *qy = malloc(NUM_QUERIES * sizeof(int));
+    int *qdx = malloc(NUM_QUERIES * sizeof(int));
+    int *qdy = malloc(NUM_QUERIES * sizeof(int));
+    srand(7);
+    for (int i = 0; i < NUM_QUERIES; i++) {
+        qx[i] = rand() % mazeWidth;
+        qy[i] = rand() % mazeHeight;
+        int dir = rand() % 4;
+        qdx[i] = (dir == 0) ? -1 : (dir == 3) ? 1 : 0;
+        qdy[i] = (dir == 1) ? -1 : (dir == 2) ? 1 : 0;
+    }
+
+    // Seed roughly a third of the edges as walls and a third as open
+    for (int i = 0; i < NUM_QUERIES / 8; i++) {
+        if (i % 3 == 0) {
+            map_setWallXY(mp, qx[i], qy[i], qx[i] + qdx[i], qy[i] + qdy[i]);
+        } else if (i % 3 == 1) {
+            map_setOpenXY(mp, qx[i], qy[i], qx[i] + qdx[i], qy[i] + qdy[i]);
+        }
+    }
+
+    printf("Map %d x %d, %d queries per entry point\n", mazeWidth, mazeHeight, NUM_QUERIES);
+
+    // map_isWallXY
+    long hits = 0;
+    double start = now_ns();
+    for (int i = 0; i < NUM_QUERIES; i++) {
+        hits += map_isWallXY(mp, qx[i], qy[i], qx[i] + qdx[i], qy[i] + qdy[i]);
+    }
+    printf("map_isWallXY:  %6.2f ns/query\n", (now_ns() - start) / NUM_QUERIES);
+
+    // map_isOpenXY
+    start = now_ns();
+    for (int i = 0; i < NUM_QUERIES; i++) {
+        hits += map_isOpenXY(mp, qx[i], qy[i], qx[i] + qdx[i], qy[i] + qdy[i]);
+    }
+    printf("map_isOpenXY:  %6.2f ns/query\n", (now_ns() - start) / NUM_QUERIES);
+
+    // map_getEdge
+    start = now_ns();
+    for (int i = 0; i < NUM_QUERIES; i++) {
+        map_cell_t c1 = {qx[i], qy[i]};
+        map_cell_t c2 = {qx[i] + qdx[i], qy[i] + qdy[i]};
+        hits += (map_getEdge(mp, c1, c2) == MAP_WALL);
+    }
+    printf("map_getEdge:   %6.2f ns/query\n", (now_ns() - start) / NUM_QUERIES);
+
+    // The four-call neighborhood check made by the wall-filler in thread_avatar
+    start = now_ns();
+    for (int i = 0; i < NUM_QUERIES / 4; i++) {
+        int x = qx[i];
+        int y = qy[i];
+        int wall_count = 0;
+        if (map_isWallXY(mp, x + 1, y, x, y)) {wall_count++;}
+        if (map_isWallXY(mp, x, y + 1, x, y)) {wall_count++;}
+        if (map_isWallXY(mp, x - 1, y, x, y)) {wall_count++;}
+        if (map_isWallXY(mp, x, y - 1, x, y)) {wall_count++;}
+        hits += wall_count;
+    }
+    printf("4x isWallXY:   %6.2f ns/cell\n", (now_ns() - start) / (NUM_QUERIES / 4));
+
+    // map_setWallXY
+    start = now_ns();
+    for (int i = 0; i < NUM_QUERIES; i++) {
+        map_setWallXY(mp, qx[i], qy[i], qx[i] + qdx[i], qy[i] + qdy[i]);
+    }
+    printf("map_setWallXY: %6.2f ns/update\n", (now_ns() - start) / NUM_QUERIES);
+
+    // map_nextStepXY and map_setWallXY on a fresh map with a target, so every new wall repairs the distance field
+    map_t *field = map_new(mazeWidth, mazeHeight);
+    map_setTargetXY(field, mazeWidth - 1, 0);
+    start = now_ns();
+    for (int i = 0; i < NUM_QUERIES; i++) {
+        hits += map_nextStepXY(field, qx[i], qy[i]);
+    }
+    printf("map_nextStepXY: %5.2f ns/query\n", (now_ns() - start) / NUM_QUERIES);
+    start = now_ns();
+    for (int i = 0; i < NUM_QUERIES / 8; i++) {
+        map_setWallXY(field, qx[i], qy[i], qx[i] + qdx[i], qy[i] + qdy[i]);
+    }
+    printf("map_setWallXY (distance repair): %6.2f ns/update\n", (now_ns() - start) / (NUM_QUERIES / 8));
+    map_delete(field);
+
+    // Print the hit count so the compiler cannot discard the query loops
+    printf("(checksum %ld)\n", hits);
+
+    // Clean up
+    free(qx);
+    free(qy);
+    free(qdx);
+    free(qdy);
+    map_delete(mp);
+
+    return 0;
+}
@@ -0,0 +1,218 @@
+/* ========================================================================== */
+/* File: mapscanbench.c
+ * *** Category: Testing Only ***
+ * *** Not part of compilation path for user-facing executable
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Maria Roodnitsky, Andrw Yang, Siddharth Agrawal, Alexander Hirsch,
+ * Component name:  mapscanbench.c
+ *
+ * Date Created:    March 10th, 2020
+ *
+ * This file benchmarks full-map scans, in the row-by-row order used by print_map,
+ * for every maze recorded in testoutputs/. It compares three ways of reading the
+ * east and south wall of every cell:
+ *  - legacy:   the original map layout, one malloc'd int column per data column
+ *              of a (2W-1) x (2H-1) grid, read through legacy_isWallXY, which
+ *              makes the same checks as map_isWallXY but allocates nothing
+ *  - isWallXY: the current map module through map_isWallXY
+ *  - wallMask: the current map module through map_wallMask
+ * The first two columns differ only in layout; the third is the fast path.
+ *
+ * The log files do not record the maze dimensions, so the size of each maze is
+ * taken as the largest avatar coordinate seen in any log of the same difficulty
+ * (the server builds every maze of one difficulty at the same size).
+ *
+ * Compilation:     mygcc -O2 mapscanbench.c ../libs/map.c ../libs/AMlib_avatar.c -o mapscanbench
+ * Usage:           ./mapscanbench [testoutputs directory]
+ *
+ */
+/* ========================================================================== */
+
+// Include C Standard libraries
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <dirent.h>
+
+// Include project-specific libraries
+#include "../libs/map.h"
+#include "../libs/AMlib_avatar.h"
+
+// Number of full scans timed per maze and per method
+static const int NUM_SCANS = 200;
+
+// Returns the current monotonic time in nanoseconds
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// The original map's wall query, minus its allocations, over the column-of-pointers layout
+__attribute__((noinline))
+static bool legacy_isWallXY(int **columns, int W, int H, int x1, int y1, int x2, int y2)
+{
+    if (x1 < 0 || x1 > W - 1 || y1 < 0 || y1 > H - 1 || x2 < 0 || x2 > W - 1 || y2 < 0 || y2 > H - 1) {
+        return true;
+    }
+    int dx = x2 - x1;
+    int dy = y2 - y1;
+    if (!((dx == 0) != (dy == 0) && dx >= -1 && dx <= 1 && dy >= -1 && dy <= 1)) {
+        return false;
+    }
+    return columns[2 * x2 - dx][2 * y2 - dy] == MAP_WALL;
+}
+
+// Scans a log file and raises *width and *height to cover every avatar coordinate in it
+static void log_extent(const char *path, int *width, int *height)
+{
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        return;
+    }
+    char line[256];
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        int id, x, y;
+        if (sscanf(line, " Avatar ID: %d X: %d Y: %d", &id, &x, &y) == 3) {
+            if (x + 1 > *width) {
+                *width = x + 1;
+            }
+            if (y + 1 > *height) {
+                *height = y + 1;
+            }
+        }
+    }
+    fclose(fp);
+}
+
+// Runs the full-map scan benchmark over the mazes in testoutputs/
+int main(const int argc, const char *argv[])
+{
+    const char *dirname = (argc > 1) ? argv[1] : "../testoutputs";
+
+    // Collect the logs and their difficulty levels
+    char names[128][256];
+    int difficulty[128];
+    int num_logs = 0;
+    int width[AM_MAX_DIFFICULTY + 1] = {0};
+    int height[AM_MAX_DIFFICULTY + 1] = {0};
+    DIR *dir = opendir(dirname);
+    if (dir == NULL) {
+        fprintf(stderr, "Could not open %s\n", dirname);
+        return 1;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL && num_logs < 128) {
+        char user[64];
+        int avatars, level;
+        if (sscanf(entry->d_name, "Amazing_%63[^_]_%d_%d.log", user, &avatars, &level) == 3 &&
+            level >= 0 && level <= AM_MAX_DIFFICULTY) {
+            snprintf(names[num_logs], sizeof(names[num_logs]), "%s", entry->d_name);
+            difficulty[num_logs] = level;
+            num_logs++;
+
+            // Widen the size of this difficulty's mazes to cover the log
+            char path[512];
+            snprintf(path, sizeof(path), "%s/%s", dirname, entry->d_name);
+            log_extent(path, &width[level], &height[level]);
+        }
+    }
+    closedir(dir);
+
+    printf("%-24s %9s %12s %12s %12s\n", "log", "size", "legacy", "isWallXY", "wallMask");
+    double total_legacy = 0, total_api = 0, total_mask = 0;
+    long checksum = 0;
+    srand(7);
+
+    for (int n = 0; n < num_logs; n++) {
+        int W = width[difficulty[n]];
+        int H = height[difficulty[n]];
+        if (W < 2 || H < 2) {
+            continue;
+        }
+
+        // Build the legacy column-of-pointers grid and the current map with the same random walls
+        int **columns = malloc((2 * W - 1) * sizeof(int *));
+        for (int i = 0; i < 2 * W - 1; i++) {
+            columns[i] = calloc(2 * H - 1, sizeof(int));
+        }
+        map_t *mp = map_new(W, H);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                if (x < W - 1 && rand() % 2) {
+                    columns[2 * x + 1][2 * y] = MAP_WALL;
+                    map_setWallXY(mp, x, y, x + 1, y);
+                }
+                if (y < H - 1 && rand() % 2) {
+                    columns[2 * x][2 * y + 1] = MAP_WALL;
+                    map_setWallXY(mp, x, y, x, y + 1);
+                }
+            }
+        }
+
+        // Legacy layout: row-wise scan strides across the separately allocated columns
+        double start = now_ns();
+        for (int s = 0; s < NUM_SCANS; s++) {
+            for (int y = 0; y < H; y++) {
+                for (int x = 0; x < W; x++) {
+                    checksum += (x < W - 1 && legacy_isWallXY(columns, W, H, x, y, x + 1, y));
+                    checksum += (y < H - 1 && legacy_isWallXY(columns, W, H, x, y, x, y + 1));
+                }
+            }
+        }
+        double legacy = (now_ns() - start) / NUM_SCANS / (W * H);
+
+        // Current map through map_isWallXY, as print_map reads it
+        start = now_ns();
+        for (int s = 0; s < NUM_SCANS; s++) {
+            for (int y = 0; y < H; y++) {
+                for (int x = 0; x < W; x++) {
+                    checksum += (x < W - 1 && map_isWallXY(mp, x, y, x + 1, y));
+                    checksum += (y < H - 1 && map_isWallXY(mp, x, y, x, y + 1));
+                }
+            }
+        }
+        double api = (now_ns() - start) / NUM_SCANS / (W * H);
+
+        // Current map through the per-cell wall mask
+        start = now_ns();
+        for (int s = 0; s < NUM_SCANS; s++) {
+            for (int y = 0; y < H; y++) {
+                for (int x = 0; x < W; x++) {
+                    int mask = map_wallMask(mp, x, y);
+                    checksum += (x < W - 1 && (mask & MAP_WALL_EAST));
+                    checksum += (y < H - 1 && (mask & MAP_WALL_SOUTH));
+                }
+            }
+        }
+        double masked = (now_ns() - start) / NUM_SCANS / (W * H);
+
+        char size[32];
+        snprintf(size, sizeof(size), "%dx%d", W, H);
+        printf("%-24s %9s %9.2f ns %9.2f ns %9.2f ns  (per cell)\n", names[n], size, legacy, api, masked);
+        total_legacy += legacy;
+        total_api += api;
+        total_mask += masked;
+
+        // Clean up this maze
+        for (int i = 0; i < 2 * W - 1; i++) {
+            free(columns[i]);
+        }
+        free(columns);
+        map_delete(mp);
+    }
+
+    if (num_logs > 0) {
+        printf("%-24s %9s %9.2f ns %9.2f ns %9.2f ns  (per cell)\n", "mean", "",
+               total_legacy / num_logs, total_api / num_logs, total_mask / num_logs);
+    }
+
+    // Print the checksum so the compiler cannot discard the scans
+    printf("(%d logs, checksum %ld)\n", num_logs, checksum);
+    return 0;
+}
@@ -21,6 +21,7 @@
 // Include C Standard libraries
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdlib.h>
 
 // Include project-specific libraries
 #include "../libs/map.h"
@@ -141,6 +142,320 @@ int main(const int argc, const char *argv[])
         printf("Incorrect outcome\n");
     }
 
+    // Test that neighboring edges packed into the same byte do not overwrite each other
+    map_t *wide = map_new(9, 2);
+    for (int x = 0; x < 8; x++) {
+        if (x % 2 == 0) {
+            map_setWallXY(wide, x, 0, x + 1, 0);
+        } else {
+            map_setOpenXY(wide, x, 0, x + 1, 0);
+        }
+    }
+    bool packed_ok = true;
+    for (int x = 0; x < 8; x++) {
+        if (x % 2 == 0 && !map_isWallXY(wide, x, 0, x + 1, 0)) {
+            packed_ok = false;
+        }
+        if (x % 2 == 1 && !map_isOpenXY(wide, x, 0, x + 1, 0)) {
+            packed_ok = false;
+        }
+        if (map_isWallXY(wide, x, 1, x + 1, 1) || map_isWallXY(wide, x, 0, x, 1)) {
+            packed_ok = false;
+        }
+    }
+    if (packed_ok) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+    map_delete(wide);
+
+    // Test the per-cell wall masks: border sides start walled, and the setters keep both cells in sync
+    map_t *small = map_new(3, 3);
+    if (map_wallMask(small, 0, 0) == (MAP_WALL_WEST | MAP_WALL_NORTH) && map_wallMask(small, 1, 1) == 0) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+    map_setWallXY(small, 1, 1, 2, 1);
+    map_setWallXY(small, 1, 0, 1, 1);
+    if (map_wallMask(small, 1, 1) == (MAP_WALL_EAST | MAP_WALL_NORTH) && map_wallCount(small, 1, 1) == 2 &&
+        map_wallMask(small, 2, 1) == (MAP_WALL_WEST | MAP_WALL_EAST) && map_wallCount(small, 1, 0) == 2) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+    map_setOpenXY(small, 2, 1, 1, 1);
+    if (map_wallMask(small, 1, 1) == MAP_WALL_NORTH && map_wallCount(small, -1, 0) == 4) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+    map_delete(small);
+
+    // Test dead-end filling down a 6 x 1 corridor: the fill cascades, but stops at avatars and the target
+    map_t *corridor = map_new(6, 1);
+    map_setTargetXY(corridor, 5, 0);
+    avatar_t **avatars = avatar_array_new(1);
+    avatar_t *av = avatar_new(0);
+    position_setX(avatar_getPosition(av), 2);
+    position_setY(avatar_getPosition(av), 0);
+    avatar_array_add(avatars, av);
+    occupancy_t *occupancy = occupancy_new(6, 1, 1);
+    occupancy_sync(occupancy, avatars);
+    if (map_fillDeadEnds(corridor, 0, 0, occupancy) == 2 && map_isWallXY(corridor, 1, 0, 2, 0) &&
+        !map_isWallXY(corridor, 2, 0, 3, 0)) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+    position_setX(avatar_getPosition(av), 5);
+    occupancy_sync(occupancy, avatars);
+    if (map_fillDeadEnds(corridor, 2, 0, occupancy) == 3 && map_wallCount(corridor, 5, 0) == 4 &&
+        map_fillDeadEnds(corridor, 5, 0, occupancy) == 0) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+    map_delete(corridor);
+    occupancy_delete(occupancy);
+
+    // Test the whole-map dead-end sweep on an odd-sized map: it must mark exactly the cells with three walls,
+    // except the target, and sweeping must leave no dead end behind
+    map_t *swept = map_new(37, 23);
+    map_setTargetXY(swept, 36, 0);
+    srand(11);
+    for (int y = 0; y < 23; y++) {
+        for (int x = 0; x < 37; x++) {
+            if (rand() % 2) {
+                map_setWallXY(swept, x, y, x + 1, y);
+            }
+            if (rand() % 2) {
+                map_setWallXY(swept, x, y, x, y + 1);
+            }
+        }
+    }
+    const uint64_t *bitmap;
+    int found = map_findDeadEnds(swept, &bitmap);
+    int expected = 0;
+    bool marks_ok = true;
+    for (int y = 0; y < 23; y++) {
+        for (int x = 0; x < 37; x++) {
+            int cell = y * 37 + x;
+            bool dead_end = map_wallCount(swept, x, y) == 3 && !(x == 36 && y == 0);
+            expected += dead_end;
+            if (((bitmap[cell / 64] >> (cell % 64)) & 1) != dead_end) {
+                marks_ok = false;
+            }
+        }
+    }
+    if (marks_ok && found == expected && found > 0) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+    position_setX(avatar_getPosition(av), 36);
+    occupancy = occupancy_new(37, 23, 1);
+    occupancy_sync(occupancy, avatars);
+    if (map_sweepDeadEnds(swept, occupancy) >= found && map_findDeadEnds(swept, NULL) == 0) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+    avatar_array_delete(avatars, 1);
+    occupancy_delete(occupancy);
+    map_delete(swept);
+
+    // Test that as avatars wander, several at times on one cell and at times off the maze, the occupancy always
+    // finds the avatar avatar_array_find_avatar does, and counts the avatars on every cell
+    avatars = avatar_array_new(AM_MAX_AVATAR);
+    for (int i = 0; i < AM_MAX_AVATAR; i++) {
+        avatar_array_add(avatars, avatar_new(i));
+    }
+    occupancy = occupancy_new(5, 4, AM_MAX_AVATAR);
+    srand(24);
+    bool occupancy_ok = true;
+    for (int step = 0; step < 2000 && occupancy_ok; step++) {
+        int i = rand() % AM_MAX_AVATAR;
+        int x = rand() % 7 - 1;
+        int y = rand() % 6 - 1;
+        position_setX(avatar_getPosition(avatars[i]), x);
+        position_setY(avatar_getPosition(avatars[i]), y);
+        if (step % 2 == 0) {
+            occupancy_move(occupancy, i, x, y);
+        } else {
+            occupancy_sync(occupancy, avatars);
+        }
+        for (int cy = -1; cy <= 4; cy++) {
+            for (int cx = -1; cx <= 5; cx++) {
+                int count = 0;
+                for (int a = 0; a < AM_MAX_AVATAR; a++) {
+                    count += (avatar_getX(avatars[a]) == cx && avatar_getY(avatars[a]) == cy);
+                }
+                bool on_maze = cx >= 0 && cx < 5 && cy >= 0 && cy < 4;
+                int found_here = on_maze ? avatar_array_find_avatar(avatars, AM_MAX_AVATAR, cx, cy) : -1;
+                if (occupancy_find_avatar(occupancy, cx, cy) != found_here ||
+                    occupancy_count(occupancy, cx, cy) != (on_maze ? count : 0)) {
+                    occupancy_ok = false;
+                }
+            }
+        }
+    }
+    if (occupancy_ok) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+    avatar_array_delete(avatars, AM_MAX_AVATAR);
+    occupancy_delete(occupancy);
+
+    // Test inference: an unknown edge closing a loop of open edges is a wall, and the last side of a cell walled
+    // on three sides is open
+    map_t *inferred = map_new(3, 3);
+    map_setInference(inferred, true);
+    map_setOpenXY(inferred, 0, 0, 1, 0);
+    map_setOpenXY(inferred, 1, 0, 1, 1);
+    map_setOpenXY(inferred, 1, 1, 0, 1);
+    if (map_isWallXY(inferred, 0, 0, 0, 1) && map_isUnknownXY(inferred, 0, 1, 0, 2) && map_getInferredCount(inferred) == 1) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+    map_setWallXY(inferred, 2, 0, 2, 1);
+    if (map_isOpenXY(inferred, 1, 0, 2, 0) && map_getInferredCount(inferred) == 2) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+    map_delete(inferred);
+
+    // Test the distance field: it routes around new walls, and reports cells cut off from the target
+    map_t *field = map_new(3, 3);
+    map_setTargetXY(field, 2, 0);
+    if (map_distanceXY(field, 0, 2) == 4 && map_distanceXY(field, 2, 0) == 0 && map_nextStepXY(field, 2, 0) == M_NULL_MOVE) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+    map_setWallXY(field, 1, 0, 2, 0);
+    if (map_distanceXY(field, 0, 0) == 4 && map_nextStepXY(field, 1, 0) == M_SOUTH) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+    map_setWallXY(field, 2, 0, 2, 1);
+    if (map_distanceXY(field, 0, 0) == -1 && map_nextStepXY(field, 0, 0) == M_NULL_MOVE) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+    map_delete(field);
+
+    // Test that moving the target repairs the distance field into the one built for the new target from scratch,
+    // over walls which cut the maze into pieces, so that some targets are cut off from the one before
+    map_t *moved = map_new(12, 9);
+    map_setTargetXY(moved, 11, 0);
+    unsigned int seed = 5;
+    int walls[60][4];
+    for (int i = 0; i < 60; i++) {
+        seed = seed * 1103515245 + 12345;
+        int x = (seed >> 8) % 11;
+        int y = (seed >> 16) % 8;
+        bool east = (seed >> 24) & 1;
+        walls[i][0] = x;
+        walls[i][1] = y;
+        walls[i][2] = east ? x + 1 : x;
+        walls[i][3] = east ? y : y + 1;
+        map_setWallXY(moved, walls[i][0], walls[i][1], walls[i][2], walls[i][3]);
+    }
+    int targets[6][2] = {{5, 4}, {0, 8}, {6, 4}, {11, 8}, {3, 0}, {5, 4}};
+    bool repaired = true;
+    for (int t = 0; t < 6; t++) {
+        map_setTargetXY(moved, targets[t][0], targets[t][1]);
+        map_t *built = map_new(12, 9);
+        for (int i = 0; i < 60; i++) {
+            map_setWallXY(built, walls[i][0], walls[i][1], walls[i][2], walls[i][3]);
+        }
+        map_setTargetXY(built, targets[t][0], targets[t][1]);
+        for (int y = 0; y < 9; y++) {
+            for (int x = 0; x < 12; x++) {
+                repaired = repaired && map_distanceXY(moved, x, y) == map_distanceXY(built, x, y);
+            }
+        }
+        map_delete(built);
+    }
+    if (repaired) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+    map_delete(moved);
+
+    // Test that a map with no target has no distances, and that moving the target across a large open map, which
+    // grows the repair heap many times over, repairs the field into the one built from scratch
+    map_t *large = map_new(40, 40);
+    map_t *largeBuilt = map_new(40, 40);
+    bool grown = map_distanceXY(large, 0, 0) == -1 && map_nextStepXY(large, 0, 0) == M_NULL_MOVE;
+    map_setTargetXY(large, 0, 0);
+    map_setTargetXY(large, 39, 39);
+    map_setTargetXY(largeBuilt, 39, 39);
+    for (int y = 0; y < 40; y++) {
+        for (int x = 0; x < 40; x++) {
+            grown = grown && map_distanceXY(large, x, y) == map_distanceXY(largeBuilt, x, y);
+        }
+    }
+    if (grown && map_distanceXY(large, 0, 0) == 78) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+    map_delete(largeBuilt);
+    map_delete(large);
+
+    // Test packing: a map unpacked from another's edges, over a map already used, has the same edges, wall masks,
+    // distance field and components of open edges
+    map_t *packed = map_new(4, 3);
+    map_setInference(packed, true);
+    map_setTargetXY(packed, 3, 0);
+    map_setOpenXY(packed, 0, 0, 1, 0);
+    map_setOpenXY(packed, 1, 0, 1, 1);
+    map_setWallXY(packed, 1, 1, 2, 1);
+    map_setOpenXY(packed, 2, 0, 3, 0);
+    map_setWallXY(packed, 0, 1, 0, 2);
+    map_setOpenXY(packed, 0, 1, 1, 1);
+    uint8_t buf[16];
+    bool fits = map_packedSize(packed) <= sizeof(buf);
+    if (fits) {
+        map_pack(packed, buf);
+    }
+    map_t *unpacked = map_new(4, 3);
+    map_setInference(unpacked, true);
+    map_setWallXY(unpacked, 2, 2, 3, 2);
+    map_setTargetXY(unpacked, 3, 0);
+    if (fits) {
+        map_unpack(unpacked, buf);
+    }
+    bool same = fits;
+    for (int y = 0; y < 3; y++) {
+        for (int x = 0; x < 4; x++) {
+            same = same && map_wallMask(packed, x, y) == map_wallMask(unpacked, x, y)
+                && map_distanceXY(packed, x, y) == map_distanceXY(unpacked, x, y)
+                && map_isUnknownXY(packed, x, y, x + 1, y) == map_isUnknownXY(unpacked, x, y, x + 1, y)
+                && map_isOpenXY(packed, x, y, x, y + 1) == map_isOpenXY(unpacked, x, y, x, y + 1);
+            for (int other = 0; other < 12; other++) {
+                same = same && map_isConnectedXY(packed, x, y, other % 4, other / 4)
+                    == map_isConnectedXY(unpacked, x, y, other % 4, other / 4);
+            }
+        }
+    }
+    if (same) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+    map_delete(packed);
+    map_delete(unpacked);
+
     // Clean up
     position_delete(pos1);
     position_delete(pos2);
@@ -0,0 +1,37 @@
+#!/bin/bash
+#
+# modebench.sh
+#
+# Authors:      Maria Roodnitsky, Siddharth Agrawal, Andrw Yang, Alxander Hirsch
+# Date:         March 2020
+#
+# Usage:        bash testscripts/modebench.sh [num_avatars] [difficulty_level] [hostname] [runs]
+#
+# Description:  Compares the two ways AMClient can run the avatars, a thread per avatar
+#               (-m threads) and one epoll loop for all of them (-m epoll), on the same
+#               maze. Plays the maze [runs] times (default 3) in each mode, and prints
+#               the mode, number of turns, turn latency (from reading a turn's message
+#               to sending its move), CPU time, and lock waits and holds that AMStartup
+#               reports for each game.
+#
+
+if [ $# -lt 3 ]; then
+    echo "Usage: bash testscripts/modebench.sh [num_avatars] [difficulty_level] [hostname] [runs]"
+    exit 1
+fi
+RUNS=${4:-3}
+AMSTARTUP="$(cd "$(dirname "$0")/.." && pwd)/AMStartup"
+
+# Play in a scratch directory, so the benchmark's logs do not mix with the test outputs
+SCRATCH=$(mktemp -d)
+cd "$SCRATCH"
+
+for MODE in threads epoll
+do
+    for RUN in $(seq 1 $RUNS)
+    do
+        "$AMSTARTUP" -m $MODE $1 $2 $3 2>/dev/null | grep -E "STATUS: Client Start: ($MODE mode|lock taken)"
+    done
+done
+
+rm -rf "$SCRATCH"
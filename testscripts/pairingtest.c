@@ -0,0 +1,113 @@
+/* ========================================================================== */
+/* File: pairingtest.c
+ * *** Category: Testing Only ***
+ * *** Not part of compilation path for user-facing executable
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Maria Roodnitsky, Andrw Yang, Siddharth Agrawal, Alexander Hirsch,
+ * Component name:  pairingtest.c
+ *
+ * Date Created:    March 11th, 2020
+ *
+ * This file is a test driver for the pairing module.
+ *
+ * Compilation:     mygcc pairingtest.c ../libs/pairing.c ../libs/convoy.c ../libs/map.c ../libs/AMlib_avatar.c -o pairingtest
+ * Usage:           ./pairingtest
+ *
+ */
+/* ========================================================================== */
+
+// Include C Standard libraries
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+// Include project-specific libraries
+#include "../libs/amazing.h"
+#include "../libs/map.h"
+#include "../libs/AMlib_avatar.h"
+#include "../libs/convoy.h"
+#include "../libs/pairing.h"
+
+// Places avatar av at (x, y)
+static void place(avatar_t *av, int x, int y)
+{
+    position_setX(avatar_getPosition(av), x);
+    position_setY(avatar_getPosition(av), y);
+}
+
+// Runs unit testing for the pairing module
+int main(const int argc, const char *argv[])
+{
+    // A 3 x 3 map with a known S-shaped path (0,0) -> (2,0) -> (2,1) -> (0,1) -> (0,2)
+    map_t *map = map_new(3, 3);
+    map_setInference(map, true);
+    pairing_t *pr = pairing_new(3, 3);
+    map_setOpenXY(map, 0, 0, 1, 0);
+    map_setOpenXY(map, 1, 0, 2, 0);
+    map_setOpenXY(map, 2, 0, 2, 1);
+    map_setOpenXY(map, 2, 1, 1, 1);
+    map_setOpenXY(map, 1, 1, 0, 1);
+    map_setOpenXY(map, 0, 1, 0, 2);
+
+    // Test that the search finds the whole known path, not the shortcut through the unknown edge below
+    uint32_t move = M_NULL_MOVE;
+    int length = pairing_pathXY(pr, map, 0, 0, 0, 2, &move);
+    if (length == 6 && move == M_EAST) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that the first step is taken from the first cell, whichever side the searches meet on
+    move = M_NULL_MOVE;
+    length = pairing_pathXY(pr, map, 0, 2, 0, 0, &move);
+    if (length == 6 && move == M_NORTH) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that no path is reported to a cell the known-open edges do not reach
+    move = M_NULL_MOVE;
+    if (pairing_pathXY(pr, map, 0, 0, 2, 2, &move) == -1 && move == M_NULL_MOVE &&
+        pairing_pathXY(pr, map, 1, 1, 1, 1, &move) == 0 && move == M_NULL_MOVE) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Three avatars: 0 at (0,0) and 1 at (2,1) are connected, 2 at (2,2) is not
+    convoy_t *cv = convoy_new(3, 3, 3);
+    avatar_t **avatars = avatar_array_new(3);
+    for (int i = 0; i < 3; i++) {
+        avatar_array_add(avatars, avatar_new(i));
+    }
+    place(avatars[0], 0, 0);
+    place(avatars[1], 2, 1);
+    place(avatars[2], 2, 2);
+
+    // Test that an avatar heads for the nearest connected avatar, and finds none once they are grouped
+    move = M_NULL_MOVE;
+    int partner = pairing_converge(pr, map, avatars, 3, cv, 0, &move);
+    bool converges = (partner == 1 && move == M_EAST);
+    place(avatars[1], 0, 0);
+    convoy_update(cv, avatars, 3);
+    place(avatars[1], 1, 0);
+    move = M_NULL_MOVE;
+    if (converges && pairing_converge(pr, map, avatars, 3, cv, 0, &move) == -1 && move == M_NULL_MOVE &&
+        pairing_converge(pr, map, avatars, 3, NULL, 0, &move) == 1 && move == M_EAST) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Clean up
+    avatar_array_delete(avatars, 3);
+    convoy_delete(cv);
+    pairing_delete(pr);
+    map_delete(map);
+
+    return 0;
+}
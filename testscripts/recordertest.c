@@ -0,0 +1,300 @@
+/* ========================================================================== */
+/* File: recordertest.c
+ * *** Category: Testing Only ***
+ * *** Not part of compilation path for user-facing executable
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Maria Roodnitsky, Andrw Yang, Siddharth Agrawal, Alexander Hirsch,
+ * Component name:  recordertest.c
+ *
+ * Date Created:    March 13th, 2020
+ *
+ * This file is a test driver for the recorder module. The recorder also prints the maze
+ * for the records it is handed, so the maze appears before the outcomes.
+ *
+ * Compilation:     mygcc recordertest.c ../libs/recorder.c ../libs/render.c ../libs/map.c ../libs/AMlib_avatar.c ../libs/turnlog.c ../libs/logindex.c -lpthread -o recordertest
+ * Usage:           ./recordertest
+ *
+ */
+/* ========================================================================== */
+
+// Include C Standard libraries
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+// Include project-specific libraries
+#include "../libs/amazing.h"
+#include "../libs/map.h"
+#include "../libs/recorder.h"
+#include "../libs/logindex.h"
+
+// The log the records below must produce, in the avatars' text format
+static const char *expected_log =
+    "\n\nIteration: 0. It is avatar #0's turn. Current positions by avatar: \n"
+    "\tAvatar ID: 0 X: 0 Y: 0 \n"
+    "\tAvatar ID: 1 X: 2 Y: 1 \n"
+    "\tFirst move, so no prior move to report."
+    "\n\tAvatar #0 is now requesting to move east.\n"
+    "\n\nIteration: 1. It is avatar #1's turn. Current positions by avatar: \n"
+    "\tAvatar ID: 0 X: 1 Y: 0 \n"
+    "\tAvatar ID: 1 X: 2 Y: 1 \n"
+    "\tThe result of the previous turn is: Move successful and wall filled behind."
+    "\n\tAvatar #1 is now requesting to move nowhere, staying at the meeting point.\n"
+    "\tThread #1: Received error. Message type: -2147483392 \n"
+    "\tThread #1: The error message type is AM_TOO_MANY_MOVES \n"
+    "\n*** Received AM_MAZE_SOLVED ***\n"
+    "Message contents: Num avatars: 2; Difficulty level: 0; Num moves: 2; Hash: 12345\n";
+
+// The avatars, and the turns each of them submits at once, when several submit together
+#define TEST_AVATARS 4
+#define TEST_TURNS 5000
+#define TEST_FPS 20
+
+// What each submitting thread needs
+typedef struct submitter {
+    recorder_t *rc;
+    int avatar_id;
+} submitter_t;
+
+// Submits TEST_TURNS turns of one avatar, numbered in order
+static void *submit_turns(void *arg)
+{
+    submitter_t *sub = arg;
+    turn_record_t record;
+    memset(&record, 0, sizeof(record));
+    record.kind = RECORD_TURN;
+    record.avatar_id = sub->avatar_id;
+    record.num_avatars = 1;
+    record.outcome = RECORD_OUTCOME_PATH;
+    record.move = M_NORTH;
+    for (int i = 1; i <= TEST_TURNS; i++) {
+        record.iteration = i;
+        recorder_submit(sub->rc, &record);
+    }
+    return NULL;
+}
+
+// Reads the whole of the file at path into buf, of size size. Returns the number of bytes read
+static size_t read_file(const char *path, char *buf, size_t size)
+{
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        return 0;
+    }
+    size_t n = fread(buf, 1, size - 1, fp);
+    buf[n] = '\0';
+    fclose(fp);
+    return n;
+}
+
+// Runs unit testing for the recorder module
+int main(const int argc, const char *argv[])
+{
+    // A 3 x 2 map shared by two avatars, and an empty log
+    const char *log_file_name = "recordertest.log";
+    FILE *fp = fopen(log_file_name, "w");
+    if (fp == NULL) {
+        printf("Incorrect outcome: could not create %s\n", log_file_name);
+        return 1;
+    }
+    fclose(fp);
+    map_t *shared = map_new(3, 2);
+    map_setOpenXY(shared, 0, 0, 1, 0);
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    recorder_t *rc = recorder_new(log_file_name, LOG_FORMAT_TEXT, shared, &lock, 3, 2, 2, RECORDER_DEFAULT_FPS);
+
+    // Two turns, an error and the solved message
+    turn_record_t record;
+    memset(&record, 0, sizeof(record));
+    record.kind = RECORD_TURN;
+    record.num_avatars = 2;
+    record.positions[1].x = 2;
+    record.positions[1].y = 1;
+    record.outcome = RECORD_OUTCOME_NONE;
+    record.move = M_EAST;
+    recorder_submit(rc, &record);
+
+    record.avatar_id = 1;
+    record.iteration = 1;
+    record.positions[0].x = 1;
+    record.outcome = RECORD_OUTCOME_PATH_FILL;
+    record.move = M_NULL_MOVE;
+    recorder_submit(rc, &record);
+
+    memset(&record, 0, sizeof(record));
+    record.kind = RECORD_ERROR;
+    record.avatar_id = 1;
+    record.message_type = AM_TOO_MANY_MOVES;
+    recorder_submit(rc, &record);
+
+    memset(&record, 0, sizeof(record));
+    record.kind = RECORD_SOLVED;
+    record.num_avatars = 2;
+    record.solved_avatars = 2;
+    record.solved_moves = 2;
+    record.solved_hash = 12345;
+    recorder_submit(rc, &record);
+
+    // Test that once the recorder is deleted, every record is in the log, in order, in the avatars' format
+    recorder_delete(rc);
+    char log[4096];
+    read_file(log_file_name, log, sizeof(log));
+    if (strcmp(log, expected_log) == 0) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that a recorder with nothing to log stops at once, and leaves the log alone
+    rc = recorder_new(log_file_name, LOG_FORMAT_TEXT, shared, &lock, 3, 2, 2, RECORDER_DEFAULT_FPS);
+    recorder_delete(rc);
+    read_file(log_file_name, log, sizeof(log));
+    if (strcmp(log, expected_log) == 0) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that when several avatars submit at once, more turns than the recorder can hold, every
+    // turn is logged once, and each avatar's turns are logged in the order it submitted them
+    fp = fopen(log_file_name, "w");
+    if (fp != NULL) {
+        fclose(fp);
+    }
+    rc = recorder_new(log_file_name, LOG_FORMAT_TEXT, shared, &lock, 3, 2, 1, TEST_FPS);
+    struct timespec began, ended;
+    clock_gettime(CLOCK_MONOTONIC, &began);
+    pthread_t threads[TEST_AVATARS];
+    submitter_t submitters[TEST_AVATARS];
+    for (int i = 0; i < TEST_AVATARS; i++) {
+        submitters[i].rc = rc;
+        submitters[i].avatar_id = i;
+        pthread_create(&threads[i], NULL, submit_turns, &submitters[i]);
+    }
+    for (int i = 0; i < TEST_AVATARS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    long frames = recorder_get_frames(rc);
+    recorder_delete(rc);
+    clock_gettime(CLOCK_MONOTONIC, &ended);
+    double seconds = (ended.tv_sec - began.tv_sec) + (ended.tv_nsec - began.tv_nsec) / 1e9;
+
+    int last_iteration[TEST_AVATARS] = {0};
+    int logged = 0;
+    bool in_order = true;
+    fp = fopen(log_file_name, "r");
+    char line[200];
+    while (fp != NULL && fgets(line, sizeof(line), fp) != NULL) {
+        int iteration, avatar_id;
+        if (sscanf(line, "Iteration: %d. It is avatar #%d's turn.", &iteration, &avatar_id) == 2) {
+            if (avatar_id < 0 || avatar_id >= TEST_AVATARS || iteration != last_iteration[avatar_id] + 1) {
+                in_order = false;
+                break;
+            }
+            last_iteration[avatar_id] = iteration;
+            logged++;
+        }
+    }
+    if (fp != NULL) {
+        fclose(fp);
+    }
+    if (in_order && logged == TEST_AVATARS * TEST_TURNS) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome: %d turns logged\n", logged);
+    }
+
+    // Test that the log's index has an entry for every turn, at the offset the turn starts at, and
+    // that the map was checkpointed as the turns were logged, no more often than the interval
+    logindex_t *ix = logindex_open(log_file_name);
+    long indexed = 0;
+    while (ix != NULL && logindex_read(ix, indexed, &record) && record.kind == RECORD_TURN) {
+        indexed++;
+    }
+    if (ix != NULL && indexed == TEST_AVATARS * TEST_TURNS && logindex_count(ix) == indexed
+        && logindex_checkpoint_count(ix) >= 1 && logindex_checkpoint_count(ix) <= indexed / LOGINDEX_CHECKPOINT_INTERVAL) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome: %ld turns indexed\n", indexed);
+    }
+    logindex_delete(ix);
+
+    // Test that the maze was drawn, while the turns were logged, no more often than the frame rate
+    if (frames >= 1 && frames <= seconds * TEST_FPS + 1) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome: %ld frames in %.3f s\n", frames, seconds);
+    }
+
+    // Test that a recorder drawing on request draws nothing for the turns logged, and a frame once asked
+    rc = recorder_new(log_file_name, LOG_FORMAT_TEXT, shared, &lock, 3, 2, 2, 0);
+    memset(&record, 0, sizeof(record));
+    record.kind = RECORD_TURN;
+    record.num_avatars = 2;
+    for (int i = 0; i < 100; i++) {
+        record.iteration = i;
+        recorder_submit(rc, &record);
+    }
+    usleep(100000);
+    long unasked = recorder_get_frames(rc);
+    recorder_request_frame(rc);
+    for (int waited = 0; waited < 100 && recorder_get_frames(rc) == 0; waited++) {
+        usleep(10000);
+    }
+    if (unasked == 0 && recorder_get_frames(rc) == 1) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome: %ld frames unasked\n", unasked);
+    }
+    recorder_delete(rc);
+
+    // Test that a headless recorder draws nothing, dumps the map when asked to and once the maze is
+    // solved, each dump replacing the last, and that a dump shows the avatars where the last turn had them
+    rc = recorder_new(log_file_name, LOG_FORMAT_TEXT, shared, &lock, 3, 2, 2, RECORDER_HEADLESS);
+    char dump_file_name[100];
+    snprintf(dump_file_name, sizeof(dump_file_name), "%s", recorder_get_dump_file_name(rc));
+    remove(dump_file_name);
+    memset(&record, 0, sizeof(record));
+    record.kind = RECORD_TURN;
+    record.num_avatars = 2;
+    record.positions[1].x = 2;
+    record.positions[1].y = 1;
+    recorder_submit(rc, &record);
+    recorder_request_dump(rc);
+    for (int waited = 0; waited < 100 && (fp = fopen(dump_file_name, "r")) == NULL; waited++) {
+        usleep(10000);
+    }
+    char requested[200] = "";
+    if (fp != NULL) {
+        read_file(dump_file_name, requested, sizeof(requested));
+        fclose(fp);
+    }
+    record.kind = RECORD_SOLVED;
+    recorder_submit(rc, &record);
+    long headless_frames = recorder_get_frames(rc);
+    recorder_delete(rc);
+    char dump[4096];
+    read_file(dump_file_name, dump, sizeof(dump));
+    if (headless_frames == 0 && strstr(requested, " records logged, on request.") != NULL
+        && strncmp(dump, "Map after 2 records logged, AM_MAZE_SOLVED.", 43) == 0
+        && strstr(dump, "  1|         1 |\n") != NULL && strchr(dump, '\033') == NULL) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+    remove(dump_file_name);
+
+    // Clean up
+    map_delete(shared);
+    remove(log_file_name);
+    remove("recordertest.log.idx");
+    remove("recordertest.log.ckp");
+
+    return 0;
+}
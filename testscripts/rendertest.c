@@ -0,0 +1,377 @@
+/* ========================================================================== */
+/* File: rendertest.c
+ * *** Category: Testing Only ***
+ * *** Not part of compilation path for user-facing executable
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Maria Roodnitsky, Andrw Yang, Siddharth Agrawal, Alexander Hirsch,
+ * Component name:  rendertest.c
+ *
+ * Date Created:    March 16th, 2020
+ *
+ * This file is a test driver for the render module. The renderer draws to rendertest.out,
+ * which is removed once done; what it draws is played on a screen of characters, as a
+ * terminal would, to be compared. As rendertest.out is not a terminal, views are given
+ * their size.
+ *
+ * Compilation:     mygcc rendertest.c ../libs/render.c ../libs/simpleprint.c ../libs/map.c ../libs/AMlib_avatar.c -o rendertest
+ * Usage:           ./rendertest
+ *
+ */
+/* ========================================================================== */
+
+// Include C Standard libraries
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Include project-specific libraries
+#include "../libs/map.h"
+#include "../libs/AMlib_avatar.h"
+#include "../libs/simpleprint.h"
+#include "../libs/render.h"
+
+#define WIDTH 12
+#define HEIGHT 9
+#define NUM_AV 4
+#define SCREEN_ROWS (2 * HEIGHT + 3)
+#define SCREEN_COLS (4 * WIDTH + 8)
+#define FRAMES 200
+
+// A screen of characters, and its cursor
+typedef struct screen {
+    char cells[SCREEN_ROWS][SCREEN_COLS];
+    int row;
+    int col;
+} screen_t;
+
+// Clears the screen, and homes its cursor
+static void screen_clear(screen_t *sc)
+{
+    memset(sc->cells, ' ', sizeof(sc->cells));
+    sc->row = 0;
+    sc->col = 0;
+}
+
+// Plays size bytes on the screen, as a terminal would: the characters, newlines, backspaces, and the
+// escapes clearing the screen and moving the cursor. Returns false on anything else
+static bool screen_play(screen_t *sc, const char *bytes, size_t size)
+{
+    for (size_t i = 0; i < size; i++) {
+        char c = bytes[i];
+        if (c == '\033') {
+            int row = 1, col = 1, used = 0;
+            if (sscanf(&bytes[i], "\033[%d;%dH%n", &row, &col, &used) == 2 && used > 0) {
+                sc->row = row - 1;
+                sc->col = col - 1;
+            } else if (strncmp(&bytes[i], "\033[H", 3) == 0) {
+                sc->row = 0;
+                sc->col = 0;
+                used = 3;
+            } else if (strncmp(&bytes[i], "\033[2J", 4) == 0) {
+                memset(sc->cells, ' ', sizeof(sc->cells));
+                used = 4;
+            } else {
+                return false;
+            }
+            i += used - 1;
+        } else if (c == '\n') {
+            sc->row++;
+            sc->col = 0;
+        } else if (c == '\b') {
+            sc->col--;
+        } else if (sc->row >= 0 && sc->row < SCREEN_ROWS && sc->col >= 0 && sc->col < SCREEN_COLS) {
+            sc->cells[sc->row][sc->col++] = c;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Reads back whatever was written to fd since the last call, into buf. Returns its size
+static size_t take_output(int fd, char *buf, size_t capacity)
+{
+    off_t end = lseek(fd, 0, SEEK_CUR);
+    lseek(fd, 0, SEEK_SET);
+    ssize_t size = read(fd, buf, (end < (off_t)capacity) ? (size_t)end : capacity);
+    if (ftruncate(fd, 0) != 0) {
+        return 0;
+    }
+    lseek(fd, 0, SEEK_SET);
+    return (size > 0) ? (size_t)size : 0;
+}
+
+// Places avatar i of av_array at x, y
+static void place(avatar_t **av_array, int i, int x, int y)
+{
+    position_setX(avatar_getPosition(av_array[i]), x);
+    position_setY(avatar_getPosition(av_array[i]), y);
+}
+
+// Moves avatar of av_array a step at random, and learns a wall at random on two frames out of three
+static void wander(map_t *map, avatar_t **av_array, int frame)
+{
+    int i = rand() % NUM_AV;
+    int x = avatar_getX(av_array[i]) + rand() % 3 - 1;
+    int y = avatar_getY(av_array[i]) + rand() % 3 - 1;
+    if (x >= 0 && x < WIDTH && y >= 0 && y < HEIGHT) {
+        place(av_array, i, x, y);
+    }
+    int wx = rand() % (WIDTH - 1);
+    int wy = rand() % (HEIGHT - 1);
+    if (frame % 3 == 0) {
+        map_setWallXY(map, wx, wy, wx + 1, wy);
+    } else if (frame % 3 == 1) {
+        map_setWallXY(map, wx, wy, wx, wy + 1);
+    }
+}
+
+// Returns true if the screen shows character c on any of its rows from row on
+static bool shows(screen_t *sc, int row, char c)
+{
+    for (; row < SCREEN_ROWS; row++) {
+        if (memchr(sc->cells[row], c, SCREEN_COLS) != NULL) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Runs unit testing for the render module
+int main(const int argc, const char *argv[])
+{
+    const char *out_file_name = "rendertest.out";
+    int fd = open(out_file_name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    size_t capacity = 64 * 1024;
+    char *buf = malloc(capacity);
+    screen_t drawn, expected;
+
+    // A maze with some walls, and avatars on it, two of them on one cell
+    map_t *map = map_new(WIDTH, HEIGHT);
+    map_setWallXY(map, 0, 1, 1, 1);
+    map_setWallXY(map, 5, 5, 5, 6);
+    map_setWallXY(map, WIDTH - 1, HEIGHT - 1, WIDTH - 1, HEIGHT - 2);
+    avatar_t **av_array = avatar_array_new(NUM_AV);
+    for (int i = 0; i < NUM_AV; i++) {
+        avatar_array_add(av_array, avatar_new(i));
+    }
+    place(av_array, 0, 5, 1);
+    place(av_array, 1, 4, 1);
+    place(av_array, 2, 3, 4);
+    place(av_array, 3, 3, 4);
+
+    // Test that a whole frame shows what print_map prints
+    renderer_t *rd = renderer_new(fd, WIDTH, HEIGHT, true);
+    renderer_draw(rd, map, av_array, NUM_AV);
+    size_t size = take_output(fd, buf, capacity);
+    screen_clear(&drawn);
+    bool played = strncmp(buf, "\033[H\033[2J", 7) == 0 && screen_play(&drawn, buf, size);
+
+    fflush(stdout);
+    int saved_stdout = dup(STDOUT_FILENO);
+    dup2(fd, STDOUT_FILENO);
+    print_map(HEIGHT, WIDTH, av_array, NUM_AV, map);
+    fflush(stdout);
+    dup2(saved_stdout, STDOUT_FILENO);
+    close(saved_stdout);
+    size = take_output(fd, buf, capacity);
+    screen_clear(&expected);
+    played = played && screen_play(&expected, buf, size);
+
+    if (played && memcmp(drawn.cells, expected.cells, sizeof(drawn.cells)) == 0) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that a frame in which nothing changed writes nothing
+    renderer_draw(rd, map, av_array, NUM_AV);
+    if (take_output(fd, buf, capacity) == 0) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that frames of the changes, played over the screen, show what whole frames do, in fewer
+    // bytes, as the avatars wander and walls are found
+    renderer_t *whole = renderer_new(fd, WIDTH, HEIGHT, false);
+    srand(50);
+    bool same = true;
+    size_t changes_bytes = 0, whole_bytes = 0;
+    for (int frame = 0; frame < FRAMES && same; frame++) {
+        wander(map, av_array, frame);
+
+        renderer_draw(rd, map, av_array, NUM_AV);
+        size = take_output(fd, buf, capacity);
+        changes_bytes += size;
+        same = screen_play(&drawn, buf, size);
+
+        renderer_draw(whole, map, av_array, NUM_AV);
+        size = take_output(fd, buf, capacity);
+        whole_bytes += size;
+        screen_clear(&expected);
+        same = same && screen_play(&expected, buf, size)
+            && memcmp(drawn.cells, expected.cells, sizeof(drawn.cells)) == 0;
+    }
+    if (same && changes_bytes * 4 < whole_bytes) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that a renderer invalidated draws the next frame whole, though nothing changed
+    renderer_invalidate(rd);
+    renderer_draw(rd, map, av_array, NUM_AV);
+    size = take_output(fd, buf, capacity);
+    screen_clear(&drawn);
+    if (strncmp(buf, "\033[H\033[2J", 7) == 0 && screen_play(&drawn, buf, size)
+        && memcmp(drawn.cells, expected.cells, sizeof(drawn.cells)) == 0) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that the maze printed for a file is the whole frame, without the escapes
+    renderer_print(rd, map, av_array, NUM_AV);
+    size = take_output(fd, buf, capacity);
+    screen_clear(&drawn);
+    if (memchr(buf, '\033', size) == NULL && screen_play(&drawn, buf, size)
+        && memcmp(drawn.cells, expected.cells, sizeof(drawn.cells)) == 0) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that a view scrolled to part of the maze shows that part of the whole frame, with the walls on its
+    // edges and labelled with the cells' coordinates, and nothing else; and that it scrolls no further than the maze
+    renderer_t *view = renderer_new(fd, WIDTH, HEIGHT, false);
+    renderer_set_view(view, 5, 4, RENDER_FOLLOW_NONE);
+    renderer_scroll(view, 3, 2);
+    renderer_draw(view, map, av_array, NUM_AV);
+    size = take_output(fd, buf, capacity);
+    screen_clear(&drawn);
+    bool part = screen_play(&drawn, buf, size);
+    for (int row = 0; row < SCREEN_ROWS && part; row++) {
+        for (int col = 0; col < SCREEN_COLS && part; col++) {
+            if (row > 2 * 4 + 1 || col > 4 * 5 + 3 || (row == 0 && col > 4 * 5 + 2)) {
+                part = drawn.cells[row][col] == ' ';
+            } else {
+                part = drawn.cells[row][col] == expected.cells[(row == 0) ? 0 : row + 2 * 2][(col < 3) ? col : col + 4 * 3];
+            }
+        }
+    }
+    renderer_scroll(view, 100, 100);
+    renderer_draw(view, map, av_array, NUM_AV);
+    size = take_output(fd, buf, capacity);
+    screen_clear(&drawn);
+    int first_x = -1, first_y = -1;
+    if (part && screen_play(&drawn, buf, size) && sscanf(drawn.cells[0], "%d", &first_x) == 1
+        && sscanf(drawn.cells[2], "%d", &first_y) == 1 && first_x == WIDTH - 5 && first_y == HEIGHT - 4) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that frames of the changes to a view following an avatar, and to an overview, played over the
+    // screen, show what whole frames do, and that the avatar followed is always in view
+    renderer_t *follow_changes = renderer_new(fd, WIDTH, HEIGHT, true);
+    renderer_t *follow_whole = renderer_new(fd, WIDTH, HEIGHT, false);
+    renderer_t *overview_changes = renderer_new(fd, WIDTH, HEIGHT, true);
+    renderer_t *overview_whole = renderer_new(fd, WIDTH, HEIGHT, false);
+    renderer_set_view(follow_changes, 4, 3, 0);
+    renderer_set_view(follow_whole, 4, 3, 0);
+    renderer_set_overview(overview_changes, 2);
+    renderer_set_overview(overview_whole, 2);
+    screen_t overview_drawn, overview_expected;
+    screen_clear(&drawn);
+    screen_clear(&overview_drawn);
+    same = true;
+    for (int frame = 0; frame < FRAMES && same; frame++) {
+        wander(map, av_array, frame);
+
+        renderer_draw(follow_changes, map, av_array, NUM_AV);
+        size = take_output(fd, buf, capacity);
+        same = screen_play(&drawn, buf, size);
+        renderer_draw(follow_whole, map, av_array, NUM_AV);
+        size = take_output(fd, buf, capacity);
+        screen_clear(&expected);
+        same = same && screen_play(&expected, buf, size)
+            && memcmp(drawn.cells, expected.cells, sizeof(drawn.cells)) == 0 && shows(&drawn, 2, '0');
+
+        renderer_draw(overview_changes, map, av_array, NUM_AV);
+        size = take_output(fd, buf, capacity);
+        same = same && screen_play(&overview_drawn, buf, size);
+        renderer_draw(overview_whole, map, av_array, NUM_AV);
+        size = take_output(fd, buf, capacity);
+        screen_clear(&overview_expected);
+        same = same && screen_play(&overview_expected, buf, size)
+            && memcmp(overview_drawn.cells, overview_expected.cells, sizeof(overview_drawn.cells)) == 0;
+    }
+    if (same) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that each character of an overview shows the lowest numbered avatar in its block, the meeting point,
+    // or how much of the edges of the block's cells are known: all of them, half or more, some, or none
+    map_t *known = map_new(WIDTH, HEIGHT);
+    map_setTargetXY(known, WIDTH - 1, 0);
+    for (int y = 0; y < 3; y++) {
+        for (int x = 0; x < 3; x++) {
+            map_setOpenXY(known, x, y, x + 1, y);
+            map_setOpenXY(known, x, y, x, y + 1);
+        }
+    }
+    map_setWallXY(known, 4, 4, 5, 4);
+    for (int y = 6; y < 9; y++) {
+        for (int x = 9; x < 12; x++) {
+            if (x < 11) {
+                map_setWallXY(known, x, y, x + 1, y);
+            }
+            if (y < 8) {
+                map_setOpenXY(known, x, y, x, y + 1);
+            }
+        }
+    }
+    place(av_array, 0, 8, 8);
+    place(av_array, 1, 7, 4);
+    place(av_array, 2, 7, 5);
+    place(av_array, 3, 6, 3);
+    renderer_t *overview = renderer_new(fd, WIDTH, HEIGHT, false);
+    renderer_set_overview(overview, 3);
+    renderer_draw(overview, known, av_array, NUM_AV);
+    size = take_output(fd, buf, capacity);
+    screen_clear(&drawn);
+    if (screen_play(&drawn, buf, size) && strncmp(drawn.cells[0], "Overview, 3 x 3 cells a character, from cell (0, 0)", 51) == 0
+        && strncmp(drawn.cells[1], "+----+ ", 7) == 0 && strncmp(drawn.cells[2], "|#. @| ", 7) == 0
+        && strncmp(drawn.cells[3], "|..1 | ", 7) == 0 && strncmp(drawn.cells[4], "|  0:| ", 7) == 0
+        && strncmp(drawn.cells[5], "+----+ ", 7) == 0 && !shows(&drawn, 6, '+')) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Clean up
+    renderer_delete(overview);
+    renderer_delete(overview_whole);
+    renderer_delete(overview_changes);
+    renderer_delete(follow_whole);
+    renderer_delete(follow_changes);
+    renderer_delete(view);
+    map_delete(known);
+    renderer_delete(rd);
+    renderer_delete(whole);
+    avatar_array_delete(av_array, NUM_AV);
+    map_delete(map);
+    free(buf);
+    close(fd);
+    remove(out_file_name);
+
+    return 0;
+}
@@ -0,0 +1,127 @@
+/* ========================================================================== */
+/* File: rendezvoustest.c
+ * *** Category: Testing Only ***
+ * *** Not part of compilation path for user-facing executable
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Maria Roodnitsky, Andrw Yang, Siddharth Agrawal, Alexander Hirsch,
+ * Component name:  rendezvoustest.c
+ *
+ * Date Created:    March 11th, 2020
+ *
+ * This file is a test driver for the rendezvous module.
+ *
+ * Compilation:     mygcc rendezvoustest.c ../libs/rendezvous.c ../libs/map.c ../libs/AMlib_avatar.c -o rendezvoustest
+ * Usage:           ./rendezvoustest
+ *
+ */
+/* ========================================================================== */
+
+// Include C Standard libraries
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+// Include project-specific libraries
+#include "../libs/map.h"
+#include "../libs/AMlib_avatar.h"
+#include "../libs/rendezvous.h"
+
+// Places avatar av at (x, y)
+static void place(avatar_t *av, int x, int y)
+{
+    position_setX(avatar_getPosition(av), x);
+    position_setY(avatar_getPosition(av), y);
+}
+
+// Runs unit testing for the rendezvous module
+int main(const int argc, const char *argv[])
+{
+    // Two avatars at the ends of a 9 x 1 corridor, with the meeting point starting at the east end
+    map_t *corridor = map_new(9, 1);
+    map_setTargetXY(corridor, 8, 0);
+    rendezvous_t *rv = rendezvous_new(9, 1);
+    avatar_t **avatars = avatar_array_new(2);
+    avatar_t *west = avatar_new(0);
+    avatar_t *east = avatar_new(1);
+    avatar_array_add(avatars, west);
+    avatar_array_add(avatars, east);
+    place(west, 0, 0);
+    place(east, 8, 0);
+
+    // Test that the meeting point moves to the middle of the avatars
+    if (rendezvous_update(rv, corridor, avatars, 2) && map_getTargetX(corridor) == 4 && map_distanceXY(corridor, 0, 0) == 4) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test hysteresis: a saving of one move for the farthest avatar does not move the meeting point, but two do
+    place(west, 2, 0);
+    if (!rendezvous_update(rv, corridor, avatars, 2) && map_getTargetX(corridor) == 4) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+    place(west, 4, 0);
+    if (rendezvous_update(rv, corridor, avatars, 2) && map_getTargetX(corridor) == 6 && rendezvous_getElections(rv) == 2) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that a wall cutting an avatar off from the meeting point forces a new one, whatever the margin
+    map_setTargetXY(corridor, 8, 0);
+    place(west, 6, 0);
+    place(east, 7, 0);
+    map_setWallXY(corridor, 7, 0, 8, 0);
+    if (rendezvous_update(rv, corridor, avatars, 2) && map_getTargetX(corridor) >= 6 && map_getTargetX(corridor) <= 7) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that an update with no avatar moved, no wall changed and the target where it was polls nothing
+    int polls = rendezvous_getPolls(rv);
+    if (!rendezvous_update(rv, corridor, avatars, 2) && rendezvous_getPolls(rv) == polls) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Two avatars on a 100 x 100 maze search 20000 cells a poll, more than the budget of a turn: test that after a
+    // move the next poll waits a turn, that a wall learned then waits for it too, and that a copy knows what its
+    // source polled for
+    map_t *field = map_new(100, 100);
+    map_setTargetXY(field, 99, 0);
+    rendezvous_t *large = rendezvous_new(100, 100);
+    rendezvous_t *copied = rendezvous_new(100, 100);
+    place(west, 0, 50);
+    place(east, 98, 50);
+    bool first = rendezvous_update(large, field, avatars, 2) && map_getTargetX(field) == 49;
+    place(west, 1, 50);
+    bool waited = !rendezvous_update(large, field, avatars, 2) && rendezvous_getPolls(large) == 1;
+    bool polled = !rendezvous_update(large, field, avatars, 2) && rendezvous_getPolls(large) == 2;
+    map_setWallXY(field, 49, 50, 49, 49);
+    bool walled = !rendezvous_update(large, field, avatars, 2) && rendezvous_getPolls(large) == 2;
+    bool repolled = !rendezvous_update(large, field, avatars, 2) && rendezvous_getPolls(large) == 3;
+    rendezvous_copy(copied, large);
+    bool carried = !rendezvous_update(copied, field, avatars, 2) && rendezvous_getPolls(copied) == 3
+        && rendezvous_getElections(copied) == rendezvous_getElections(large);
+    if (first && waited && polled && walled && repolled && carried) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Clean up
+    avatar_array_delete(avatars, 2);
+    rendezvous_delete(rv);
+    rendezvous_delete(large);
+    rendezvous_delete(copied);
+    map_delete(corridor);
+    map_delete(field);
+
+    return 0;
+}
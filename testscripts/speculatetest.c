@@ -0,0 +1,145 @@
+/* ========================================================================== */
+/* File: speculatetest.c
+ * *** Category: Testing Only ***
+ * *** Not part of compilation path for user-facing executable
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Maria Roodnitsky, Andrw Yang, Siddharth Agrawal, Alexander Hirsch,
+ * Component name:  speculatetest.c
+ *
+ * Date Created:    March 12th, 2020
+ *
+ * This file is a test driver for the speculate module, and the map and convoy copies it relies on.
+ *
+ * Compilation:     mygcc speculatetest.c ../libs/speculate.c ../libs/rendezvous.c ../libs/convoy.c ../libs/map.c ../libs/AMlib_avatar.c -o speculatetest
+ * Usage:           ./speculatetest
+ *
+ */
+/* ========================================================================== */
+
+// Include C Standard libraries
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+// Include project-specific libraries
+#include "../libs/amazing.h"
+#include "../libs/map.h"
+#include "../libs/AMlib_avatar.h"
+#include "../libs/convoy.h"
+#include "../libs/rendezvous.h"
+#include "../libs/speculate.h"
+
+// Places avatar av at (x, y)
+static void place(avatar_t *av, int x, int y)
+{
+    position_setX(avatar_getPosition(av), x);
+    position_setY(avatar_getPosition(av), y);
+}
+
+// Runs unit testing for the speculate module
+int main(const int argc, const char *argv[])
+{
+    // A 4 x 1 corridor with the meeting point at its east end, and two avatars at its west end
+    map_t *shared = map_new(4, 1);
+    map_setInference(shared, true);
+    map_setTargetXY(shared, 3, 0);
+    map_setOpenXY(shared, 0, 0, 1, 0);
+    convoy_t *convoy = convoy_new(2, 4, 1);
+    rendezvous_t *rendezvous = rendezvous_new(4, 1);
+    avatar_t **avatars = avatar_array_new(2);
+    for (int i = 0; i < 2; i++) {
+        avatar_array_add(avatars, avatar_new(i));
+        place(avatars[i], 0, 0);
+    }
+    occupancy_t *occupancy = occupancy_new(4, 1, 2);
+    occupancy_sync(occupancy, avatars);
+    convoy_update(convoy, avatars, 2);
+
+    // Test that a map copy carries the edges, the target and the distance field, and only between maps of one size
+    map_t *copy = map_new(4, 1);
+    map_t *other = map_new(3, 1);
+    if (map_copy(copy, shared) && map_isOpenXY(copy, 0, 0, 1, 0) && map_isUnknownXY(copy, 1, 0, 2, 0) &&
+        map_getTargetX(copy) == 3 && map_distanceXY(copy, 0, 0) == 3 && map_isConnectedXY(copy, 0, 0, 1, 0) &&
+        !map_copy(other, shared)) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that an edge copy carries the edges and the target but not inference, which a full copy of it drops too
+    map_t *edges = map_new(4, 1);
+    if (map_copyEdges(edges, shared) && map_isOpenXY(edges, 0, 0, 1, 0) && map_getTargetX(edges) == 3 &&
+        !map_isConnectedXY(shared, 0, 0, 3, 0) && map_isConnectedXY(edges, 0, 0, 3, 0) &&
+        map_copy(copy, edges) && map_isConnectedXY(copy, 0, 0, 3, 0) && !map_copyEdges(other, shared)) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Speculate on avatar 0's move east from (1, 0) for avatar 1: on the copy for that move succeeding, record the
+    // open edge, move avatar 0, and elect the meeting point
+    place(avatars[0], 1, 0);
+    occupancy_move(occupancy, 0, 1, 0);
+    speculation_t *sp = speculation_new(2, 4, 1);
+    speculate_key_t key = {1, 0, 1, 0, 2, 0};
+    speculation_begin(sp, key);
+    speculation_load(sp, SPECULATE_MOVED, shared, avatars, convoy, rendezvous);
+    map_setOpenXY(speculation_getMap(sp, SPECULATE_MOVED), 1, 0, 2, 0);
+    place(speculation_getAvatars(sp, SPECULATE_MOVED)[0], 2, 0);
+    occupancy_move(speculation_getOccupancy(sp, SPECULATE_MOVED), 0, 2, 0);
+    rendezvous_update(speculation_getRendezvous(sp, SPECULATE_MOVED), speculation_getMap(sp, SPECULATE_MOVED),
+        speculation_getAvatars(sp, SPECULATE_MOVED), 2);
+    speculation_setMove(sp, SPECULATE_MOVED, M_EAST, 2);
+
+    // Test that a turn with another move in flight, or another outcome, takes nothing and changes nothing
+    uint32_t move = M_NULL_MOVE;
+    int move_code = -1;
+    speculate_key_t wrong = {1, 0, 1, 0, 1, 1};
+    if (!speculation_take(sp, wrong, SPECULATE_MOVED, shared, avatars, occupancy, convoy, rendezvous, &move, &move_code) &&
+        !speculation_take(sp, key, SPECULATE_BLOCKED, shared, avatars, occupancy, convoy, rendezvous, &move, &move_code) &&
+        move == M_NULL_MOVE && move_code == -1 && map_isUnknownXY(shared, 1, 0, 2, 0) && avatar_getX(avatars[0]) == 1 &&
+        occupancy_find_avatar(occupancy, 1, 0) == 0) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that the turn the speculation was made for takes its move, map and positions, moving the avatar in the
+    // occupancy too, and what its rendezvous knows of the election made on the copy, and only once
+    if (speculation_take(sp, key, SPECULATE_MOVED, shared, avatars, occupancy, convoy, rendezvous, &move, &move_code) &&
+        move == M_EAST && move_code == 2 && map_isOpenXY(shared, 1, 0, 2, 0) && avatar_getX(avatars[0]) == 2 &&
+        map_distanceXY(shared, 2, 0) == 1 && !speculation_take(sp, key, SPECULATE_MOVED, shared, avatars, occupancy, convoy, rendezvous, &move, &move_code) &&
+        occupancy_find_avatar(occupancy, 2, 0) == 0 && occupancy_count(occupancy, 1, 0) == 0 &&
+        speculation_getTaken(sp) == 1 && speculation_getBegun(sp) == 1 && rendezvous_getPolls(rendezvous) == 1 &&
+        !rendezvous_update(rendezvous, shared, avatars, 2) && rendezvous_getPolls(rendezvous) == 1) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that a convoy copy carries the groups and leaders
+    convoy_t *convoy_copied = convoy_new(2, 4, 1);
+    convoy_copy(convoy_copied, convoy);
+    if (convoy_getGroup(convoy_copied, 1) == 0 && convoy_getGroupSize(convoy_copied, 0) == 2 &&
+        convoy_getLeader(convoy_copied, 1) == convoy_getLeader(convoy, 1)) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Clean up
+    speculation_delete(sp);
+    convoy_delete(convoy_copied);
+    convoy_delete(convoy);
+    rendezvous_delete(rendezvous);
+    avatar_array_delete(avatars, 2);
+    occupancy_delete(occupancy);
+    map_delete(other);
+    map_delete(edges);
+    map_delete(copy);
+    map_delete(shared);
+
+    return 0;
+}
@@ -7,7 +7,7 @@ do
     do 
         echo "---------------------------------------------------------"
         echo "${AVATAR} avatars at ${DIFF} difficulty "
-        ../AMStartup.app ${AVATAR} ${DIFF} flume.cs.dartmouth.edu | tail -100 
+        ../AMStartup.app "$@" ${AVATAR} ${DIFF} flume.cs.dartmouth.edu | tail -100 
         echo "Output logs to designated location" 
         echo ""
     done 
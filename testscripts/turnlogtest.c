@@ -0,0 +1,214 @@
+/* ========================================================================== */
+/* File: turnlogtest.c
+ * *** Category: Testing Only ***
+ * *** Not part of compilation path for user-facing executable
+ *
+ * Project name:    CS50 Amazing Project
+ * Team name:       PiedPiper
+ * Authors:         Maria Roodnitsky, Andrw Yang, Siddharth Agrawal, Alexander Hirsch,
+ * Component name:  turnlogtest.c
+ *
+ * Date Created:    March 14th, 2020
+ *
+ * This file is a test driver for the turnlog module.
+ *
+ * Compilation:     mygcc turnlogtest.c ../libs/turnlog.c -o turnlogtest
+ * Usage:           ./turnlogtest
+ *
+ */
+/* ========================================================================== */
+
+// Include C Standard libraries
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Include project-specific libraries
+#include "../libs/amazing.h"
+#include "../libs/turnlog.h"
+
+#define NUM_RECORDS 5
+
+// Fills records with a game of three avatars: two turns, an error, another turn and the solved message
+static void make_records(turn_record_t records[NUM_RECORDS])
+{
+    memset(records, 0, NUM_RECORDS * sizeof(turn_record_t));
+    for (int i = 0; i < NUM_RECORDS; i++) {
+        records[i].num_avatars = 3;
+    }
+    records[0].kind = RECORD_TURN;
+    records[0].positions[1].x = 7;
+    records[0].positions[2].y = 300;
+    records[0].outcome = RECORD_OUTCOME_NONE;
+    records[0].move = M_SOUTH;
+
+    records[1] = records[0];
+    records[1].avatar_id = 1;
+    records[1].iteration = 1;
+    records[1].positions[0].y = 1;
+    records[1].outcome = RECORD_OUTCOME_WALL;
+    records[1].move = M_WEST;
+
+    records[2].kind = RECORD_ERROR;
+    records[2].avatar_id = 2;
+    records[2].message_type = AM_SERVER_TIMEOUT;
+
+    records[3] = records[1];
+    records[3].avatar_id = 2;
+    records[3].iteration = 70000;
+    records[3].outcome = RECORD_OUTCOME_STAY;
+    records[3].move = M_NULL_MOVE;
+
+    records[4].kind = RECORD_SOLVED;
+    records[4].solved_avatars = 3;
+    records[4].solved_difficulty = 4;
+    records[4].solved_moves = 70001;
+    records[4].solved_hash = 0x7abcdef0;
+}
+
+// Writes header and records to a new temporary file, in format. Returns the file, rewound
+static FILE *write_log(log_format_t format, const turnlog_header_t *header, const turn_record_t records[NUM_RECORDS])
+{
+    FILE *fp = tmpfile();
+    turnlog_write_header(fp, format, header);
+    for (int i = 0; i < NUM_RECORDS; i++) {
+        turnlog_write_record(fp, format, header->num_avatars, &records[i]);
+    }
+    rewind(fp);
+    return fp;
+}
+
+// Reads all of fp into buf, of size size, as a string. Returns the number of bytes read
+static size_t read_all(FILE *fp, char *buf, size_t size)
+{
+    size_t n = fread(buf, 1, size - 1, fp);
+    buf[n] = '\0';
+    return n;
+}
+
+// Runs unit testing for the turnlog module
+int main(const int argc, const char *argv[])
+{
+    turnlog_header_t header;
+    header.username = "dru";
+    header.mazePort = 20173;
+    header.mazeWidth = 40;
+    header.mazeHeight = 301;
+    header.num_avatars = 3;
+    header.difficulty = 4;
+    header.start_time = 1584200000;
+    turn_record_t records[NUM_RECORDS];
+    make_records(records);
+
+    // The text log, written directly
+    FILE *text = write_log(LOG_FORMAT_TEXT, &header, records);
+    char expected[8192];
+    read_all(text, expected, sizeof(expected));
+    fclose(text);
+
+    // Test that the binary header reads back as it was written
+    FILE *binary = write_log(LOG_FORMAT_BINARY, &header, records);
+    turnlog_header_t read_header;
+    char username[64];
+    if (turnlog_read_header(binary, &read_header, username, sizeof(username))
+        && strcmp(read_header.username, "dru") == 0 && read_header.mazePort == 20173
+        && read_header.mazeWidth == 40 && read_header.mazeHeight == 301 && read_header.num_avatars == 3
+        && read_header.difficulty == 4 && read_header.start_time == 1584200000) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that the binary records, turned into text, make the text log byte for byte
+    FILE *converted = tmpfile();
+    turnlog_write_header(converted, LOG_FORMAT_TEXT, &read_header);
+    turn_record_t record;
+    bool truncated;
+    int count = 0;
+    while (turnlog_read_record(binary, LOG_FORMAT_BINARY, read_header.num_avatars, &record, &truncated)) {
+        turnlog_write_record(converted, LOG_FORMAT_TEXT, read_header.num_avatars, &record);
+        count++;
+    }
+    rewind(converted);
+    char actual[8192];
+    read_all(converted, actual, sizeof(actual));
+    fclose(converted);
+    if (count == NUM_RECORDS && !truncated && strcmp(actual, expected) == 0) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that a turn takes 8 bytes and 4 per avatar
+    long size = ftell(binary);
+    long turn_size = 8 + 4 * 3;
+    long expected_size = 32 + 3 + 3 * turn_size + 8 + 20;
+    if (size == expected_size) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome: the binary log is %ld bytes, not %ld\n", size, expected_size);
+    }
+
+    // Test that a log cut short in the middle of a record is reported as truncated
+    rewind(binary);
+    char whole[1024];
+    size_t length = fread(whole, 1, sizeof(whole), binary);
+    fclose(binary);
+    FILE *cut = tmpfile();
+    fwrite(whole, 1, length - 5, cut);
+    rewind(cut);
+    turnlog_read_header(cut, &read_header, username, sizeof(username));
+    count = 0;
+    while (turnlog_read_record(cut, LOG_FORMAT_BINARY, read_header.num_avatars, &record, &truncated)) {
+        count++;
+    }
+    fclose(cut);
+    if (count == NUM_RECORDS - 1 && truncated) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that the text log reads back as the records it was written from, skipping its header
+    text = tmpfile();
+    fputs(expected, text);
+    rewind(text);
+    char header_line[256];
+    fgets(header_line, sizeof(header_line), text);
+    count = 0;
+    bool same = true;
+    while (turnlog_read_record(text, LOG_FORMAT_TEXT, header.num_avatars, &record, &truncated)) {
+        const turn_record_t *written = &records[count];
+        same = same && record.kind == written->kind && record.avatar_id == written->avatar_id;
+        if (written->kind == RECORD_TURN) {
+            same = same && record.iteration == written->iteration && record.outcome == written->outcome
+                && record.move == written->move
+                && memcmp(record.positions, written->positions, 3 * sizeof(XYPos)) == 0;
+        } else if (written->kind == RECORD_ERROR) {
+            same = same && record.message_type == written->message_type;
+        } else {
+            same = same && record.solved_moves == written->solved_moves && record.solved_hash == written->solved_hash;
+        }
+        count++;
+    }
+    fclose(text);
+    if (count == NUM_RECORDS && !truncated && same) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+
+    // Test that a file which is not a binary log is refused
+    FILE *not_binary = tmpfile();
+    fputs(expected, not_binary);
+    rewind(not_binary);
+    if (!turnlog_read_header(not_binary, &read_header, username, sizeof(username))) {
+        printf("Correct outcome\n");
+    } else {
+        printf("Incorrect outcome\n");
+    }
+    fclose(not_binary);
+
+    return 0;
+}